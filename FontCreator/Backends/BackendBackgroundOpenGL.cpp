@@ -13,8 +13,8 @@ BackendBackgroundOpenGL::BackendBackgroundOpenGL(const BackgroundSettings& bs, c
 		bs.shadow.has_value() ?
 			std::dynamic_pointer_cast<IShaderManager>(std::make_shared<BackgroundShadowShaderManager>(*bs.shadow)) : (
 			bs.color.has_value() ? 
-				std::dynamic_pointer_cast<IShaderManager>(std::make_shared<SingleColorBackgroundShaderManager>()) :
-				std::dynamic_pointer_cast<IShaderManager>(std::make_shared<BackgroundShaderManager>())
+				std::dynamic_pointer_cast<IShaderManager>(std::make_shared<SingleColorBackgroundShaderManager>(bs.sdfShape)) :
+				std::dynamic_pointer_cast<IShaderManager>(std::make_shared<BackgroundShaderManager>(bs.sdfShape))
 			)
 	)
 {
@@ -115,9 +115,12 @@ void BackendBackgroundOpenGL::Render(std::function<void(GLuint)> preDrawCallback
 #endif		
 	
 	this->sm->BindUniforms();
+	this->sm->BindViewTransform(this->viewTransform);
 	this->sm->PreRender();
 	this->sm->Render(this->quadsCount);
 
+	this->OnStreamBufferUsed();
+
 #ifdef __ANDROID_API__
 	if (rs.glVersion != 2)
 	{
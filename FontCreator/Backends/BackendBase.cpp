@@ -1,16 +1,23 @@
 #include "./BackendBase.h"
 
+#include <limits>
+
 
 BackendBase::BackendBase(const RenderSettings& r) : 
 	quadsCount(0),
+	rewriting(false),
+	dirtyStart(std::numeric_limits<size_t>::max()),
+	dirtyEnd(0),
 	mainRenderer(nullptr),
 	rs(r),
 	enabled(true),
 	heightPx(std::numeric_limits<float>::lowest()),
-	heightThresholdKeepBackground(false)
+	heightThresholdKeepBackground(false),
+	viewX(0.0f),
+	viewY(0.0f),
+	viewZoom(1.0f)
 {
-	this->psW = 1.0f / static_cast<float>(rs.deviceW); //pixel size in width
-	this->psH = 1.0f / static_cast<float>(rs.deviceH); //pixel size in height	
+	this->UpdatePixelSize();
 }
 
 BackendBase::~BackendBase()
@@ -22,6 +29,100 @@ void BackendBase::Clear()
 {
 	this->geom.clear();
 	this->quadsCount = 0;
+
+	this->dirtyStart = std::numeric_limits<size_t>::max();
+	this->dirtyEnd = 0;
+}
+
+/// <summary>
+/// Get current size of geometry buffer
+/// (can be used as start / end of quads range for RewriteGeometry)
+/// </summary>
+/// <returns></returns>
+size_t BackendBase::GetGeometrySize() const
+{
+	return this->geom.size();
+}
+
+/// <summary>
+/// Replace part of existing geometry [start, end)
+/// with quads added inside addQuads callback
+/// New quads must have exactly the same size as the replaced range,
+/// otherwise nothing is changed and false is returned
+/// Rewritten range is marked as dirty and uploaded during next render
+/// Background is not updated
+/// </summary>
+/// <param name="start"></param>
+/// <param name="end"></param>
+/// <param name="addQuads"></param>
+/// <returns></returns>
+bool BackendBase::RewriteGeometry(size_t start, size_t end, const std::function<void()>& addQuads)
+{
+	if ((start > end) || (end > this->geom.size()))
+	{
+		return false;
+	}
+
+	const int quads = this->quadsCount;
+
+	std::swap(this->geom, this->rewriteGeom);
+	this->geom.clear();
+
+	this->rewriting = true;
+	addQuads();
+	this->rewriting = false;
+
+	std::swap(this->geom, this->rewriteGeom);
+	this->quadsCount = quads;
+
+	if (this->rewriteGeom.size() != end - start)
+	{
+		return false;
+	}
+
+	std::copy(this->rewriteGeom.begin(), this->rewriteGeom.end(), this->geom.begin() + start);
+
+	this->dirtyStart = std::min(this->dirtyStart, start);
+	this->dirtyEnd = std::max(this->dirtyEnd, end);
+
+	return true;
+}
+
+/// <summary>
+/// Test if backend can store layers in own buffers (see BeginLayer)
+/// If not, all layers are in main geometry and they are 
+/// generated together
+/// </summary>
+/// <returns></returns>
+bool BackendBase::IsLayerSupported() const
+{
+	return false;
+}
+
+/// <summary>
+/// Quads added until EndLayer are stored in geometry of layer
+/// instead of main geometry
+/// Previous geometry of layer is replaced
+/// Layers are rendered after main geometry, sorted by id
+/// </summary>
+/// <param name="layer"></param>
+/// <param name="isStatic">layer changes rarely</param>
+void BackendBase::BeginLayer(uint8_t /*layer*/, bool /*isStatic*/)
+{
+}
+
+/// <summary>
+/// Finish layer started with BeginLayer and upload its geometry
+/// </summary>
+void BackendBase::EndLayer()
+{
+}
+
+/// <summary>
+/// Remove geometry of all layers
+/// </summary>
+void BackendBase::ClearLayers()
+{
 }
 
 void BackendBase::SetBackground(std::optional<BackgroundSettings> bs)
@@ -55,13 +156,48 @@ void BackendBase::SetRenderSizeThreshold(float heightPx, bool keepBackground)
 	this->heightThresholdKeepBackground = keepBackground;
 }
 
+/// <summary>
+/// Enable / disable per-pass timing of frames
+/// Stats are removed when profiling is disabled
+/// </summary>
+/// <param name="val"></param>
+void BackendBase::SetProfilingEnabled(bool val)
+{
+	if (val == false)
+	{
+		this->profiler = nullptr;
+	}
+	else if (this->profiler == nullptr)
+	{
+		this->profiler = this->CreateProfiler();
+	}
+}
+
+/// <summary>
+/// Get profiler with stats of last frames
+/// </summary>
+/// <returns>nullptr if profiling is disabled</returns>
+RenderProfiler* BackendBase::GetProfiler() const
+{
+	return this->profiler.get();
+}
+
+/// <summary>
+/// Create profiler for this backend
+/// Default one measures CPU times only
+/// </summary>
+/// <returns></returns>
+std::unique_ptr<RenderProfiler> BackendBase::CreateProfiler() const
+{
+	return std::make_unique<RenderProfiler>();
+}
+
 void BackendBase::SetCanvasSize(int w, int h)
 {
 	this->rs.deviceW = w;
 	this->rs.deviceH = h;
 
-	this->psW = 1.0f / static_cast<float>(rs.deviceW); //pixel size in width
-	this->psH = 1.0f / static_cast<float>(rs.deviceH); //pixel size in height
+	this->UpdatePixelSize();
 
 	this->OnCanvasChanges();
 }
@@ -70,10 +206,48 @@ void BackendBase::SwapCanvasWidthHeight()
 {
 	std::swap(this->rs.deviceW, this->rs.deviceH);
 
+	this->UpdatePixelSize();
+
+	this->OnCanvasChanges();
+}
+
+/// <summary>
+/// Update size of one pixel in geometry units
+/// With view transform, geometry is in pixels and canvas size
+/// is applied in vertex shader
+/// </summary>
+void BackendBase::UpdatePixelSize()
+{
+	if (this->rs.useViewTransform)
+	{
+		this->psW = 1.0f;
+		this->psH = 1.0f;
+		return;
+	}
+
 	this->psW = 1.0f / static_cast<float>(rs.deviceW); //pixel size in width
 	this->psH = 1.0f / static_cast<float>(rs.deviceH); //pixel size in height
+}
 
-	this->OnCanvasChanges();
+/// <summary>
+/// Set view used with view transform (RenderSettings::useViewTransform)
+/// Position on canvas = position * zoom + (x, y)
+/// Geometry is not changed
+/// </summary>
+/// <param name="x">translation in pixels</param>
+/// <param name="y">translation in pixels</param>
+/// <param name="zoom"></param>
+void BackendBase::SetView(float x, float y, float zoom)
+{
+	this->viewX = x;
+	this->viewY = y;
+	this->viewZoom = zoom;
+
+	this->OnViewChanges();
+}
+
+void BackendBase::OnViewChanges()
+{
 }
 
 void BackendBase::AddEmptyQuad(float x, float y, float w, float h, const AbstractRenderer::RenderParams& rp)
@@ -117,6 +291,28 @@ void BackendBase::AddQuad(const GlyphInfo& gi, float x, float y, const AbstractR
 	this->AddQuad(min, max, rp);
 }
 
+/// <summary>
+/// Add one instance of instanced shader (see InstancedNumberShaderManager)
+/// Data are already in format of shader and are appended to geometry as they are,
+/// instance is counted as one quad
+/// </summary>
+/// <param name="data"></param>
+/// <param name="count">number of floats</param>
+void BackendBase::AddInstance(const float* data, size_t count)
+{
+	this->geom.insert(this->geom.end(), data, data + count);
+	this->quadsCount++;
+}
+
 void BackendBase::OnFinishQuadGroup(const AbstractRenderer::RenderParams& rp)
 {
 }
+
+/// <summary>
+/// Called when string with render params is added
+/// Backend can start loading of resources used by params
+/// </summary>
+/// <param name="rp"></param>
+void BackendBase::PrefetchResources(const AbstractRenderer::RenderParams& /*rp*/)
+{
+}
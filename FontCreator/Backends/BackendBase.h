@@ -12,6 +12,8 @@
 
 #include "../Renderers/AbstractRenderer.h"
 
+#include "./RenderProfiler.h"
+
 
 class BackendBase
 {
@@ -32,13 +34,27 @@ public:
 		
 	void SetRenderSizeThreshold(float heightPx, bool keepBackground = false);
 
+	void SetProfilingEnabled(bool val);
+	void SetView(float x, float y, float zoom);
+	RenderProfiler* GetProfiler() const;
+
 	virtual void Clear();	
 	virtual void AddQuad(const GlyphInfo& gi, float x, float y, const AbstractRenderer::RenderParams& rp);
+	void AddInstance(const float* data, size_t count);
 	virtual void OnFinishQuadGroup(const AbstractRenderer::RenderParams& rp);
+	virtual void PrefetchResources(const AbstractRenderer::RenderParams& rp);
 
 	virtual void FillGeometry() = 0;
 	virtual void FillFontTexture() = 0;
 
+	size_t GetGeometrySize() const;
+	bool RewriteGeometry(size_t start, size_t end, const std::function<void()>& addQuads);
+
+	virtual bool IsLayerSupported() const;
+	virtual void BeginLayer(uint8_t layer, bool isStatic);
+	virtual void EndLayer();
+	virtual void ClearLayers();
+
 	virtual void Render() = 0;
   
 	friend class AbstractRenderer;
@@ -49,6 +65,12 @@ protected:
 	int quadsCount;
 	std::vector<float> geom;
 
+	//rewrite of part of geometry (see RewriteGeometry)
+	bool rewriting;
+	std::vector<float> rewriteGeom;
+	size_t dirtyStart;
+	size_t dirtyEnd;
+
 	AbstractRenderer* mainRenderer;
 
 	RenderSettings rs;
@@ -62,6 +84,16 @@ protected:
 	float psW; //1.0 / pixel size in width
 	float psH; //1.0 / pixel size in height
 
+	//view of geometry (see SetView)
+	float viewX;
+	float viewY;
+	float viewZoom;
+
+	//nullptr if profiling is disabled (see SetProfilingEnabled)
+	std::unique_ptr<RenderProfiler> profiler;
+
+	virtual std::unique_ptr<RenderProfiler> CreateProfiler() const;
+
 	virtual void AddEmptyQuad(float x, float y, float w, float h, const AbstractRenderer::RenderParams& rp);
 	virtual void AddQuad(AbstractRenderer::Vertex& vmin, AbstractRenderer::Vertex& vmax, const AbstractRenderer::RenderParams& rp) = 0;
 
@@ -70,6 +102,9 @@ protected:
 	void SetCanvasSize(int w, int h);
 	void SwapCanvasWidthHeight();
 	virtual void OnCanvasChanges() = 0;
+	virtual void OnViewChanges();
+
+	void UpdatePixelSize();
 	
    
 };
@@ -179,6 +179,8 @@ void BackendImage::OnCanvasChanges()
 /// </summary>
 void BackendImage::Render()
 {
+	RenderProfiler::FrameScope frameScope(this->profiler.get());
+
 	bool geomChanged = this->mainRenderer->GenerateGeometry();
 
 	if (this->geom.empty())
@@ -192,6 +194,8 @@ void BackendImage::Render()
 	}
 
 
+	RenderProfiler::PassScope passScope(this->profiler.get(), RenderProfiler::Pass::GLYPHS);
+
 	auto texData = this->mainRenderer->fb->GetTextureData();
 	
 	int nextQuadOffset = (format == Format::GRAYSCALE) ? 8 : 12;
@@ -2,34 +2,116 @@
 
 #include <limits>
 #include <algorithm>
+#include <cstring>
 
 #include "../TextureBuilders/FontBuilder.h"
 
 #include "./Shaders/Shaders.h"
 #include "./Shaders/DefaultFontShaderManager.h"
+#include "./Shaders/GlyphBackgroundShaderManager.h"
+#include "./Shaders/InstancedGlyphShaderManager.h"
 
 #include "./BackendBackgroundOpenGL.h"
+#include "./RenderProfilerOpenGL.h"
 
 //=============================================================================
 // GL helpers
 //=============================================================================
 
+/// <summary>
+/// Test if persistently mapped buffers (glBufferStorage) can be used
+/// Headers can declare glBufferStorage even if current context does not
+/// support it - context must be OpenGL 4.4 or have ARB_buffer_storage
+/// Not available on GLES 3.0 - buffers are orphaned there
+/// </summary>
+/// <returns></returns>
+static bool IsPersistentMappingSupported()
+{
+#if defined(GL_MAP_PERSISTENT_BIT) && defined(GLEW_VERSION)
+	if ((GLEW_VERSION_4_4 == false) && (GLEW_ARB_buffer_storage == false))
+	{
+		return false;
+	}
+	return (glBufferStorage != nullptr);
+#elif defined(GL_MAP_PERSISTENT_BIT)
+	GLint major = 0;
+	GLint minor = 0;
+	GL_CHECK(glGetIntegerv(GL_MAJOR_VERSION, &major));
+	GL_CHECK(glGetIntegerv(GL_MINOR_VERSION, &minor));
+
+	if ((major > 4) || ((major == 4) && (minor >= 4)))
+	{
+		return true;
+	}
 
+	GLint extensionsCount = 0;
+	GL_CHECK(glGetIntegerv(GL_NUM_EXTENSIONS, &extensionsCount));
+
+	for (GLint i = 0; i < extensionsCount; i++)
+	{
+		const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+		if ((ext != nullptr) && (std::strcmp(ext, "GL_ARB_buffer_storage") == 0))
+		{
+			return true;
+		}
+	}
+
+	return false;
+#else
+	return false;
+#endif
+}
 
 //=============================================================================
 
+uint64_t BackendOpenGL::lastTextureStamp = 0;
+int BackendOpenGL::backendsCount = 0;
 
 BackendOpenGL::BackendOpenGL(const RenderSettings& r,
 	const char* vSource, const char* pSource, 
 	std::shared_ptr<IShaderManager> sm) :
 	BackendBase(r),
 	sm(sm),		
+	background(nullptr),
+	mergedSm(std::dynamic_pointer_cast<GlyphBackgroundShaderManager>(sm)),
+	mergedBackground(std::nullopt),
+	mergedGroupStart(0),
 	vbo(0),
 	vao(0),
+	ringIndex(0),
+	persistentMapping(false),
+	activeLayer(std::nullopt),
+	activeLayerStatic(false),
+	mainQuadsCount(0),
 	texture(0),
-	background(nullptr)
+	pixelBufferIndex(0),
+	asyncTextureUpload(false),
+	textureRevision(0),
+	textureStamp(0),
+	batched(false)
 {	
 	this->shader.program = 0;
+
+	this->UpdateViewTransform();
+
+	for (StreamBuffer& b : this->ring)
+	{
+		b.vbo = 0;
+		b.vao = 0;
+		b.data = nullptr;
+		b.capacity = 0;
+		b.fence = 0;
+		b.size = 0;
+		b.dirtyStart = std::numeric_limits<size_t>::max();
+		b.dirtyEnd = 0;
+	}
+
+	for (PixelBuffer& pb : this->pixelBuffers)
+	{
+		pb.pbo = 0;
+		pb.capacity = 0;
+		pb.fence = 0;
+	}
     
     if (vSource)
     {
@@ -53,6 +135,7 @@ BackendOpenGL::BackendOpenGL(const RenderSettings& r,
         this->shader.isDefault &= true;
     }
     
+	backendsCount++;
 		
 	this->InitGL();
 	
@@ -71,10 +154,24 @@ BackendOpenGL::~BackendOpenGL()
 	FONT_UNBIND_ARRAY_BUFFER;
 	FONT_UNBIND_VAO;
 
-	GL_CHECK(glDeleteProgram(shader.program));
-	GL_CHECK(glDeleteTextures(1, &this->texture));
-	GL_CHECK(glDeleteBuffers(1, &this->vbo));
-	GL_CHECK(glDeleteVertexArrays(1, &this->vao));
+	FONT_DELETE_PROGRAM(shader.program);
+	FONT_DELETE_TEXTURE(this->texture);
+
+	for (StreamBuffer& b : this->ring)
+	{
+		this->ReleaseStreamBuffer(b);
+	}
+
+	this->ClearLayers();
+
+	this->ReleasePixelBuffers();
+
+	backendsCount--;
+	if (backendsCount == 0)
+	{
+		IShaderManager::ReleaseSharedBuffers();
+		InstancedGlyphShaderManager::ReleaseUnitQuad();
+	}
 }
 
 /// <summary>
@@ -89,12 +186,34 @@ void BackendOpenGL::InitGL()
     this->sm->GetAttributtesUniforms();
     
 
-	//create VBO
-	GL_CHECK(glGenBuffers(1, &this->vbo));
+	//create VBOs and VAOs
+	//with persistent mapping, all buffers of ring are used,
+	//otherwise only the first one (orphaned on every upload)
+	this->persistentMapping = IsPersistentMappingSupported();
+	this->asyncTextureUpload = this->rs.useAsyncTextureUpload;
 
-	//create VAO
-	this->InitVAO();
-	
+#ifdef __ANDROID_API__
+	if (rs.glVersion == 2)
+	{
+		this->persistentMapping = false;
+
+		//no pixel buffer objects and fences
+		this->asyncTextureUpload = false;
+
+		//32-bit indices are not in core GLES 2
+		this->sm->SetIndexedQuads(false);
+	}
+#endif
+
+	const int count = (this->persistentMapping) ? RING_SIZE : 1;
+	for (int i = 0; i < count; i++)
+	{
+		this->InitStreamBuffer(this->ring[i]);
+	}
+
+	this->ringIndex = 0;
+	this->vbo = this->ring[0].vbo;
+	this->vao = this->ring[0].vao;
 }
 
 void BackendOpenGL::InitTexture(const char* uniformName)
@@ -121,10 +240,15 @@ void BackendOpenGL::InitTexture(const char* uniformName)
 	this->tW = 1.0f / static_cast<float>(w);  //1.0 / pixel size in width
 	this->tH = 1.0f / static_cast<float>(h); //1.0 / pixel size in height
 
+	this->sm->SetTextureSize(w, h);
+
+	//new texture is empty - next fill must upload entire atlas
+	this->textureRevision = 0;
+
 	if (this->texture != 0)
 	{
 		FONT_UNBIND_TEXTURE_2D;
-		GL_CHECK(glDeleteTextures(1, &this->texture));
+		FONT_DELETE_TEXTURE(this->texture);
 	}
 
 	//create texture
@@ -165,9 +289,9 @@ void BackendOpenGL::InitTexture(const char* uniformName)
 }
 
 /// <summary>
-/// Create VAO
+/// Create VAO for buffer
 /// </summary>
-void BackendOpenGL::InitVAO()
+void BackendOpenGL::InitVAO(StreamBuffer& b)
 {	
 #ifdef __ANDROID_API__
 	if (rs.glVersion == 2)
@@ -177,18 +301,235 @@ void BackendOpenGL::InitVAO()
 #endif
 
 	//init
-	GL_CHECK(glGenVertexArrays(1, &this->vao));
+	if (b.vao == 0)
+	{
+		GL_CHECK(glGenVertexArrays(1, &b.vao));
+	}
 
 	//bind data to it	
-	FONT_BIND_ARRAY_BUFFER(this->vbo);
+	FONT_BIND_ARRAY_BUFFER(b.vbo);
 
-	FONT_BIND_VAO(this->vao);
+	FONT_BIND_VAO(b.vao);
 
 	this->sm->BindVertexAtribs();
 	
+	FONT_UNBIND_VAO;
+
 	FONT_UNBIND_ARRAY_BUFFER;
+}
 
-	FONT_UNBIND_VAO;
+//=============================================================================
+// Geometry streaming
+//=============================================================================
+
+/// <summary>
+/// Create VBO and VAO of streaming buffer
+/// Storage is allocated during first upload
+/// </summary>
+/// <param name="b"></param>
+void BackendOpenGL::InitStreamBuffer(StreamBuffer& b)
+{
+	GL_CHECK(glGenBuffers(1, &b.vbo));
+	this->InitVAO(b);
+}
+
+void BackendOpenGL::ReleaseStreamBuffer(StreamBuffer& b)
+{
+	if (b.fence != 0)
+	{
+		GL_CHECK(glDeleteSync(b.fence));
+		b.fence = 0;
+	}
+
+	if (b.data != nullptr)
+	{
+		FONT_BIND_ARRAY_BUFFER(b.vbo);
+		GL_CHECK(glUnmapBuffer(GL_ARRAY_BUFFER));
+		FONT_UNBIND_ARRAY_BUFFER;
+		b.data = nullptr;
+	}
+
+	if (b.vbo != 0)
+	{
+		FONT_DELETE_BUFFER(b.vbo);
+		b.vbo = 0;
+	}
+
+	if (b.vao != 0)
+	{
+		FONT_DELETE_VAO(b.vao);
+		b.vao = 0;
+	}
+
+	b.capacity = 0;
+	b.size = 0;
+	b.dirtyStart = std::numeric_limits<size_t>::max();
+	b.dirtyEnd = 0;
+}
+
+/// <summary>
+/// Make sure buffer has at least bytes of storage
+/// Storage grows by 1.5x, so it is not reallocated on every small change
+/// Persistent storage is immutable - buffer is recreated and VAO updated
+/// </summary>
+/// <param name="b"></param>
+/// <param name="bytes"></param>
+void BackendOpenGL::ReserveStreamBuffer(StreamBuffer& b, size_t bytes)
+{
+	if (bytes <= b.capacity)
+	{
+		return;
+	}
+
+	const size_t capacity = std::max(bytes + bytes / 2, MIN_STREAM_BUFFER_SIZE);
+
+	if (this->persistentMapping == false)
+	{
+		FONT_BIND_ARRAY_BUFFER(b.vbo);
+		GL_CHECK(glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW));
+		FONT_UNBIND_ARRAY_BUFFER;
+
+		b.capacity = capacity;
+		return;
+	}
+
+#ifdef GL_MAP_PERSISTENT_BIT
+	this->ReleaseStreamBuffer(b);
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	GL_CHECK(glGenBuffers(1, &b.vbo));
+	FONT_BIND_ARRAY_BUFFER(b.vbo);
+	GL_CHECK(glBufferStorage(GL_ARRAY_BUFFER, capacity, nullptr, flags));
+	GL_CHECK(b.data = glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity, flags));
+	FONT_UNBIND_ARRAY_BUFFER;
+
+	b.capacity = capacity;
+
+	this->InitVAO(b);
+#endif
+}
+
+/// <summary>
+/// Wait until GPU finished all draws from buffer
+/// </summary>
+/// <param name="b"></param>
+void BackendOpenGL::WaitForStreamBuffer(StreamBuffer& b)
+{
+	this->WaitForFence(b.fence);
+}
+
+/// <summary>
+/// Wait until fence is signaled and delete it
+/// </summary>
+/// <param name="fence"></param>
+void BackendOpenGL::WaitForFence(GLsync& fence)
+{
+	if (fence == 0)
+	{
+		return;
+	}
+
+	const GLuint64 TIMEOUT_NS = 1000000; //1ms
+
+	GLenum res = GL_WAIT_FAILED;
+	do
+	{
+		GL_CHECK(res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT_NS));
+	} while (res == GL_TIMEOUT_EXPIRED);
+
+	GL_CHECK(glDeleteSync(fence));
+	fence = 0;
+}
+
+/// <summary>
+/// Move to the next buffer of persistent ring, wait until GPU
+/// finished with it and make sure it has at least bytes of storage
+/// Buffer becomes the current one for rendering
+/// </summary>
+/// <param name="bytes"></param>
+/// <returns></returns>
+BackendOpenGL::StreamBuffer& BackendOpenGL::AcquireStreamBuffer(size_t bytes)
+{
+	this->ringIndex = (this->ringIndex + 1) % RING_SIZE;
+	StreamBuffer& b = this->ring[this->ringIndex];
+
+	this->WaitForStreamBuffer(b);
+	this->ReserveStreamBuffer(b, bytes);
+
+	this->vbo = b.vbo;
+	this->vao = b.vao;
+
+	return b;
+}
+
+/// <summary>
+/// Upload geometry to the next buffer of ring
+/// With persistent mapping, data are copied directly to mapped memory
+/// of buffer that is not used by GPU (triple buffering)
+/// Otherwise, buffer is orphaned and filled with glBufferSubData
+/// </summary>
+/// <param name="data"></param>
+/// <param name="count">number of floats</param>
+void BackendOpenGL::UploadGeometry(const float* data, size_t count)
+{
+	const size_t bytes = count * sizeof(float);
+
+	if (this->persistentMapping)
+	{
+		StreamBuffer& b = this->AcquireStreamBuffer(bytes);
+
+		if (b.data != nullptr)
+		{
+			std::memcpy(b.data, data, bytes);
+		}
+
+		//other buffers of ring hold previous geometry
+		for (StreamBuffer& r : this->ring)
+		{
+			r.size = 0;
+			r.dirtyStart = std::numeric_limits<size_t>::max();
+			r.dirtyEnd = 0;
+		}
+		b.size = (b.data != nullptr) ? count : 0;
+		return;
+	}
+
+	StreamBuffer& b = this->ring[0];
+
+	FONT_BIND_ARRAY_BUFFER(b.vbo);
+	if (bytes <= b.capacity)
+	{
+		//orphan old storage - driver can give us a new one
+		//without waiting for GPU
+		GL_CHECK(glBufferData(GL_ARRAY_BUFFER, b.capacity, nullptr, GL_STREAM_DRAW));
+	}
+	else
+	{
+		this->ReserveStreamBuffer(b, bytes);
+		FONT_BIND_ARRAY_BUFFER(b.vbo);
+	}
+	GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data));
+	FONT_UNBIND_ARRAY_BUFFER;
+}
+
+/// <summary>
+/// Call after draw from current buffer
+/// Inserts fence, so the buffer is not overwritten while GPU uses it
+/// </summary>
+void BackendOpenGL::OnStreamBufferUsed()
+{
+	if (this->persistentMapping == false)
+	{
+		return;
+	}
+
+	StreamBuffer& b = this->ring[this->ringIndex];
+	if (b.fence != 0)
+	{
+		GL_CHECK(glDeleteSync(b.fence));
+	}
+	GL_CHECK(b.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
 }
 
 
@@ -215,6 +556,11 @@ void BackendOpenGL::SetFontTextureLinearFiler(bool val)
 
 const BackgroundSettings* BackendOpenGL::GetBackgroundSettings() const
 {
+	if (this->mergedBackground)
+	{
+		return &(*this->mergedBackground);
+	}
+
 	if (this->background)
 	{
 		return &this->background->GetBackgroundSettings();
@@ -227,12 +573,31 @@ const BackgroundSettings* BackendOpenGL::GetBackgroundSettings() const
 /// Set background settings 
 /// Will setup default shaders
 /// If nullopt is passed, backgrdound is disabled
+/// 
+/// With GlyphBackgroundShaderManager, backgrounds without shadow
+/// are added to glyphs geometry and rendered with the same draw call
 /// </summary>
 /// <param name="bs"></param>
 void BackendOpenGL::SetBackground(std::optional<BackgroundSettings> bs)
 {
+	if ((bs) && (this->mergedSm) && (bs->shadow.has_value() == false))
+	{
+		this->background = nullptr;
+		this->mergedBackground = bs;
+		this->mergedSm->SetBackgroundSettings(*bs);
+		return;
+	}
+
+	this->mergedBackground = std::nullopt;
+
 	if (bs)
 	{
+		//shape mode changes shaders - background must be created again
+		if ((this->background) && (this->background->GetBackgroundSettings().sdfShape != bs->sdfShape))
+		{
+			this->background = nullptr;
+		}
+
 		if (this->background)
 		{
 			this->background->SetBackgroundSettings(*bs);
@@ -240,6 +605,7 @@ void BackendOpenGL::SetBackground(std::optional<BackgroundSettings> bs)
 		else
 		{
 			this->background = std::make_unique<BackendBackgroundOpenGL>(*bs, rs);
+			this->background->SetView(this->viewX, this->viewY, this->viewZoom);
 		}
 	}
 	else 	
@@ -257,6 +623,8 @@ void BackendOpenGL::SetBackground(std::optional<BackgroundSettings> bs)
 /// <param name="sm"></param>
 void BackendOpenGL::SetBackground(std::optional<BackgroundSettings> bs, std::shared_ptr<IShaderManager> sm)
 {
+	this->mergedBackground = std::nullopt;
+
 	if ((bs.has_value() == false) || (sm == nullptr))
 	{
 		this->background = nullptr;
@@ -264,6 +632,7 @@ void BackendOpenGL::SetBackground(std::optional<BackgroundSettings> bs, std::sha
 	}
 		
 	this->background = std::make_unique<BackendBackgroundOpenGL>(*bs, rs, nullptr, nullptr, sm);
+	this->background->SetView(this->viewX, this->viewY, this->viewZoom);
 }
 
 void BackendOpenGL::SetMainRenderer(AbstractRenderer* mainRenderer)
@@ -283,7 +652,66 @@ void BackendOpenGL::OnCanvasChanges()
 		this->background->SetCanvasSize(this->rs.deviceW, this->rs.deviceH);		
 	}
 
-	this->sm->SetCanvasSize(this->rs.deviceW, this->rs.deviceH);
+	if (this->rs.useViewTransform)
+	{
+		//geometry is in pixels, canvas size is in view transform
+		this->sm->SetCanvasSize(1, 1);
+	}
+	else
+	{
+		this->sm->SetCanvasSize(this->rs.deviceW, this->rs.deviceH);
+	}
+
+	this->UpdateViewTransform();
+}
+
+/// <summary>
+/// Callback when view changes (see SetView)
+/// Only view transform is updated, geometry is kept
+/// </summary>
+void BackendOpenGL::OnViewChanges()
+{
+	if (this->background)
+	{
+		this->background->SetView(this->viewX, this->viewY, this->viewZoom);
+	}
+
+	this->UpdateViewTransform();
+}
+
+/// <summary>
+/// Calculate view transform from canvas size and view
+/// Shader managers store pixel position p as s = 2p - 1
+/// (y flipped, the same as for normalized positions), so
+/// clip = s * zoom / size + (zoom + 2 * translation) / size - 1
+/// </summary>
+void BackendOpenGL::UpdateViewTransform()
+{
+	if (this->rs.useViewTransform == false)
+	{
+		this->viewTransform[0] = 1.0f;
+		this->viewTransform[1] = 1.0f;
+		this->viewTransform[2] = 0.0f;
+		this->viewTransform[3] = 0.0f;
+		return;
+	}
+
+	const float w = static_cast<float>(this->rs.deviceW);
+	const float h = static_cast<float>(this->rs.deviceH);
+
+	this->viewTransform[0] = this->viewZoom / w;
+	this->viewTransform[1] = this->viewZoom / h;
+	this->viewTransform[2] = (this->viewZoom + 2.0f * this->viewX) / w - 1.0f;
+	this->viewTransform[3] = 1.0f - (this->viewZoom + 2.0f * this->viewY) / h;
+}
+
+/// <summary>
+/// Create profiler with GPU timer queries
+/// </summary>
+/// <returns></returns>
+std::unique_ptr<RenderProfiler> BackendOpenGL::CreateProfiler() const
+{
+	return std::make_unique<RenderProfilerOpenGL>();
 }
 
 std::shared_ptr<IShaderManager> BackendOpenGL::GetShaderManager() const
@@ -313,28 +741,41 @@ void BackendOpenGL::Render(std::function<void(GLuint)> preDrawCallback,
 		return;
 	}
 
+	if (this->batched)
+	{
+		//rendered by BatchCompositorOpenGL
+		return;
+	}
+
+	RenderProfiler::FrameScope frameScope(this->profiler.get());
+
+	this->SyncResources();
+
 #ifdef THREAD_SAFETY
 	std::shared_lock<std::shared_timed_mutex> lk(mainRenderer->m);
 #endif
 
-	bool vboChanged = this->mainRenderer->GenerateGeometry();
+	this->UpdateGeometry();
 
 	if (this->background)
 	{
+		RenderProfiler::PassScope passScope(this->profiler.get(), RenderProfiler::Pass::BACKGROUND);
 		this->background->Render(nullptr, nullptr);
 	}
 
-	if (this->geom.empty())
+	if ((this->geom.empty()) && (this->layers.empty()))
 	{
 		return;
 	}
 
+	RenderProfiler::PassScope passScope(this->profiler.get(), RenderProfiler::Pass::GLYPHS);
+
 	//wireframe
 	//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
 	    
 	//activate texture
-	GL_CHECK(glActiveTexture(GL_TEXTURE0));
+	FONT_ACTIVE_TEXTURE(GL_TEXTURE0);
 	FONT_BIND_TEXTURE_2D(this->texture);
 
 
@@ -342,22 +783,13 @@ void BackendOpenGL::Render(std::function<void(GLuint)> preDrawCallback,
 	FONT_BIND_SHADER(shader.program);
 
 	//render
-	FONT_BIND_ARRAY_BUFFER(this->vbo);
-
-#ifdef __ANDROID_API__
-	if (rs.glVersion == 2)
+	if (this->geom.empty() == false)
 	{
-		this->sm->BindVertexAtribs();
+		this->BindGeometry(this->vbo, this->vao);
 	}
-	else
-	{
-		FONT_BIND_VAO(this->vao);
-	}
-#else
-	FONT_BIND_VAO(this->vao);
-#endif		
 	
 	this->sm->BindUniforms();
+	this->sm->BindViewTransform(this->viewTransform);
 	this->sm->PreRender();
 
     if (preDrawCallback != nullptr)
@@ -365,7 +797,14 @@ void BackendOpenGL::Render(std::function<void(GLuint)> preDrawCallback,
         preDrawCallback(shader.program);
     }
     
-	this->sm->Render(this->quadsCount);
+	if (this->geom.empty() == false)
+	{
+		this->sm->Render(this->quadsCount);
+
+		this->OnStreamBufferUsed();
+	}
+
+	this->RenderLayers();
 	
 	if (postDrawCallback != nullptr)
 	{
@@ -385,50 +824,215 @@ void BackendOpenGL::Render(std::function<void(GLuint)> preDrawCallback,
 	FONT_UNBIND_SHADER;
 }
 
+/// <summary>
+/// Bind buffer with geometry for rendering
+/// </summary>
+/// <param name="vbo"></param>
+/// <param name="vao"></param>
+void BackendOpenGL::BindGeometry(GLuint vbo, GLuint vao)
+{
+	FONT_BIND_ARRAY_BUFFER(vbo);
+
+#ifdef __ANDROID_API__
+	if (rs.glVersion == 2)
+	{
+		this->sm->BindVertexAtribs();
+	}
+	else
+	{
+		FONT_BIND_VAO(vao);
+	}
+#else
+	FONT_BIND_VAO(vao);
+#endif
+}
+
+/// <summary>
+/// Render all layers in order of their ids
+/// Shader and uniforms must be already bound
+/// </summary>
+void BackendOpenGL::RenderLayers()
+{
+	for (auto& [id, l] : this->layers)
+	{
+		if (l.quadsCount == 0)
+		{
+			continue;
+		}
+
+		this->BindGeometry(l.buffer.vbo, l.buffer.vao);
+		this->sm->Render(l.quadsCount);
+	}
+}
+
 
 /// <summary>
 /// Fill texture from font builder to OpenGL texture
 /// so that it can be used in shader
+/// If texture contains previous revision of atlas, only rows
+/// of dirty region are uploaded (rows are continuous in memory)
 /// </summary>
 void BackendOpenGL::FillFontTexture()
 {
 	auto fb = mainRenderer->GetFontBuilder();
 
+	GLenum format = 0;
+	switch (sm->GetTextureChannels())
+	{
+	case 1: format = TEXTURE_SINGLE_CHANNEL; break;
+	case 3: format = GL_RGB; break;
+	case 4: format = GL_RGBA; break;
+	default: return;
+	}
+
+	const int w = fb->GetTextureWidth();
+	int y = 0;
+	int rows = fb->GetTextureHeight();
+
+	const uint64_t revision = fb->GetTextureRevision();
+	if ((revision != 0) && (revision == this->textureRevision + 1))
+	{
+		const TextureRegion dirty = fb->GetTextureDirtyRegion();
+		
+		this->textureRevision = revision;
+
+		if (dirty.IsEmpty())
+		{
+			return;
+		}
+
+		y = dirty.y;
+		rows = dirty.h;
+	}
+	else
+	{
+		this->textureRevision = revision;
+	}
+
+	const uint8_t* data = fb->GetTextureData() + 
+		static_cast<size_t>(y) * w * sm->GetTextureChannels();
+
+	RenderProfiler::PassScope passScope(this->profiler.get(), RenderProfiler::Pass::FILL_TEXTURE);
+
 	FONT_BIND_TEXTURE_2D(this->texture);
 
-	if (sm->GetTextureChannels() == 1)
+	if (this->asyncTextureUpload)
 	{
-		GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0,
-			0, 0,
-			fb->GetTextureWidth(), fb->GetTextureHeight(),
-			TEXTURE_SINGLE_CHANNEL, GL_UNSIGNED_BYTE, fb->GetTextureData()));
+		this->UploadTextureRows(data, y, w, rows, format);
 	}
-	else if (sm->GetTextureChannels() == 3)
+	else
 	{
 		GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0,
-			0, 0,
-			fb->GetTextureWidth(), fb->GetTextureHeight(),
-			GL_RGB, GL_UNSIGNED_BYTE, fb->GetTextureData()));
+			0, y,
+			w, rows,
+			format, GL_UNSIGNED_BYTE, data));
 	}
-	else if (sm->GetTextureChannels() == 4)
+
+	FONT_UNBIND_TEXTURE_2D;
+
+	this->textureStamp = ++lastTextureStamp;
+}
+
+/// <summary>
+/// Upload rows of bound texture through pixel buffer object
+/// Data are copied to PBO on CPU and glTexSubImage2D reads from it,
+/// so the call does not wait for driver copy of client memory
+/// PBOs are double-buffered, fence keeps buffer from being
+/// rewritten while copy from it is still in flight
+/// </summary>
+/// <param name="data">first uploaded row</param>
+/// <param name="y"></param>
+/// <param name="w"></param>
+/// <param name="rows"></param>
+/// <param name="format"></param>
+void BackendOpenGL::UploadTextureRows(const uint8_t* data, int y, int w, int rows, GLenum format)
+{
+	const size_t bytes = static_cast<size_t>(w) * rows * sm->GetTextureChannels();
+
+	PixelBuffer& pb = this->pixelBuffers[this->pixelBufferIndex];
+	this->pixelBufferIndex = (this->pixelBufferIndex + 1) % PIXEL_BUFFERS_COUNT;
+
+	if (pb.pbo == 0)
 	{
+		GL_CHECK(glGenBuffers(1, &pb.pbo));
+	}
+
+	this->WaitForFence(pb.fence);
+
+	GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pb.pbo));
+
+	if (bytes > pb.capacity)
+	{
+		GL_CHECK(glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW));
+		pb.capacity = bytes;
+	}
+
+	void* ptr = nullptr;
+	GL_CHECK(ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+	if (ptr == nullptr)
+	{
+		//mapping failed - upload directly from client memory
+		GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
 		GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0,
-			0, 0,
-			fb->GetTextureWidth(), fb->GetTextureHeight(),
-			GL_RGBA, GL_UNSIGNED_BYTE, fb->GetTextureData()));
+			0, y,
+			w, rows,
+			format, GL_UNSIGNED_BYTE, data));
+		return;
 	}
 
-	FONT_UNBIND_TEXTURE_2D;
+	std::memcpy(ptr, data, bytes);
+	GL_CHECK(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+	//data pointer is offset to bound PBO
+	GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0,
+		0, y,
+		w, rows,
+		format, GL_UNSIGNED_BYTE, nullptr));
+
+	GL_CHECK(pb.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+	GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+}
+
+void BackendOpenGL::ReleasePixelBuffers()
+{
+	for (PixelBuffer& pb : this->pixelBuffers)
+	{
+		if (pb.fence != 0)
+		{
+			GL_CHECK(glDeleteSync(pb.fence));
+			pb.fence = 0;
+		}
+
+		if (pb.pbo != 0)
+		{
+			FONT_DELETE_BUFFER(pb.pbo);
+			pb.pbo = 0;
+		}
+
+		pb.capacity = 0;
+	}
 }
 
 void BackendOpenGL::AddEmptyQuad(float x, float y, float w, float h, const AbstractRenderer::RenderParams& rp)
 {
+	if (this->rewriting)
+	{
+		return;
+	}
+
 	if (h < this->heightPx)
 	{
 		if ((this->background) && (this->heightThresholdKeepBackground))
 		{			
 			this->background->AddEmptyQuad(x * psW, (y - h) * psH, w * psW, h * psH, rp);
 		}
+		else if ((this->mergedBackground) && (this->heightThresholdKeepBackground))
+		{
+			this->mergedAabb.Update(x * psW, (y - h) * psH, w * psW, h * psH);
+		}
 		return;
 	}
 
@@ -436,6 +1040,10 @@ void BackendOpenGL::AddEmptyQuad(float x, float y, float w, float h, const Abstr
 	{
 		this->background->AddEmptyQuad(x * psW, (y - h) * psH, w * psW, h * psH, rp);
 	}
+	else if (this->mergedBackground)
+	{
+		this->mergedAabb.Update(x * psW, (y - h) * psH, w * psW, h * psH);
+	}
 }
 
 /// <summary>
@@ -448,7 +1056,7 @@ void BackendOpenGL::AddQuad(AbstractRenderer::Vertex& vmin, AbstractRenderer::Ve
 {
 	if ((vmax.y - vmin.y) < this->heightPx)
 	{
-		if ((this->background) && (this->heightThresholdKeepBackground))
+		if ((this->background) && (this->heightThresholdKeepBackground) && (this->rewriting == false))
 		{
 			//no need to recalculate u and v - they are not used in background
 			vmin.x *= psW;
@@ -459,6 +1067,11 @@ void BackendOpenGL::AddQuad(AbstractRenderer::Vertex& vmin, AbstractRenderer::Ve
 			
 			this->background->AddQuad(vmin, vmax, rp);
 		}
+		else if ((this->mergedBackground) && (this->heightThresholdKeepBackground) && (this->rewriting == false))
+		{
+			this->mergedAabb.Update(vmin.x * psW, vmin.y * psH,
+				(vmax.x - vmin.x) * psW, (vmax.y - vmin.y) * psH);
+		}
 		return;
 	}
 
@@ -475,10 +1088,14 @@ void BackendOpenGL::AddQuad(AbstractRenderer::Vertex& vmin, AbstractRenderer::Ve
     this->sm->FillQuadVertexData(vmin, vmax, rp, this->geom);
     
 	
-	if (this->background)
+	if ((this->background) && (this->rewriting == false))
 	{
 		this->background->AddQuad(vmin, vmax, rp);
 	}
+	else if ((this->mergedBackground) && (this->rewriting == false))
+	{
+		this->mergedAabb.Update(vmin.x, vmin.y, vmax.x - vmin.x, vmax.y - vmin.y);
+	}
 	
 
 	this->quadsCount++;
@@ -494,6 +1111,9 @@ void BackendOpenGL::Clear()
 	{
 		this->background->Clear();		
 	}
+
+	this->mergedAabb = AABB();
+	this->mergedGroupStart = 0;
 }
 
 void BackendOpenGL::OnFinishQuadGroup(const AbstractRenderer::RenderParams& rp)
@@ -502,6 +1122,81 @@ void BackendOpenGL::OnFinishQuadGroup(const AbstractRenderer::RenderParams& rp)
 	{
 		this->background->OnFinishQuadGroup(rp);
 	}
+
+	if (this->mergedBackground)
+	{
+		this->AddMergedBackground(rp);
+	}
+}
+
+/// <summary>
+/// Add background of finished group to glyphs geometry
+/// It is inserted before glyphs of the group, so the group
+/// is rendered over its background and later groups over both
+/// </summary>
+/// <param name="rp"></param>
+void BackendOpenGL::AddMergedBackground(const AbstractRenderer::RenderParams& rp)
+{
+	if (this->mergedAabb.IsEmpty() == false)
+	{
+		const BackgroundSettings& bs = *this->mergedBackground;
+
+		AbstractRenderer::Vertex min, max;
+
+		min.x = this->mergedAabb.minX - (bs.padding * rp.scale * psW);
+		min.y = this->mergedAabb.minY - (bs.padding * rp.scale * psH);
+
+		max.x = this->mergedAabb.maxX + (bs.padding * rp.scale * psW);
+		max.y = this->mergedAabb.maxY + (bs.padding * rp.scale * psH);
+
+		this->mergedBackgroundGeom.clear();
+		if (this->mergedSm->FillBackgroundVertexData(min, max, rp, this->mergedBackgroundGeom))
+		{
+			this->geom.insert(this->geom.begin() + this->mergedGroupStart,
+				this->mergedBackgroundGeom.begin(), this->mergedBackgroundGeom.end());
+
+			this->quadsCount++;
+		}
+	}
+
+	this->mergedAabb = AABB();
+	this->mergedGroupStart = this->geom.size();
+}
+
+void BackendOpenGL::PrefetchResources(const AbstractRenderer::RenderParams& rp)
+{
+	this->sm->PrefetchResources(rp);
+
+	if (this->background)
+	{
+		this->background->sm->PrefetchResources(rp);
+	}
+}
+
+/// <summary>
+/// Sync point for resources loaded in background (eg. background images)
+/// If some were uploaded, geometry of main renderer is generated again
+/// Must be called outside of renderer lock
+/// </summary>
+void BackendOpenGL::SyncResources()
+{
+	bool changed = this->sm->SyncResources();
+
+	if (this->background)
+	{
+		changed |= this->background->sm->SyncResources();
+	}
+
+	if (changed == false)
+	{
+		return;
+	}
+
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(mainRenderer->m);
+#endif
+
+	this->mainRenderer->strChanged = true;
 }
 
 void BackendOpenGL::FillGeometry()
@@ -511,16 +1206,240 @@ void BackendOpenGL::FillGeometry()
 		this->background->FillGeometry();
 	}
 
-    if (this->geom.empty())
+    if ((this->geom.empty()) || (this->batched))
     {
+		this->dirtyStart = std::numeric_limits<size_t>::max();
+		this->dirtyEnd = 0;
         return;
     }
     
+	RenderProfiler::PassScope passScope(this->profiler.get(), RenderProfiler::Pass::FILL_GEOMETRY);
+
+	this->UploadGeometry(this->geom.data(), this->geom.size());
+
+	//entire geometry was uploaded
+	this->dirtyStart = std::numeric_limits<size_t>::max();
+	this->dirtyEnd = 0;
+}
+
+/// <summary>
+/// Upload only dirty part of geometry (see RewriteGeometry)
+/// Buffers of persistent ring can be still used by GPU, so
+/// the next buffer is written instead. Each buffer of ring remembers
+/// range changed since it was last written - only this range is copied
+/// (entire geometry only if the buffer does not hold a valid copy)
+/// </summary>
+void BackendOpenGL::FillDirtyGeometry()
+{
+	if (this->dirtyEnd <= this->dirtyStart)
+	{
+		return;
+	}
+
+	if (this->batched)
+	{
+		//compositor copies entire geometry
+		this->dirtyStart = std::numeric_limits<size_t>::max();
+		this->dirtyEnd = 0;
+		return;
+	}
+
+	RenderProfiler::PassScope passScope(this->profiler.get(), RenderProfiler::Pass::FILL_GEOMETRY);
+
+	if (this->persistentMapping)
+	{
+		for (StreamBuffer& r : this->ring)
+		{
+			r.dirtyStart = std::min(r.dirtyStart, this->dirtyStart);
+			r.dirtyEnd = std::max(r.dirtyEnd, this->dirtyEnd);
+		}
+
+		const size_t count = this->geom.size();
+		StreamBuffer& b = this->AcquireStreamBuffer(count * sizeof(float));
+
+		if (b.data != nullptr)
+		{
+			float* dst = static_cast<float*>(b.data);
+			if (b.size != count)
+			{
+				std::memcpy(dst, this->geom.data(), count * sizeof(float));
+			}
+			else
+			{
+				std::memcpy(dst + b.dirtyStart, this->geom.data() + b.dirtyStart,
+					(b.dirtyEnd - b.dirtyStart) * sizeof(float));
+			}
+		}
+
+		b.size = (b.data != nullptr) ? count : 0;
+		b.dirtyStart = std::numeric_limits<size_t>::max();
+		b.dirtyEnd = 0;
+
+		this->dirtyStart = std::numeric_limits<size_t>::max();
+		this->dirtyEnd = 0;
+		return;
+	}
+
 	FONT_BIND_ARRAY_BUFFER(this->vbo);
-	GL_CHECK(glBufferData(GL_ARRAY_BUFFER, 
-		this->geom.size() * sizeof(float),
-		this->geom.data(),
-		GL_STREAM_DRAW));
+	GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER,
+		this->dirtyStart * sizeof(float),
+		(this->dirtyEnd - this->dirtyStart) * sizeof(float),
+		this->geom.data() + this->dirtyStart));
 	FONT_UNBIND_ARRAY_BUFFER;
-	
+
+	this->dirtyStart = std::numeric_limits<size_t>::max();
+	this->dirtyEnd = 0;
+}
+
+/// <summary>
+/// Layers are stored in own buffers only if backend renders itself
+/// Batch compositor copies only main geometry and separate background 
+/// is generated together with glyphs of all layers
+/// </summary>
+/// <returns></returns>
+bool BackendOpenGL::IsLayerSupported() const
+{
+	return (this->batched == false) && (this->background == nullptr);
+}
+
+/// <summary>
+/// Start geometry of layer
+/// Main geometry is moved aside, so quads are added to empty geometry
+/// </summary>
+/// <param name="layer"></param>
+/// <param name="isStatic"></param>
+void BackendOpenGL::BeginLayer(uint8_t layer, bool isStatic)
+{
+	if (this->activeLayer)
+	{
+		this->EndLayer();
+	}
+
+	this->activeLayer = layer;
+	this->activeLayerStatic = isStatic;
+
+	std::swap(this->geom, this->mainGeom);
+	this->geom.clear();
+
+	this->mainQuadsCount = this->quadsCount;
+	this->quadsCount = 0;
+
+	this->mergedAabb = AABB();
+	this->mergedGroupStart = 0;
+}
+
+/// <summary>
+/// Upload geometry of active layer and restore main geometry
+/// </summary>
+void BackendOpenGL::EndLayer()
+{
+	if (this->activeLayer.has_value() == false)
+	{
+		return;
+	}
+
+	auto it = this->layers.find(*this->activeLayer);
+	if (it == this->layers.end())
+	{
+		LayerBuffer l;
+		l.buffer.vbo = 0;
+		l.buffer.vao = 0;
+		l.buffer.data = nullptr;
+		l.buffer.capacity = 0;
+		l.buffer.fence = 0;
+		l.quadsCount = 0;
+
+		it = this->layers.emplace(*this->activeLayer, l).first;
+	}
+
+	this->FillLayer(it->second, this->activeLayerStatic);
+
+	std::swap(this->geom, this->mainGeom);
+	this->quadsCount = this->mainQuadsCount;
+
+	this->mergedAabb = AABB();
+	this->mergedGroupStart = this->geom.size();
+
+	this->activeLayer = std::nullopt;
+}
+
+/// <summary>
+/// Release buffers of all layers
+/// </summary>
+void BackendOpenGL::ClearLayers()
+{
+	for (auto& [id, l] : this->layers)
+	{
+		this->ReleaseStreamBuffer(l.buffer);
+	}
+
+	this->layers.clear();
+}
+
+/// <summary>
+/// Upload current geometry to layer buffer
+/// Static layer storage is allocated with exact size, so it is recreated
+/// on every change, dynamic layer storage grows the same way as streaming
+/// buffers and is orphaned before upload
+/// </summary>
+/// <param name="l"></param>
+/// <param name="isStatic"></param>
+void BackendOpenGL::FillLayer(LayerBuffer& l, bool isStatic)
+{
+	l.quadsCount = this->quadsCount;
+
+	if (this->geom.empty())
+	{
+		return;
+	}
+
+	RenderProfiler::PassScope passScope(this->profiler.get(), RenderProfiler::Pass::FILL_GEOMETRY);
+
+	if (l.buffer.vbo == 0)
+	{
+		this->InitStreamBuffer(l.buffer);
+	}
+
+	const size_t bytes = this->geom.size() * sizeof(float);
+
+	FONT_BIND_ARRAY_BUFFER(l.buffer.vbo);
+
+	if (isStatic)
+	{
+		GL_CHECK(glBufferData(GL_ARRAY_BUFFER, bytes, this->geom.data(), GL_STATIC_DRAW));
+		l.buffer.capacity = bytes;
+	}
+	else
+	{
+		if (bytes > l.buffer.capacity)
+		{
+			l.buffer.capacity = std::max(bytes + bytes / 2, MIN_STREAM_BUFFER_SIZE);
+		}
+
+		GL_CHECK(glBufferData(GL_ARRAY_BUFFER, l.buffer.capacity, nullptr, GL_STREAM_DRAW));
+		GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, this->geom.data()));
+	}
+
+	FONT_UNBIND_ARRAY_BUFFER;
+}
+
+/// <summary>
+/// Generate geometry of main renderer and upload it
+/// If geometry was not regenerated, only dirty part is uploaded
+/// </summary>
+/// <returns>true if geometry changed</returns>
+bool BackendOpenGL::UpdateGeometry()
+{
+	if (this->mainRenderer->GenerateGeometry())
+	{
+		return true;
+	}
+
+	if (this->dirtyEnd <= this->dirtyStart)
+	{
+		return false;
+	}
+
+	this->FillDirtyGeometry();
+	return true;
 }
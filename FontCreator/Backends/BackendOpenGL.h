@@ -3,9 +3,11 @@
 
 class BackendBackgroundOpenGL;
 class IShaderManager;
+class GlyphBackgroundShaderManager;
 
 #include <vector>
 #include <list>
+#include <map>
 #include <unordered_set>
 #include <functional>
 #include <shared_mutex>
@@ -39,9 +41,15 @@ public:
 	
 	void Clear() override;
 	void OnFinishQuadGroup(const AbstractRenderer::RenderParams& rp) override;
+	void PrefetchResources(const AbstractRenderer::RenderParams& rp) override;
 
 	void FillFontTexture() override;
 	void FillGeometry() override;
+
+	bool IsLayerSupported() const override;
+	void BeginLayer(uint8_t layer, bool isStatic) override;
+	void EndLayer() override;
+	void ClearLayers() override;
 	
 	void Render() override;
     virtual void Render(std::function<void(GLuint)> preDrawCallback, std::function<void()> postDrawCallback);
@@ -49,6 +57,7 @@ public:
 	friend class AbstractRenderer;
 	friend class StringRenderer;
 	friend class NumberRenderer;
+	friend class BatchCompositorOpenGL;
 	
 protected:
 	 	
@@ -60,25 +69,144 @@ protected:
 		const char * pSource;
         bool isDefault;        
 	};
+
+	/// <summary>
+	/// One buffer of geometry streaming ring
+	/// data is persistently mapped memory (nullptr if mapping is not used)
+	/// fence is signaled when GPU finished last draw from this buffer
+	/// size is number of floats of geometry copy stored in data (0 = no valid copy)
+	/// [dirtyStart, dirtyEnd) are floats changed since this buffer was last written
+	/// </summary>
+	struct StreamBuffer
+	{
+		GLuint vbo;
+		GLuint vao;
+		void* data;
+		size_t capacity;
+		GLsync fence;
+		size_t size;
+		size_t dirtyStart;
+		size_t dirtyEnd;
+	};
+
+	/// <summary>
+	/// Geometry of one layer (see BeginLayer)
+	/// Static layer has GL_STATIC_DRAW storage of exact size,
+	/// dynamic layer is orphaned GL_STREAM_DRAW storage
+	/// </summary>
+	struct LayerBuffer
+	{
+		StreamBuffer buffer;
+		int quadsCount;
+	};
+
+	/// <summary>
+	/// Pixel buffer for asynchronous texture upload
+	/// fence is signaled when GPU finished copy to texture
+	/// </summary>
+	struct PixelBuffer
+	{
+		GLuint pbo;
+		size_t capacity;
+		GLsync fence;
+	};
+
+	static const int RING_SIZE = 3;
+	static constexpr size_t MIN_STREAM_BUFFER_SIZE = 16 * 1024;
+	static const int PIXEL_BUFFERS_COUNT = 2;
 	
     std::shared_ptr<IShaderManager> sm;
 	
 	std::unique_ptr<BackendBackgroundOpenGL> background;
 
+	//backgrounds stored in the same geometry as glyphs
+	//(only if sm is GlyphBackgroundShaderManager, see SetBackground)
+	std::shared_ptr<GlyphBackgroundShaderManager> mergedSm;
+	std::optional<BackgroundSettings> mergedBackground;
+	AABB mergedAabb;
+	size_t mergedGroupStart;
+	std::vector<float> mergedBackgroundGeom;
+
+	//currently used buffer from ring
 	GLuint vbo;
 	GLuint vao;
+
+	StreamBuffer ring[RING_SIZE];
+	int ringIndex;
+	bool persistentMapping;
+
+	//layers sorted by id = render order
+	std::map<uint8_t, LayerBuffer> layers;
+	std::optional<uint8_t> activeLayer;
+	bool activeLayerStatic;
+
+	//main geometry while layer is generated (see BeginLayer)
+	std::vector<float> mainGeom;
+	int mainQuadsCount;
+
 	GLuint texture;
 	Shader shader;
+
+	//font texture upload through double-buffered PBOs
+	PixelBuffer pixelBuffers[PIXEL_BUFFERS_COUNT];
+	int pixelBufferIndex;
+	bool asyncTextureUpload;
+
+	//font builder texture revision in GL texture (see FillFontTexture)
+	uint64_t textureRevision;
+
+	//stamp of last texture fill (see FillFontTexture)
+	uint64_t textureStamp;
+	static uint64_t lastTextureStamp;
+
+	//number of existing backends - buffers shared by shader
+	//managers are released with the last one
+	static int backendsCount;
+
+	//geometry is rendered by BatchCompositorOpenGL
+	//it is not uploaded to own VBO
+	bool batched;
 		
 	float tW; //1.0 / pixel size in width
 	float tH; //1.0 / pixel size in height
 
+	//transform of vertex positions to clip space - sx, sy, tx, ty
+	//(identity, if view transform is not used)
+	float viewTransform[4];
+
 	void InitGL();
 	
 	void InitTexture(const char* uniformName);
-	void InitVAO();
+	void InitVAO(StreamBuffer& b);
+
+	void InitStreamBuffer(StreamBuffer& b);
+	void ReleaseStreamBuffer(StreamBuffer& b);
+	void ReserveStreamBuffer(StreamBuffer& b, size_t bytes);
+	void WaitForStreamBuffer(StreamBuffer& b);
+	StreamBuffer& AcquireStreamBuffer(size_t bytes);
+	void UploadGeometry(const float* data, size_t count);
+	void OnStreamBufferUsed();
+
+	void WaitForFence(GLsync& fence);
+
+	void UploadTextureRows(const uint8_t* data, int y, int w, int rows, GLenum format);
+	void ReleasePixelBuffers();
+
+	void FillDirtyGeometry();
+	void FillLayer(LayerBuffer& l, bool isStatic);
+	bool UpdateGeometry();
+	void SyncResources();
 	
+	void AddMergedBackground(const AbstractRenderer::RenderParams& rp);
+
+	void BindGeometry(GLuint vbo, GLuint vao);
+	void RenderLayers();
+
 	void OnCanvasChanges() override;
+	void OnViewChanges() override;
+	void UpdateViewTransform();
+
+	std::unique_ptr<RenderProfiler> CreateProfiler() const override;
 
 	void AddEmptyQuad(float x, float y, float w, float h, const AbstractRenderer::RenderParams& rp) override;
 	void AddQuad(AbstractRenderer::Vertex& vmin, AbstractRenderer::Vertex& vmax, const AbstractRenderer::RenderParams& rp) override;
@@ -0,0 +1,382 @@
+#include "./BatchCompositorOpenGL.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <shared_mutex>
+
+#include "../Renderers/AbstractRenderer.h"
+#include "../TextureBuilders/IFontBuilder.h"
+
+#include "./Shaders/IShaderManager.h"
+
+#include "./BackendOpenGL.h"
+#include "./BackendBackgroundOpenGL.h"
+
+BatchCompositorOpenGL::BatchCompositorOpenGL() :
+	drawCallsCount(0)
+{
+}
+
+BatchCompositorOpenGL::~BatchCompositorOpenGL()
+{
+	for (RunBuffer& run : this->runs)
+	{
+		this->ReleaseRun(run);
+	}
+}
+
+/// <summary>
+/// Get OpenGL backend of renderer
+/// </summary>
+/// <param name="r"></param>
+/// <returns>nullptr if renderer is not using BackendOpenGL</returns>
+BackendOpenGL* BatchCompositorOpenGL::GetBackend(AbstractRenderer* r)
+{
+	return dynamic_cast<BackendOpenGL*>(r->GetBackend());
+}
+
+/// <summary>
+/// Test if geometry of both backends can be rendered with one draw call
+/// </summary>
+/// <param name="a"></param>
+/// <param name="b"></param>
+/// <returns></returns>
+bool BatchCompositorOpenGL::CanBatch(BackendOpenGL* a, BackendOpenGL* b)
+{
+	//custom shaders are not comparable
+	if ((a->shader.isDefault == false) || (b->shader.isDefault == false))
+	{
+		return false;
+	}
+
+	//background is rendered before glyphs of its run - renderer with 
+	//background starts a new run, so it is not painted over glyphs 
+	//of previous renderers
+	if (b->background)
+	{
+		return false;
+	}
+
+	if ((a->rs.deviceW != b->rs.deviceW) || (a->rs.deviceH != b->rs.deviceH))
+	{
+		return false;
+	}
+
+	//batch is rendered with view of the first renderer
+	if ((a->rs.useViewTransform != b->rs.useViewTransform) || 
+		(a->viewX != b->viewX) || (a->viewY != b->viewY) || (a->viewZoom != b->viewZoom))
+	{
+		return false;
+	}
+
+	//the same texture content
+	if (a->mainRenderer->fb->GetTextureData() != b->mainRenderer->fb->GetTextureData())
+	{
+		return false;
+	}
+
+	return a->sm->CanBatchWith(b->sm.get());
+}
+
+/// <summary>
+/// Add renderer at the end of render order
+/// Renderer must use BackendOpenGL
+/// </summary>
+/// <param name="r"></param>
+void BatchCompositorOpenGL::AddRenderer(AbstractRenderer* r)
+{
+	BackendOpenGL* b = GetBackend(r);
+	if (b == nullptr)
+	{
+		throw std::invalid_argument("Only renderers with BackendOpenGL can be batched");
+	}
+
+	if (std::find(this->renderers.begin(), this->renderers.end(), r) != this->renderers.end())
+	{
+		return;
+	}
+
+	b->batched = true;
+	this->renderers.push_back(r);
+}
+
+/// <summary>
+/// Remove renderer - it is rendered by its own Render() again
+/// </summary>
+/// <param name="r"></param>
+void BatchCompositorOpenGL::RemoveRenderer(AbstractRenderer* r)
+{
+	auto it = std::find(this->renderers.begin(), this->renderers.end(), r);
+	if (it == this->renderers.end())
+	{
+		return;
+	}
+
+	this->renderers.erase(it);
+
+	BackendOpenGL* b = GetBackend(r);
+	b->batched = false;
+
+#ifdef THREAD_SAFETY
+	std::unique_lock<std::shared_timed_mutex> lk(r->m);
+#endif
+
+	//own VBO is outdated
+	b->FillGeometry();
+}
+
+/// <summary>
+/// Remove all renderers
+/// </summary>
+void BatchCompositorOpenGL::Clear()
+{
+	while (this->renderers.empty() == false)
+	{
+		this->RemoveRenderer(this->renderers.back());
+	}
+}
+
+/// <summary>
+/// Get number of glyph draw calls used during last Render
+/// </summary>
+/// <returns></returns>
+int BatchCompositorOpenGL::GetDrawCallsCount() const
+{
+	return this->drawCallsCount;
+}
+
+/// <summary>
+/// Render all renderers
+/// </summary>
+void BatchCompositorOpenGL::Render()
+{
+	this->drawCallsCount = 0;
+
+	std::vector<BackendOpenGL*> members;
+	bool changed = false;
+	size_t runIndex = 0;
+
+#ifdef THREAD_SAFETY
+	std::vector<std::shared_lock<std::shared_timed_mutex>> locks;
+#endif
+
+	for (AbstractRenderer* r : this->renderers)
+	{
+		BackendOpenGL* b = GetBackend(r);
+		if (b->enabled == false)
+		{
+			continue;
+		}
+
+		if ((members.empty() == false) && (CanBatch(members.front(), b) == false))
+		{
+			this->RenderRun(runIndex, members, changed);
+			runIndex++;
+
+			members.clear();
+			changed = false;
+#ifdef THREAD_SAFETY
+			locks.clear();
+#endif
+		}
+
+		b->SyncResources();
+
+#ifdef THREAD_SAFETY
+		locks.emplace_back(r->m);
+#endif
+
+		changed |= b->UpdateGeometry();
+
+		if (b->background)
+		{
+			b->background->Render(nullptr, nullptr);
+		}
+
+		members.push_back(b);
+	}
+
+	if (members.empty() == false)
+	{
+		this->RenderRun(runIndex, members, changed);
+		runIndex++;
+	}
+
+	//release buffers of runs that are no longer used
+	for (size_t i = runIndex; i < this->runs.size(); i++)
+	{
+		this->ReleaseRun(this->runs[i]);
+	}
+	this->runs.resize(runIndex);
+}
+
+/// <summary>
+/// Render glyphs of one run with single draw call
+/// </summary>
+/// <param name="runIndex"></param>
+/// <param name="members"></param>
+/// <param name="changed">geometry of some member changed</param>
+void BatchCompositorOpenGL::RenderRun(size_t runIndex, const std::vector<BackendOpenGL*>& members, bool changed)
+{
+	if (runIndex >= this->runs.size())
+	{
+		RunBuffer run;
+		run.vbo = 0;
+		run.vao = 0;
+		run.capacity = 0;
+		run.layout = nullptr;
+		this->runs.push_back(run);
+	}
+
+	RunBuffer& run = this->runs[runIndex];
+
+	if ((changed) || (run.members != members))
+	{
+		this->UploadRun(run, members);
+	}
+
+	int quadsCount = 0;
+	BackendOpenGL* textureOwner = members.front();
+	for (BackendOpenGL* b : members)
+	{
+		quadsCount += b->quadsCount;
+
+		//the most recently filled texture contains all glyphs
+		if (b->textureStamp > textureOwner->textureStamp)
+		{
+			textureOwner = b;
+		}
+	}
+
+	if (quadsCount == 0)
+	{
+		return;
+	}
+
+	BackendOpenGL* first = members.front();
+	IShaderManager* sm = first->sm.get();
+
+	FONT_ACTIVE_TEXTURE(GL_TEXTURE0);
+	FONT_BIND_TEXTURE_2D(textureOwner->texture);
+
+	FONT_BIND_SHADER(first->shader.program);
+
+	FONT_BIND_ARRAY_BUFFER(run.vbo);
+
+#ifdef __ANDROID_API__
+	if (first->rs.glVersion == 2)
+	{
+		sm->BindVertexAtribs();
+	}
+	else
+	{
+		FONT_BIND_VAO(run.vao);
+	}
+#else
+	FONT_BIND_VAO(run.vao);
+#endif
+
+	sm->BindUniforms();
+	sm->BindViewTransform(first->viewTransform);
+	sm->PreRender();
+
+	sm->Render(quadsCount);
+	this->drawCallsCount++;
+
+#ifdef __ANDROID_API__
+	if (first->rs.glVersion != 2)
+	{
+		FONT_UNBIND_VAO;
+	}
+#else
+	FONT_UNBIND_VAO;
+#endif
+
+	FONT_UNBIND_SHADER;
+}
+
+/// <summary>
+/// Copy geometry of all members to run buffer
+/// </summary>
+/// <param name="run"></param>
+/// <param name="members"></param>
+void BatchCompositorOpenGL::UploadRun(RunBuffer& run, const std::vector<BackendOpenGL*>& members)
+{
+	run.members = members;
+
+	this->geom.clear();
+	for (BackendOpenGL* b : members)
+	{
+		this->geom.insert(this->geom.end(), b->geom.begin(), b->geom.end());
+	}
+
+	if (run.vbo == 0)
+	{
+		GL_CHECK(glGenBuffers(1, &run.vbo));
+	}
+
+	const size_t bytes = this->geom.size() * sizeof(float);
+
+	FONT_BIND_ARRAY_BUFFER(run.vbo);
+	if (bytes > run.capacity)
+	{
+		run.capacity = std::max(bytes + bytes / 2, static_cast<size_t>(16 * 1024));
+	}
+
+	//orphan old storage
+	GL_CHECK(glBufferData(GL_ARRAY_BUFFER, run.capacity, nullptr, GL_STREAM_DRAW));
+	if (bytes > 0)
+	{
+		GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, this->geom.data()));
+	}
+
+	IShaderManager* sm = members.front()->sm.get();
+
+#ifdef __ANDROID_API__
+	if (members.front()->rs.glVersion == 2)
+	{
+		run.layout = sm;
+	}
+#endif
+
+	//VAO stores layout of vertex attributes - rebuild it
+	//only if run is rendered with different shader
+	if (run.layout != sm)
+	{
+		if (run.vao == 0)
+		{
+			GL_CHECK(glGenVertexArrays(1, &run.vao));
+		}
+
+		FONT_BIND_VAO(run.vao);
+		sm->BindVertexAtribs();
+		FONT_UNBIND_VAO;
+
+		run.layout = sm;
+	}
+
+	FONT_UNBIND_ARRAY_BUFFER;
+}
+
+/// <summary>
+/// Release OpenGL objects of run
+/// </summary>
+/// <param name="run"></param>
+void BatchCompositorOpenGL::ReleaseRun(RunBuffer& run)
+{
+	if (run.vao != 0)
+	{
+		FONT_DELETE_VAO(run.vao);
+	}
+
+	if (run.vbo != 0)
+	{
+		FONT_DELETE_BUFFER(run.vbo);
+	}
+
+	run.vao = 0;
+	run.vbo = 0;
+	run.capacity = 0;
+	run.layout = nullptr;
+	run.members.clear();
+}
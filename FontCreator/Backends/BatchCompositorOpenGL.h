@@ -0,0 +1,69 @@
+#ifndef BATCH_COMPOSITOR_OPENGL_H
+#define BATCH_COMPOSITOR_OPENGL_H
+
+class AbstractRenderer;
+class BackendOpenGL;
+class IShaderManager;
+
+#include <vector>
+
+#include "../Externalncludes.h"
+
+/// <summary>
+/// Render geometry of several OpenGL renderers together
+/// 
+/// Renderers are rendered in order they were added. Consecutive renderers
+/// with the same font texture (eg. font builders with shared TextureAtlasPack)
+/// and compatible shader managers (see IShaderManager::CanBatchWith) form one run.
+/// Geometry of the run is copied to one buffer and rendered with one draw call.
+/// 
+/// Renderer with separate background always starts a new run - its background
+/// is rendered after glyphs of previous renderers and before glyphs of the run.
+/// Incompatible renderer splits the run, so order between runs is kept.
+/// 
+/// Added renderers are not rendered by their own Render()
+/// </summary>
+class BatchCompositorOpenGL
+{
+public:
+	BatchCompositorOpenGL();
+	~BatchCompositorOpenGL();
+
+	void AddRenderer(AbstractRenderer* r);
+	void RemoveRenderer(AbstractRenderer* r);
+	void Clear();
+
+	int GetDrawCallsCount() const;
+
+	void Render();
+
+protected:
+
+	/// <summary>
+	/// Buffer with geometry of one run
+	/// layout is shader manager that was used to create VAO
+	/// </summary>
+	struct RunBuffer
+	{
+		GLuint vbo;
+		GLuint vao;
+		size_t capacity;
+		IShaderManager* layout;
+		std::vector<BackendOpenGL*> members;
+	};
+
+	std::vector<AbstractRenderer*> renderers;
+	std::vector<RunBuffer> runs;
+	std::vector<float> geom;
+
+	int drawCallsCount;
+
+	static BackendOpenGL* GetBackend(AbstractRenderer* r);
+	static bool CanBatch(BackendOpenGL* a, BackendOpenGL* b);
+
+	void RenderRun(size_t runIndex, const std::vector<BackendOpenGL*>& members, bool changed);
+	void UploadRun(RunBuffer& run, const std::vector<BackendOpenGL*>& members);
+	void ReleaseRun(RunBuffer& run);
+};
+
+#endif
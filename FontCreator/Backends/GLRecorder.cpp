@@ -0,0 +1,671 @@
+#include "./GLRecorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+//=====================================================================================
+// Recorder
+//=====================================================================================
+
+GLRecorder::GLRecorder() : 
+	logEnabled(true),
+	lastName(0),
+	lastFence(0),
+	program(0)
+{
+}
+
+GLRecorder& GLRecorder::GetInstance()
+{
+	static GLRecorder instance;
+	return instance;
+}
+
+/// <summary>
+/// Forget all emulated objects, log and stats
+/// </summary>
+void GLRecorder::Reset()
+{
+	this->calls.clear();
+	this->frameStats = Stats();
+	this->totalStats = Stats();
+	this->lastName = 0;
+	this->lastFence = 0;
+	this->program = 0;
+	this->buffers.clear();
+	this->boundBuffers.clear();
+	this->locations.clear();
+}
+
+/// <summary>
+/// Start new frame - frame stats and log are cleared
+/// Emulated objects are kept
+/// </summary>
+void GLRecorder::BeginFrame()
+{
+	this->calls.clear();
+	this->frameStats = Stats();
+}
+
+/// <summary>
+/// Enable / disable log of calls
+/// If disabled, only stats are counted
+/// </summary>
+/// <param name="val"></param>
+void GLRecorder::SetLogEnabled(bool val)
+{
+	this->logEnabled = val;
+}
+
+const std::vector<GLRecorder::Call>& GLRecorder::GetCalls() const
+{
+	return this->calls;
+}
+
+/// <summary>
+/// Get number of logged calls of function with name
+/// </summary>
+/// <param name="name"></param>
+/// <returns></returns>
+size_t GLRecorder::GetCallsCount(const char* name) const
+{
+	return static_cast<size_t>(std::count_if(this->calls.begin(), this->calls.end(), [&](const Call& c) {
+		return strcmp(c.name, name) == 0;
+	}));
+}
+
+const GLRecorder::Stats& GLRecorder::GetFrameStats() const
+{
+	return this->frameStats;
+}
+
+const GLRecorder::Stats& GLRecorder::GetTotalStats() const
+{
+	return this->totalStats;
+}
+
+GLuint GLRecorder::GetBoundBuffer(GLenum target) const
+{
+	auto it = this->boundBuffers.find(target);
+	return (it == this->boundBuffers.end()) ? 0 : it->second;
+}
+
+GLuint GLRecorder::GetProgram() const
+{
+	return this->program;
+}
+
+/// <summary>
+/// Get current content of buffer
+/// </summary>
+/// <param name="buffer"></param>
+/// <returns>nullptr if buffer does not exist</returns>
+const std::vector<uint8_t>* GLRecorder::GetBufferData(GLuint buffer) const
+{
+	auto it = this->buffers.find(buffer);
+	return (it == this->buffers.end()) ? nullptr : &it->second.data;
+}
+
+/// <summary>
+/// Get number of buffers that were created and not deleted
+/// </summary>
+/// <returns></returns>
+size_t GLRecorder::GetBuffersCount() const
+{
+	return this->buffers.size();
+}
+
+void GLRecorder::AddDraw()
+{
+	this->frameStats.drawCalls++;
+	this->totalStats.drawCalls++;
+}
+
+void GLRecorder::AddStateChange()
+{
+	this->frameStats.stateChanges++;
+	this->totalStats.stateChanges++;
+}
+
+void GLRecorder::AddBufferBytes(uint64_t bytes)
+{
+	this->frameStats.bufferBytes += bytes;
+	this->totalStats.bufferBytes += bytes;
+}
+
+void GLRecorder::AddTextureBytes(uint64_t bytes)
+{
+	this->frameStats.textureBytes += bytes;
+	this->totalStats.textureBytes += bytes;
+}
+
+/// <summary>
+/// Generate name of new object
+/// All object types share one sequence
+/// </summary>
+/// <returns></returns>
+GLuint GLRecorder::GenName()
+{
+	return ++this->lastName;
+}
+
+/// <summary>
+/// Get location of attribute / uniform of program
+/// New names get next free location
+/// </summary>
+/// <param name="program"></param>
+/// <param name="name"></param>
+/// <returns></returns>
+GLint GLRecorder::GetLocation(GLuint program, const GLchar* name)
+{
+	auto& l = this->locations[program];
+	auto it = l.try_emplace(name, static_cast<GLint>(l.size()));
+	return it.first->second;
+}
+
+GLsync GLRecorder::CreateFence()
+{
+	return reinterpret_cast<GLsync>(++this->lastFence);
+}
+
+GLRecorder::Buffer* GLRecorder::GetBuffer(GLuint buffer)
+{
+	auto it = this->buffers.find(buffer);
+	return (it == this->buffers.end()) ? nullptr : &it->second;
+}
+
+GLRecorder::Buffer* GLRecorder::GetBoundBufferObject(GLenum target)
+{
+	return this->GetBuffer(this->GetBoundBuffer(target));
+}
+
+void GLRecorder::BindBuffer(GLenum target, GLuint buffer)
+{
+	this->boundBuffers[target] = buffer;
+	if (buffer != 0)
+	{
+		this->buffers.try_emplace(buffer);
+	}
+	this->AddStateChange();
+}
+
+void GLRecorder::DeleteBuffer(GLuint buffer)
+{
+	this->buffers.erase(buffer);
+	for (auto& it : this->boundBuffers)
+	{
+		if (it.second == buffer)
+		{
+			it.second = 0;
+		}
+	}
+}
+
+void GLRecorder::UseProgram(GLuint program)
+{
+	this->program = program;
+	this->AddStateChange();
+}
+
+void GLRecorder::AppendArg(std::string& str, const void* v)
+{
+	char tmp[32];
+	snprintf(tmp, sizeof(tmp), "%p", v);
+	str += tmp;
+}
+
+void GLRecorder::AppendArg(std::string& str, const char* v)
+{
+	str += (v) ? v : "null";
+}
+
+void GLRecorder::AppendArg(std::string& str, double v)
+{
+	char tmp[32];
+	snprintf(tmp, sizeof(tmp), "%g", v);
+	str += tmp;
+}
+
+void GLRecorder::AppendArg(std::string& str, int64_t v)
+{
+	str += std::to_string(v);
+}
+
+void GLRecorder::AppendArg(std::string& str, uint64_t v)
+{
+	str += std::to_string(v);
+}
+
+//=====================================================================================
+// Helpers
+//=====================================================================================
+
+static GLRecorder& Rec()
+{
+	return GLRecorder::GetInstance();
+}
+
+/// <summary>
+/// Get size of texture data in bytes
+/// (only formats used by the library)
+/// </summary>
+/// <param name="w"></param>
+/// <param name="h"></param>
+/// <param name="format"></param>
+/// <returns></returns>
+static uint64_t GetTextureBytes(GLsizei w, GLsizei h, GLenum format)
+{
+	uint64_t channels = 1;
+	if (format == GL_RGBA) channels = 4;
+	else if (format == GL_RGB) channels = 3;
+
+	return static_cast<uint64_t>(std::max(w, 0)) * static_cast<uint64_t>(std::max(h, 0)) * channels;
+}
+
+static void GenNames(GLsizei n, GLuint* names)
+{
+	for (GLsizei i = 0; i < n; i++)
+	{
+		names[i] = Rec().GenName();
+	}
+}
+
+//=====================================================================================
+// Functions
+//=====================================================================================
+
+GLenum glGetError()
+{
+	return GL_NO_ERROR;
+}
+
+void glGetIntegerv(GLenum pname, GLint* data)
+{
+	Rec().Record("glGetIntegerv", pname);
+	if (pname == GL_ARRAY_BUFFER_BINDING)
+	{
+		*data = static_cast<GLint>(Rec().GetBoundBuffer(GL_ARRAY_BUFFER));
+	}
+	else
+	{
+		*data = 0;
+	}
+}
+
+GLuint glCreateShader(GLenum type)
+{
+	Rec().Record("glCreateShader", type);
+	return Rec().GenName();
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* /*string*/, const GLint* /*length*/)
+{
+	Rec().Record("glShaderSource", shader, count);
+}
+
+void glCompileShader(GLuint shader)
+{
+	Rec().Record("glCompileShader", shader);
+}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+	Rec().Record("glGetShaderiv", shader, pname);
+	*params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	Rec().Record("glGetShaderInfoLog", shader, bufSize);
+	if (length) *length = 0;
+	if ((infoLog) && (bufSize > 0)) infoLog[0] = 0;
+}
+
+void glDeleteShader(GLuint shader)
+{
+	Rec().Record("glDeleteShader", shader);
+}
+
+GLuint glCreateProgram()
+{
+	Rec().Record("glCreateProgram");
+	return Rec().GenName();
+}
+
+void glAttachShader(GLuint program, GLuint shader)
+{
+	Rec().Record("glAttachShader", program, shader);
+}
+
+void glLinkProgram(GLuint program)
+{
+	Rec().Record("glLinkProgram", program);
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+	Rec().Record("glGetProgramiv", program, pname);
+	*params = (pname == GL_LINK_STATUS) ? GL_TRUE : 0;
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	Rec().Record("glGetProgramInfoLog", program, bufSize);
+	if (length) *length = 0;
+	if ((infoLog) && (bufSize > 0)) infoLog[0] = 0;
+}
+
+void glDeleteProgram(GLuint program)
+{
+	Rec().Record("glDeleteProgram", program);
+}
+
+void glUseProgram(GLuint program)
+{
+	Rec().Record("glUseProgram", program);
+	Rec().UseProgram(program);
+}
+
+GLint glGetAttribLocation(GLuint program, const GLchar* name)
+{
+	Rec().Record("glGetAttribLocation", program, name);
+	return Rec().GetLocation(program, name);
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name)
+{
+	Rec().Record("glGetUniformLocation", program, name);
+	return Rec().GetLocation(program, name);
+}
+
+void glUniform1f(GLint location, GLfloat v0)
+{
+	Rec().Record("glUniform1f", location, v0);
+}
+
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+	Rec().Record("glUniform2f", location, v0, v1);
+}
+
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+	Rec().Record("glUniform4f", location, v0, v1, v2, v3);
+}
+
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* /*value*/)
+{
+	Rec().Record("glUniform4fv", location, count);
+}
+
+void glProgramUniform1i(GLuint program, GLint location, GLint v0)
+{
+	Rec().Record("glProgramUniform1i", program, location, v0);
+}
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+	Rec().Record("glGenVertexArrays", n);
+	GenNames(n, arrays);
+}
+
+void glDeleteVertexArrays(GLsizei n, const GLuint* /*arrays*/)
+{
+	Rec().Record("glDeleteVertexArrays", n);
+}
+
+void glBindVertexArray(GLuint array)
+{
+	Rec().Record("glBindVertexArray", array);
+	Rec().AddStateChange();
+}
+
+void glEnableVertexAttribArray(GLuint index)
+{
+	Rec().Record("glEnableVertexAttribArray", index);
+}
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+{
+	Rec().Record("glVertexAttribPointer", index, size, type, normalized, stride, pointer);
+}
+
+void glVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer)
+{
+	Rec().Record("glVertexAttribIPointer", index, size, type, stride, pointer);
+}
+
+void glVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+	Rec().Record("glVertexAttribDivisor", index, divisor);
+}
+
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+	Rec().Record("glGenBuffers", n);
+	GenNames(n, buffers);
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	Rec().Record("glDeleteBuffers", n);
+	for (GLsizei i = 0; i < n; i++)
+	{
+		Rec().DeleteBuffer(buffers[i]);
+	}
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+	Rec().Record("glBindBuffer", target, buffer);
+	Rec().BindBuffer(target, buffer);
+}
+
+/// <summary>
+/// Reallocate buffer storage
+/// Only data passed from CPU are counted as uploaded bytes
+/// </summary>
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	Rec().Record("glBufferData", target, size, data, usage);
+
+	auto b = Rec().GetBoundBufferObject(target);
+	if (b == nullptr)
+	{
+		return;
+	}
+
+	b->data.assign(static_cast<size_t>(size), 0);
+	if (data)
+	{
+		memcpy(b->data.data(), data, static_cast<size_t>(size));
+		Rec().AddBufferBytes(static_cast<uint64_t>(size));
+	}
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	Rec().Record("glBufferSubData", target, offset, size, data);
+
+	auto b = Rec().GetBoundBufferObject(target);
+	if ((b == nullptr) || (offset < 0) || (static_cast<size_t>(offset + size) > b->data.size()))
+	{
+		return;
+	}
+
+	memcpy(b->data.data() + offset, data, static_cast<size_t>(size));
+	Rec().AddBufferBytes(static_cast<uint64_t>(size));
+}
+
+/// <summary>
+/// Map range of buffer - pointer to emulated storage is returned
+/// Bytes are counted when buffer is unmapped
+/// </summary>
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+	Rec().Record("glMapBufferRange", target, offset, length, access);
+
+	auto b = Rec().GetBoundBufferObject(target);
+	if ((b == nullptr) || (b->mapped) || (offset < 0) || (static_cast<size_t>(offset + length) > b->data.size()))
+	{
+		return nullptr;
+	}
+
+	b->mapped = true;
+	b->mapWrite = ((access & GL_MAP_WRITE_BIT) != 0);
+	b->mapOffset = static_cast<size_t>(offset);
+	b->mapLength = static_cast<size_t>(length);
+
+	return b->data.data() + offset;
+}
+
+GLboolean glUnmapBuffer(GLenum target)
+{
+	Rec().Record("glUnmapBuffer", target);
+
+	auto b = Rec().GetBoundBufferObject(target);
+	if ((b == nullptr) || (b->mapped == false))
+	{
+		return GL_FALSE;
+	}
+
+	if (b->mapWrite)
+	{
+		Rec().AddBufferBytes(b->mapLength);
+	}
+	b->mapped = false;
+
+	return GL_TRUE;
+}
+
+void glGenTextures(GLsizei n, GLuint* textures)
+{
+	Rec().Record("glGenTextures", n);
+	GenNames(n, textures);
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* /*textures*/)
+{
+	Rec().Record("glDeleteTextures", n);
+}
+
+void glActiveTexture(GLenum texture)
+{
+	Rec().Record("glActiveTexture", texture);
+	Rec().AddStateChange();
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+	Rec().Record("glBindTexture", target, texture);
+	Rec().AddStateChange();
+}
+
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+	Rec().Record("glTexParameterf", target, pname, param);
+}
+
+/// <summary>
+/// Texture content is not stored, only uploaded bytes are counted
+/// (data are also counted if they are read from pixel unpack buffer)
+/// </summary>
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+	GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	Rec().Record("glTexImage2D", target, level, internalformat, width, height, border, format, type, pixels);
+
+	if ((pixels) || (Rec().GetBoundBuffer(GL_PIXEL_UNPACK_BUFFER) != 0))
+	{
+		Rec().AddTextureBytes(GetTextureBytes(width, height, format));
+	}
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+	GLenum format, GLenum type, const void* pixels)
+{
+	Rec().Record("glTexSubImage2D", target, level, xoffset, yoffset, width, height, format, type, pixels);
+
+	Rec().AddTextureBytes(GetTextureBytes(width, height, format));
+}
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	Rec().Record("glDrawArrays", mode, first, count);
+	Rec().AddDraw();
+}
+
+void glMultiDrawArrays(GLenum mode, const GLint* /*first*/, const GLsizei* /*count*/, GLsizei drawcount)
+{
+	Rec().Record("glMultiDrawArrays", mode, drawcount);
+	Rec().AddDraw();
+}
+
+void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+{
+	Rec().Record("glDrawArraysInstanced", mode, first, count, instancecount);
+	Rec().AddDraw();
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	Rec().Record("glDrawElements", mode, count, type, indices);
+	Rec().AddDraw();
+}
+
+void glGenQueries(GLsizei n, GLuint* ids)
+{
+	Rec().Record("glGenQueries", n);
+	GenNames(n, ids);
+}
+
+void glDeleteQueries(GLsizei n, const GLuint* /*ids*/)
+{
+	Rec().Record("glDeleteQueries", n);
+}
+
+void glBeginQuery(GLenum target, GLuint id)
+{
+	Rec().Record("glBeginQuery", target, id);
+}
+
+void glEndQuery(GLenum target)
+{
+	Rec().Record("glEndQuery", target);
+}
+
+/// <summary>
+/// There is no GPU - query results are available immediately and are zero
+/// </summary>
+void glGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params)
+{
+	Rec().Record("glGetQueryObjectuiv", id, pname);
+	*params = (pname == GL_QUERY_RESULT_AVAILABLE) ? GL_TRUE : 0;
+}
+
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+{
+	Rec().Record("glGetQueryObjectui64v", id, pname);
+	*params = 0;
+}
+
+/// <summary>
+/// There is no GPU - fences are signaled immediately
+/// </summary>
+GLsync glFenceSync(GLenum condition, GLbitfield flags)
+{
+	Rec().Record("glFenceSync", condition, flags);
+	return Rec().CreateFence();
+}
+
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+	Rec().Record("glClientWaitSync", sync, flags, timeout);
+	return GL_ALREADY_SIGNALED;
+}
+
+void glDeleteSync(GLsync sync)
+{
+	Rec().Record("glDeleteSync", sync);
+}
@@ -0,0 +1,347 @@
+#ifndef GL_RECORDER_H
+#define GL_RECORDER_H
+
+//=====================================================================================
+// Recording implementation of OpenGL API used by the library
+// Used instead of OpenGL headers if USE_GL_RECORDER is defined (see Externalncludes.h)
+// No GPU or context is needed - calls are logged, objects are emulated on CPU
+// and bytes uploaded to buffers / textures are counted
+//=====================================================================================
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <unordered_map>
+
+//=====================================================================================
+// Types
+//=====================================================================================
+
+typedef unsigned int GLenum;
+typedef unsigned int GLuint;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef float GLfloat;
+typedef char GLchar;
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+typedef uint64_t GLuint64;
+typedef int64_t GLint64;
+typedef struct __GLsync* GLsync;
+
+#define GLAPIENTRY
+
+//=====================================================================================
+// Constants
+//=====================================================================================
+
+#define GL_FALSE 0
+#define GL_TRUE 1
+
+#define GL_NO_ERROR 0
+#define GL_INVALID_ENUM 0x0500
+#define GL_INVALID_VALUE 0x0501
+#define GL_INVALID_OPERATION 0x0502
+#define GL_OUT_OF_MEMORY 0x0505
+#define GL_INVALID_FRAMEBUFFER_OPERATION 0x0506
+
+#define GL_TRIANGLES 0x0004
+#define GL_TRIANGLE_STRIP 0x0005
+#define GL_TRIANGLE_FAN 0x0006
+
+#define GL_FRONT_AND_BACK 0x0408
+#define GL_LINE 0x1B01
+
+#define GL_BYTE 0x1400
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_SHORT 0x1402
+#define GL_UNSIGNED_SHORT 0x1403
+#define GL_INT 0x1404
+#define GL_UNSIGNED_INT 0x1405
+#define GL_FLOAT 0x1406
+
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_TEXTURE0 0x84C0
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_NEAREST 0x2600
+#define GL_LINEAR 0x2601
+#define GL_CLAMP_TO_EDGE 0x812F
+
+#define GL_RED 0x1903
+#define GL_ALPHA 0x1906
+#define GL_RGB 0x1907
+#define GL_RGBA 0x1908
+#define GL_LUMINANCE 0x1909
+
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_ARRAY_BUFFER_BINDING 0x8894
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+
+#define GL_STREAM_DRAW 0x88E0
+#define GL_STATIC_DRAW 0x88E4
+#define GL_DYNAMIC_DRAW 0x88E8
+
+//persistent mapping (GL_MAP_PERSISTENT_BIT) is not emulated,
+//so buffers are orphaned and filled with glBufferSubData
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_INFO_LOG_LENGTH 0x8B84
+
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+
+//=====================================================================================
+// Functions
+//=====================================================================================
+
+GLenum glGetError();
+void glGetIntegerv(GLenum pname, GLint* data);
+
+GLuint glCreateShader(GLenum type);
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+void glCompileShader(GLuint shader);
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void glDeleteShader(GLuint shader);
+
+GLuint glCreateProgram();
+void glAttachShader(GLuint program, GLuint shader);
+void glLinkProgram(GLuint program);
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params);
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void glDeleteProgram(GLuint program);
+void glUseProgram(GLuint program);
+
+GLint glGetAttribLocation(GLuint program, const GLchar* name);
+GLint glGetUniformLocation(GLuint program, const GLchar* name);
+void glUniform1f(GLint location, GLfloat v0);
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* value);
+void glProgramUniform1i(GLuint program, GLint location, GLint v0);
+#define glProgramUniform1i glProgramUniform1i
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays);
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void glBindVertexArray(GLuint array);
+void glEnableVertexAttribArray(GLuint index);
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+void glVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer);
+void glVertexAttribDivisor(GLuint index, GLuint divisor);
+
+void glGenBuffers(GLsizei n, GLuint* buffers);
+void glDeleteBuffers(GLsizei n, const GLuint* buffers);
+void glBindBuffer(GLenum target, GLuint buffer);
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+GLboolean glUnmapBuffer(GLenum target);
+
+void glGenTextures(GLsizei n, GLuint* textures);
+void glDeleteTextures(GLsizei n, const GLuint* textures);
+void glActiveTexture(GLenum texture);
+void glBindTexture(GLenum target, GLuint texture);
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param);
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, 
+	GLint border, GLenum format, GLenum type, const void* pixels);
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, 
+	GLenum format, GLenum type, const void* pixels);
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count);
+void glMultiDrawArrays(GLenum mode, const GLint* first, const GLsizei* count, GLsizei drawcount);
+void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+void glGenQueries(GLsizei n, GLuint* ids);
+void glDeleteQueries(GLsizei n, const GLuint* ids);
+void glBeginQuery(GLenum target, GLuint id);
+void glEndQuery(GLenum target);
+void glGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params);
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+
+GLsync glFenceSync(GLenum condition, GLbitfield flags);
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void glDeleteSync(GLsync sync);
+
+//=====================================================================================
+// Recorder
+//=====================================================================================
+
+/// <summary>
+/// State of recording OpenGL implementation
+/// Stats are counted per frame (see BeginFrame) and in total
+/// Must be used from one thread only (the same as "real" OpenGL context)
+/// </summary>
+class GLRecorder
+{
+public:
+
+	struct Call
+	{
+		const char* name;
+		std::string args;
+	};
+
+	struct Stats
+	{
+		uint64_t calls = 0;
+		uint64_t drawCalls = 0;
+		uint64_t stateChanges = 0; //binds of program, VAO, buffers, textures
+		uint64_t bufferBytes = 0; //glBufferData with data, glBufferSubData, written mapped ranges
+		uint64_t textureBytes = 0; //glTexImage2D with data, glTexSubImage2D
+	};
+
+	static GLRecorder& GetInstance();
+
+	void Reset();
+	void BeginFrame();
+
+	void SetLogEnabled(bool val);
+	const std::vector<Call>& GetCalls() const;
+	size_t GetCallsCount(const char* name) const;
+
+	const Stats& GetFrameStats() const;
+	const Stats& GetTotalStats() const;
+
+	GLuint GetBoundBuffer(GLenum target) const;
+	GLuint GetProgram() const;
+	const std::vector<uint8_t>* GetBufferData(GLuint buffer) const;
+	size_t GetBuffersCount() const;
+
+	//used by recorded GL functions
+	template <typename... Args>
+	void Record(const char* name, Args... args);
+
+	void AddDraw();
+	void AddStateChange();
+	void AddBufferBytes(uint64_t bytes);
+	void AddTextureBytes(uint64_t bytes);
+
+	GLuint GenName();
+	GLint GetLocation(GLuint program, const GLchar* name);
+	GLsync CreateFence();
+
+	struct Buffer
+	{
+		std::vector<uint8_t> data;
+		size_t mapOffset = 0;
+		size_t mapLength = 0;
+		bool mapped = false;
+		bool mapWrite = false;
+	};
+
+	Buffer* GetBuffer(GLuint buffer);
+	Buffer* GetBoundBufferObject(GLenum target);
+	void BindBuffer(GLenum target, GLuint buffer);
+	void DeleteBuffer(GLuint buffer);
+	void UseProgram(GLuint program);
+
+protected:
+	GLRecorder();
+
+	bool logEnabled;
+	std::vector<Call> calls;
+
+	Stats frameStats;
+	Stats totalStats;
+
+	GLuint lastName;
+	uintptr_t lastFence;
+	GLuint program;
+
+	std::unordered_map<GLuint, Buffer> buffers;
+	std::unordered_map<GLenum, GLuint> boundBuffers;
+	std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> locations;
+
+	static void AppendArg(std::string& str, const void* v);
+	static void AppendArg(std::string& str, const char* v);
+	static void AppendArg(std::string& str, double v);
+	static void AppendArg(std::string& str, int64_t v);
+	static void AppendArg(std::string& str, uint64_t v);
+
+	template <typename T>
+	static void AppendValue(std::string& str, T v);
+};
+
+/// <summary>
+/// Count call and add it to log (arguments are converted to text)
+/// </summary>
+/// <typeparam name="...Args"></typeparam>
+/// <param name="name"></param>
+/// <param name="...args"></param>
+template <typename... Args>
+void GLRecorder::Record(const char* name, Args... args)
+{
+	this->frameStats.calls++;
+	this->totalStats.calls++;
+
+	if (this->logEnabled == false)
+	{
+		return;
+	}
+
+	Call c;
+	c.name = name;
+	(AppendValue(c.args, args), ...);
+
+	this->calls.push_back(std::move(c));
+}
+
+/// <summary>
+/// Append argument to comma separated list of arguments
+/// </summary>
+/// <typeparam name="T"></typeparam>
+/// <param name="str"></param>
+/// <param name="v"></param>
+template <typename T>
+void GLRecorder::AppendValue(std::string& str, T v)
+{
+	if (str.empty() == false)
+	{
+		str += ", ";
+	}
+
+	if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+	{
+		AppendArg(str, static_cast<const char*>(v));
+	}
+	else if constexpr (std::is_pointer_v<T>)
+	{
+		AppendArg(str, static_cast<const void*>(v));
+	}
+	else if constexpr (std::is_floating_point_v<T>)
+	{
+		AppendArg(str, static_cast<double>(v));
+	}
+	else if constexpr (std::is_signed_v<T>)
+	{
+		AppendArg(str, static_cast<int64_t>(v));
+	}
+	else
+	{
+		AppendArg(str, static_cast<uint64_t>(v));
+	}
+}
+
+#endif
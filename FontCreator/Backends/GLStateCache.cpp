@@ -0,0 +1,317 @@
+#include "./GLStateCache.h"
+
+GLStateCache GLStateCache::defaultCache;
+GLStateCache* GLStateCache::current = &GLStateCache::defaultCache;
+
+GLStateCache::GLStateCache() :
+	deferredUnbind(false)
+{
+	this->Invalidate();
+}
+
+/// <summary>
+/// Get cache used by FONT_BIND_* macros
+/// </summary>
+/// <returns></returns>
+GLStateCache* GLStateCache::GetCurrent()
+{
+	return current;
+}
+
+/// <summary>
+/// Set cache shared with host application
+/// Cache must be alive while the library renders
+/// If nullptr is passed, internal default cache is used
+/// </summary>
+/// <param name="cache"></param>
+void GLStateCache::SetCurrent(GLStateCache* cache)
+{
+	current = (cache) ? cache : &defaultCache;
+}
+
+/// <summary>
+/// If enabled, FONT_UNBIND_* do nothing and objects stay bound
+/// Consecutive renderers then only bind what differs
+/// Host must not rely on zero bindings after library render
+/// (call UnbindAll before own OpenGL code, 
+/// currently bound VAO would store its element buffer binding)
+/// </summary>
+/// <param name="val"></param>
+void GLStateCache::SetDeferredUnbind(bool val)
+{
+	this->deferredUnbind = val;
+}
+
+bool GLStateCache::IsDeferredUnbind() const
+{
+	return this->deferredUnbind;
+}
+
+void GLStateCache::UseProgram(GLuint id)
+{
+	if (this->program == id)
+	{
+		this->stats.skipped++;
+		return;
+	}
+
+	GL_CHECK(glUseProgram(id));
+	this->program = id;
+	this->stats.issued++;
+}
+
+void GLStateCache::BindVertexArray(GLuint id)
+{
+	if (this->vao == id)
+	{
+		this->stats.skipped++;
+		return;
+	}
+
+	GL_CHECK(glBindVertexArray(id));
+	this->vao = id;
+	this->stats.issued++;
+}
+
+void GLStateCache::BindArrayBuffer(GLuint id)
+{
+	if (this->arrayBuffer == id)
+	{
+		this->stats.skipped++;
+		return;
+	}
+
+	GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, id));
+	this->arrayBuffer = id;
+	this->stats.issued++;
+}
+
+void GLStateCache::ActiveTexture(GLenum unit)
+{
+	if (this->activeUnit == unit)
+	{
+		this->stats.skipped++;
+		return;
+	}
+
+	GL_CHECK(glActiveTexture(unit));
+	this->activeUnit = unit;
+	this->stats.issued++;
+}
+
+/// <summary>
+/// Bind texture to active unit
+/// Units outside of MAX_TEXTURE_UNITS are not cached
+/// </summary>
+/// <param name="id"></param>
+void GLStateCache::BindTexture2D(GLuint id)
+{
+	GLuint* slot = this->GetActiveTextureSlot();
+	if ((slot != nullptr) && (*slot == id))
+	{
+		this->stats.skipped++;
+		return;
+	}
+
+	GL_CHECK(glBindTexture(GL_TEXTURE_2D, id));
+	if (slot != nullptr)
+	{
+		*slot = id;
+	}
+	this->stats.issued++;
+}
+
+void GLStateCache::UnbindProgram()
+{
+	if (this->deferredUnbind)
+	{
+		this->stats.skipped++;
+		return;
+	}
+	this->UseProgram(0);
+}
+
+void GLStateCache::UnbindVertexArray()
+{
+	if (this->deferredUnbind)
+	{
+		this->stats.skipped++;
+		return;
+	}
+	this->BindVertexArray(0);
+}
+
+void GLStateCache::UnbindArrayBuffer()
+{
+	if (this->deferredUnbind)
+	{
+		this->stats.skipped++;
+		return;
+	}
+	this->BindArrayBuffer(0);
+}
+
+void GLStateCache::UnbindTexture2D()
+{
+	if (this->deferredUnbind)
+	{
+		this->stats.skipped++;
+		return;
+	}
+	this->BindTexture2D(0);
+}
+
+/// <summary>
+/// Unbind everything tracked by cache (also with deferred unbind)
+/// Only unbinds that are not redundant are issued
+/// </summary>
+void GLStateCache::UnbindAll()
+{
+	this->UseProgram(0);
+	this->BindVertexArray(0);
+	this->BindArrayBuffer(0);
+
+	const GLenum unit = this->activeUnit;
+	for (int i = 0; i < MAX_TEXTURE_UNITS; i++)
+	{
+		if ((this->textures[i] != 0) && (this->textures[i] != UNKNOWN))
+		{
+			this->ActiveTexture(GL_TEXTURE0 + i);
+			this->BindTexture2D(0);
+		}
+	}
+
+	if (unit != UNKNOWN_UNIT)
+	{
+		this->ActiveTexture(unit);
+	}
+}
+
+/// <summary>
+/// Delete program
+/// Program in use is deleted after it is no longer used,
+/// so its binding becomes unknown
+/// </summary>
+/// <param name="id"></param>
+void GLStateCache::DeleteProgram(GLuint id)
+{
+	GL_CHECK(glDeleteProgram(id));
+
+	if (this->program == id)
+	{
+		this->program = UNKNOWN;
+	}
+}
+
+/// <summary>
+/// Delete VAO - if it was bound, binding is reverted to 0 by OpenGL
+/// (names can be reused by new objects, so cache must forget them)
+/// </summary>
+/// <param name="id"></param>
+void GLStateCache::DeleteVertexArray(GLuint id)
+{
+	GL_CHECK(glDeleteVertexArrays(1, &id));
+
+	if (this->vao == id)
+	{
+		this->vao = 0;
+	}
+}
+
+void GLStateCache::DeleteBuffer(GLuint id)
+{
+	GL_CHECK(glDeleteBuffers(1, &id));
+
+	if (this->arrayBuffer == id)
+	{
+		this->arrayBuffer = 0;
+	}
+}
+
+void GLStateCache::DeleteTexture(GLuint id)
+{
+	GL_CHECK(glDeleteTextures(1, &id));
+
+	for (GLuint& t : this->textures)
+	{
+		if (t == id)
+		{
+			t = 0;
+		}
+	}
+}
+
+/// <summary>
+/// Forget all bindings
+/// Must be called if bindings were changed without cache
+/// (eg. by host application)
+/// </summary>
+void GLStateCache::Invalidate()
+{
+	this->program = UNKNOWN;
+	this->vao = UNKNOWN;
+	this->arrayBuffer = UNKNOWN;
+	this->activeUnit = UNKNOWN_UNIT;
+
+	for (GLuint& t : this->textures)
+	{
+		t = UNKNOWN;
+	}
+}
+
+GLuint GLStateCache::GetProgram() const
+{
+	return this->program;
+}
+
+GLuint GLStateCache::GetVertexArray() const
+{
+	return this->vao;
+}
+
+GLuint GLStateCache::GetArrayBuffer() const
+{
+	return this->arrayBuffer;
+}
+
+GLenum GLStateCache::GetActiveTexture() const
+{
+	return this->activeUnit;
+}
+
+GLuint GLStateCache::GetTexture2D(GLenum unit) const
+{
+	const GLenum index = unit - GL_TEXTURE0;
+	if ((unit < GL_TEXTURE0) || (index >= MAX_TEXTURE_UNITS))
+	{
+		return UNKNOWN;
+	}
+
+	return this->textures[index];
+}
+
+const GLStateCache::Stats& GLStateCache::GetStats() const
+{
+	return this->stats;
+}
+
+void GLStateCache::ResetStats()
+{
+	this->stats = Stats();
+}
+
+GLuint* GLStateCache::GetActiveTextureSlot()
+{
+	if (this->activeUnit == UNKNOWN_UNIT)
+	{
+		return nullptr;
+	}
+
+	const GLenum index = this->activeUnit - GL_TEXTURE0;
+	if ((this->activeUnit < GL_TEXTURE0) || (index >= MAX_TEXTURE_UNITS))
+	{
+		return nullptr;
+	}
+
+	return &this->textures[index];
+}
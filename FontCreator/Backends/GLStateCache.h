@@ -0,0 +1,92 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <cstdint>
+
+#include "../Externalncludes.h"
+
+/// <summary>
+/// Tracker of OpenGL bindings used by the library
+/// If USE_GL_STATE_CACHE is defined, FONT_BIND_* / FONT_UNBIND_* macros
+/// are routed here and binds of already bound objects are skipped
+///
+/// Host application can share the cache (SetCurrent) and use it for its own binds,
+/// or call Invalidate after it changed bindings directly
+/// Must be used only from the thread with OpenGL context
+/// </summary>
+class GLStateCache
+{
+public:
+
+	/// <summary>
+	/// Number of GL calls issued and skipped by the cache
+	/// </summary>
+	struct Stats
+	{
+		uint64_t issued = 0;
+		uint64_t skipped = 0;
+	};
+
+	static const int MAX_TEXTURE_UNITS = 16;
+
+	GLStateCache();
+	~GLStateCache() = default;
+
+	static GLStateCache* GetCurrent();
+	static void SetCurrent(GLStateCache* cache);
+
+	void SetDeferredUnbind(bool val);
+	bool IsDeferredUnbind() const;
+
+	void UseProgram(GLuint id);
+	void BindVertexArray(GLuint id);
+	void BindArrayBuffer(GLuint id);
+	void ActiveTexture(GLenum unit);
+	void BindTexture2D(GLuint id);
+
+	void UnbindProgram();
+	void UnbindVertexArray();
+	void UnbindArrayBuffer();
+	void UnbindTexture2D();
+	void UnbindAll();
+
+	void DeleteProgram(GLuint id);
+	void DeleteVertexArray(GLuint id);
+	void DeleteBuffer(GLuint id);
+	void DeleteTexture(GLuint id);
+
+	void Invalidate();
+
+	GLuint GetProgram() const;
+	GLuint GetVertexArray() const;
+	GLuint GetArrayBuffer() const;
+	GLenum GetActiveTexture() const;
+	GLuint GetTexture2D(GLenum unit) const;
+
+	const Stats& GetStats() const;
+	void ResetStats();
+
+protected:
+
+	//binding is not known (eg. after Invalidate) - next bind is always issued
+	static const GLuint UNKNOWN = 0xFFFFFFFF;
+	static const GLenum UNKNOWN_UNIT = 0xFFFFFFFF;
+
+	static GLStateCache defaultCache;
+	static GLStateCache* current;
+
+	GLuint program;
+	GLuint vao;
+	GLuint arrayBuffer;
+	GLenum activeUnit;
+	GLuint textures[MAX_TEXTURE_UNITS];
+
+	//unbinds are skipped, objects stay bound until next bind
+	bool deferredUnbind;
+
+	Stats stats;
+
+	GLuint* GetActiveTextureSlot();
+};
+
+#endif
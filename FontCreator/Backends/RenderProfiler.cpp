@@ -0,0 +1,130 @@
+#include "./RenderProfiler.h"
+
+#include <algorithm>
+
+RenderProfiler::RenderProfiler() : 
+	current(0),
+	framesCount(0),
+	inFrame(false)
+{
+}
+
+/// <summary>
+/// Start of frame - backend Render()
+/// </summary>
+void RenderProfiler::BeginFrame()
+{
+	this->inFrame = true;
+	this->frameStart = Clock::now();
+
+	this->OnBeginFrame();
+}
+
+/// <summary>
+/// End of frame - stats of current slot are finished
+/// and next slot of ring is used
+/// </summary>
+void RenderProfiler::EndFrame()
+{
+	if (this->inFrame == false)
+	{
+		return;
+	}
+
+	this->inFrame = false;
+	
+	FrameStats& f = this->frames[this->current];
+	f.frame = this->framesCount;
+	f.cpuFrameMs = GetElapsedMs(this->frameStart);
+
+	this->framesCount++;
+	this->current = (this->current + 1) % FRAMES_COUNT;
+
+	this->OnFrameSlotReused(this->current);
+	this->frames[this->current] = FrameStats();
+}
+
+void RenderProfiler::BeginPass(Pass pass)
+{
+	this->passStart[static_cast<int>(pass)] = Clock::now();
+
+	this->OnBeginPass(pass);
+}
+
+/// <summary>
+/// End of pass - time is added to pass time of current frame
+/// (pass can be executed multiple times in one frame)
+/// </summary>
+/// <param name="pass"></param>
+void RenderProfiler::EndPass(Pass pass)
+{
+	this->OnEndPass(pass);
+
+	const int p = static_cast<int>(pass);
+	this->frames[this->current].cpuMs[p] += GetElapsedMs(this->passStart[p]);
+}
+
+/// <summary>
+/// Get number of finished frames in ring
+/// </summary>
+/// <returns></returns>
+size_t RenderProfiler::GetFramesCount() const
+{
+	return static_cast<size_t>(std::min<uint64_t>(this->framesCount, FRAMES_COUNT - 1));
+}
+
+/// <summary>
+/// Get stats of finished frame
+/// Must be age < GetFramesCount()
+/// </summary>
+/// <param name="age">0 - last finished frame, 1 - frame before, ...</param>
+/// <returns></returns>
+const RenderProfiler::FrameStats& RenderProfiler::GetFrameStats(size_t age) const
+{
+	int slot = (this->current - 1 - static_cast<int>(age % FRAMES_COUNT)) % FRAMES_COUNT;
+	if (slot < 0)
+	{
+		slot += FRAMES_COUNT;
+	}
+	return this->frames[slot];
+}
+
+/// <summary>
+/// Remove all stats
+/// </summary>
+void RenderProfiler::Reset()
+{
+	for (int i = 0; i < FRAMES_COUNT; i++)
+	{
+		this->OnFrameSlotReused(i);
+		this->frames[i] = FrameStats();
+	}
+	this->current = 0;
+	this->framesCount = 0;
+	this->inFrame = false;
+}
+
+double RenderProfiler::GetElapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void RenderProfiler::OnBeginFrame()
+{
+}
+
+void RenderProfiler::OnBeginPass(Pass /*pass*/)
+{
+}
+
+void RenderProfiler::OnEndPass(Pass /*pass*/)
+{
+}
+
+/// <summary>
+/// Called before frame slot is cleared and used for new frame
+/// </summary>
+/// <param name="slot"></param>
+void RenderProfiler::OnFrameSlotReused(int /*slot*/)
+{
+}
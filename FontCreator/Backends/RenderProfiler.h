@@ -0,0 +1,116 @@
+#ifndef RENDER_PROFILER_H
+#define RENDER_PROFILER_H
+
+#include <cstdint>
+#include <array>
+#include <chrono>
+
+/// <summary>
+/// Per-pass timing of backend
+/// Statistics of last FRAMES_COUNT frames are kept in ring
+/// Frame is one Render() of backend, passes executed between
+/// frames (eg. FillFontTexture called from renderer) are added to the next frame
+///
+/// Base class measures CPU time only and does not use OpenGL,
+/// GPU times are measured by RenderProfilerOpenGL
+/// </summary>
+class RenderProfiler
+{
+public:
+
+	enum class Pass : uint8_t 
+	{ 
+		BACKGROUND = 0, 
+		GLYPHS = 1, 
+		FILL_GEOMETRY = 2, 
+		FILL_TEXTURE = 3 
+	};
+
+	static const int PASS_COUNT = 4;
+	static const int FRAMES_COUNT = 16;
+
+	/// <summary>
+	/// Times of one frame in milliseconds
+	/// GPU times are valid only if gpuReady is set (results
+	/// are read without waiting, usually few frames later)
+	/// </summary>
+	struct FrameStats
+	{
+		uint64_t frame = 0;
+		double cpuFrameMs = 0.0;
+		std::array<double, PASS_COUNT> cpuMs = {};
+		std::array<double, PASS_COUNT> gpuMs = {};
+		bool gpuReady = false;
+	};
+
+	/// <summary>
+	/// Measure pass for lifetime of the scope
+	/// profiler can be nullptr (profiling disabled)
+	/// </summary>
+	class PassScope
+	{
+	public:
+		PassScope(RenderProfiler* p, Pass pass) : p(p), pass(pass) { if (p) p->BeginPass(pass); };
+		~PassScope() { if (p) p->EndPass(pass); };
+		
+		PassScope(const PassScope&) = delete;
+		PassScope& operator=(const PassScope&) = delete;
+
+	protected:
+		RenderProfiler* p;
+		Pass pass;
+	};
+
+	/// <summary>
+	/// Measure frame for lifetime of the scope
+	/// profiler can be nullptr (profiling disabled)
+	/// </summary>
+	class FrameScope
+	{
+	public:
+		FrameScope(RenderProfiler* p) : p(p) { if (p) p->BeginFrame(); };
+		~FrameScope() { if (p) p->EndFrame(); };
+
+		FrameScope(const FrameScope&) = delete;
+		FrameScope& operator=(const FrameScope&) = delete;
+
+	protected:
+		RenderProfiler* p;
+	};
+
+	RenderProfiler();
+	virtual ~RenderProfiler() = default;
+
+	void BeginFrame();
+	void EndFrame();
+
+	void BeginPass(Pass pass);
+	void EndPass(Pass pass);
+
+	size_t GetFramesCount() const;
+	const FrameStats& GetFrameStats(size_t age = 0) const;
+	
+	void Reset();
+
+protected:
+	using Clock = std::chrono::steady_clock;
+
+	std::array<FrameStats, FRAMES_COUNT> frames;
+	
+	//slot of frame that is being measured
+	int current;
+	uint64_t framesCount;
+
+	bool inFrame;
+	Clock::time_point frameStart;
+	std::array<Clock::time_point, PASS_COUNT> passStart;
+
+	static double GetElapsedMs(Clock::time_point start);
+	
+	virtual void OnBeginFrame();
+	virtual void OnBeginPass(Pass pass);
+	virtual void OnEndPass(Pass pass);
+	virtual void OnFrameSlotReused(int slot);
+};
+
+#endif
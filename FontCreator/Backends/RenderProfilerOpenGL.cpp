@@ -0,0 +1,162 @@
+#include "./RenderProfilerOpenGL.h"
+
+/// <summary>
+/// Test if GL_TIME_ELAPSED queries are available
+/// </summary>
+/// <returns></returns>
+static bool IsTimerQuerySupported()
+{
+#if defined(GL_TIME_ELAPSED) && defined(GLEW_VERSION)
+	return (glGenQueries != nullptr) && (glGetQueryObjectui64v != nullptr);
+#elif defined(GL_TIME_ELAPSED)
+	return true;
+#else
+	return false;
+#endif
+}
+
+//=============================================================================
+
+RenderProfilerOpenGL::RenderProfilerOpenGL() : 
+	RenderProfiler(),
+	gpuTiming(IsTimerQuerySupported()),
+	activePass(PASS_COUNT),
+	activeQuery(0)
+{
+}
+
+RenderProfilerOpenGL::~RenderProfilerOpenGL()
+{
+#ifdef GL_TIME_ELAPSED
+	for (auto& p : this->pending)
+	{
+		for (auto& q : p)
+		{
+			this->freeQueries.push_back(q.id);
+		}
+		p.clear();
+	}
+
+	if (this->freeQueries.empty() == false)
+	{
+		GL_CHECK(glDeleteQueries(static_cast<GLsizei>(this->freeQueries.size()), this->freeQueries.data()));
+	}
+#endif
+}
+
+bool RenderProfilerOpenGL::IsGpuTimingSupported() const
+{
+	return this->gpuTiming;
+}
+
+/// <summary>
+/// Read results of finished frames
+/// Frame GPU times are filled only when all its queries are available,
+/// queries are returned to free list
+/// </summary>
+void RenderProfilerOpenGL::PollQueries()
+{
+#ifdef GL_TIME_ELAPSED
+	for (int slot = 0; slot < FRAMES_COUNT; slot++)
+	{
+		auto& p = this->pending[slot];
+		if ((slot == this->current) || (p.empty()))
+		{
+			continue;
+		}
+
+		bool available = true;
+		for (auto& q : p)
+		{
+			GLuint res = GL_FALSE;
+			GL_CHECK(glGetQueryObjectuiv(q.id, GL_QUERY_RESULT_AVAILABLE, &res));
+			if (res == GL_FALSE)
+			{
+				available = false;
+				break;
+			}
+		}
+
+		if (available == false)
+		{
+			continue;
+		}
+
+		FrameStats& f = this->frames[slot];
+		for (auto& q : p)
+		{
+			GLuint64 ns = 0;
+			GL_CHECK(glGetQueryObjectui64v(q.id, GL_QUERY_RESULT, &ns));
+			f.gpuMs[static_cast<int>(q.pass)] += static_cast<double>(ns) / 1000000.0;
+
+			this->freeQueries.push_back(q.id);
+		}
+		f.gpuReady = true;
+
+		p.clear();
+	}
+#endif
+}
+
+void RenderProfilerOpenGL::OnBeginFrame()
+{
+	if (this->gpuTiming)
+	{
+		this->PollQueries();
+	}
+}
+
+void RenderProfilerOpenGL::OnBeginPass(Pass pass)
+{
+#ifdef GL_TIME_ELAPSED
+	if ((this->gpuTiming == false) || (this->activePass != PASS_COUNT))
+	{
+		return;
+	}
+
+	if (this->freeQueries.empty())
+	{
+		GLuint id = 0;
+		GL_CHECK(glGenQueries(1, &id));
+		this->freeQueries.push_back(id);
+	}
+
+	this->activeQuery = this->freeQueries.back();
+	this->freeQueries.pop_back();
+	this->activePass = static_cast<int>(pass);
+
+	GL_CHECK(glBeginQuery(GL_TIME_ELAPSED, this->activeQuery));
+#endif
+}
+
+void RenderProfilerOpenGL::OnEndPass(Pass pass)
+{
+#ifdef GL_TIME_ELAPSED
+	if (this->activePass != static_cast<int>(pass))
+	{
+		return;
+	}
+
+	GL_CHECK(glEndQuery(GL_TIME_ELAPSED));
+
+	this->pending[this->current].push_back({ this->activeQuery, pass });
+
+	this->activePass = PASS_COUNT;
+	this->activeQuery = 0;
+#endif
+}
+
+/// <summary>
+/// Results of slot were not read before the slot is reused
+/// (GPU is more than FRAMES_COUNT frames behind) - they are dropped
+/// Queries are not active anymore, so they can be reused
+/// </summary>
+/// <param name="slot"></param>
+void RenderProfilerOpenGL::OnFrameSlotReused(int slot)
+{
+	for (auto& q : this->pending[slot])
+	{
+		this->freeQueries.push_back(q.id);
+	}
+	this->pending[slot].clear();
+}
@@ -0,0 +1,56 @@
+#ifndef RENDER_PROFILER_OPENGL_H
+#define RENDER_PROFILER_OPENGL_H
+
+#include <vector>
+#include <array>
+
+#include "./RenderProfiler.h"
+
+#include "../Externalncludes.h"
+
+/// <summary>
+/// Profiler with GPU times measured by GL_TIME_ELAPSED queries
+/// If timer queries are not available, only CPU times are measured
+///
+/// Results are never waited for - queries of finished frames are
+/// polled at start of every frame and GPU times are filled when all
+/// queries of the frame are available
+/// Only one GL_TIME_ELAPSED query can be active, so nested passes
+/// are measured on CPU only
+/// Must be used only from the thread with OpenGL context
+/// </summary>
+class RenderProfilerOpenGL : public RenderProfiler
+{
+public:
+	RenderProfilerOpenGL();
+	virtual ~RenderProfilerOpenGL();
+
+	bool IsGpuTimingSupported() const;
+
+protected:
+
+	struct Query
+	{
+		GLuint id;
+		Pass pass;
+	};
+
+	bool gpuTiming;
+
+	//pass with active query (PASS_COUNT - no active query)
+	int activePass;
+	GLuint activeQuery;
+
+	//queries issued in frames of ring slots
+	std::array<std::vector<Query>, FRAMES_COUNT> pending;
+	std::vector<GLuint> freeQueries;
+
+	void PollQueries();
+
+	void OnBeginFrame() override;
+	void OnBeginPass(Pass pass) override;
+	void OnEndPass(Pass pass) override;
+	void OnFrameSlotReused(int slot) override;
+};
+
+#endif
@@ -2,28 +2,46 @@
 
 #include "./Shaders.h"
 
-BackgroundShaderManager::BackgroundShaderManager() :
+#include <cmath>
+#include <algorithm>
+
+BackgroundShaderManager::BackgroundShaderManager(bool sdfShape) :
 	positionLocation(-1),
 	colorLocation(-1),
 	aabbLocation(-1),
+	localLocation(-1),
+	shapeLocation(-1),
+	uvRectLocation(-1),
+	sdfShape(sdfShape),
+	sdfQuadsCount(0),
 	shape(BackgroundSettings::Shape::SQUARE),
 	roundCornerRadius(0.0f),
 	min_x(0),
 	min_y(0),
 	max_x(0),
-	max_y(0)
+	max_y(0),
+	uvRect{ 0.0f, 0.0f, 1.0f, 1.0f }
 {
+	if (this->sdfShape)
+	{
+		this->SetIndexedQuads(true);
+	}
 }
 
 
 const char* BackgroundShaderManager::GetVertexShaderSource() const
 {
-	return BACKGROUND_VERTEX_SHADER_SOURCE;
+	return (this->sdfShape) ? BACKGROUND_SDF_VERTEX_SHADER_SOURCE : BACKGROUND_VERTEX_SHADER_SOURCE;
 }
 
 const char* BackgroundShaderManager::GetPixelShaderSource() const
 {
-	return BACKGROUND_PIXEL_SHADER_SOURCE;
+	return (this->sdfShape) ? BACKGROUND_SDF_PIXEL_SHADER_SOURCE : BACKGROUND_PIXEL_SHADER_SOURCE;
+}
+
+bool BackgroundShaderManager::IsSdfShape() const
+{
+	return this->sdfShape;
 }
 
 void BackgroundShaderManager::SetShape(BackgroundSettings::Shape shape, float radius)
@@ -40,39 +58,71 @@ void BackgroundShaderManager::GetAttributtesUniforms()
 	GL_CHECK(positionLocation = glGetAttribLocation(shaderProgram, "POSITION"));
 	GL_CHECK(colorLocation = glGetAttribLocation(shaderProgram, "COLOR"));
 	GL_CHECK(aabbLocation = glGetAttribLocation(shaderProgram, "AABB"));
+
+	if (this->sdfShape)
+	{
+		GL_CHECK(localLocation = glGetAttribLocation(shaderProgram, "LOCAL"));
+		GL_CHECK(shapeLocation = glGetAttribLocation(shaderProgram, "SHAPE"));
+	}
+
+	GL_CHECK(uvRectLocation = glGetAttribLocation(shaderProgram, "UVRECT"));
 }
 
+/// <summary>
+/// Vertex: POSITION, COLOR, 
+/// LOCAL + SHAPE (SDF shape mode) or AABB (if used by shader),
+/// UVRECT (if used by shader)
+/// </summary>
 void BackgroundShaderManager::BindVertexAtribs()
 {
 	const GLsizei POSITION_SIZE = 2;
 	const GLsizei COLOR_SIZE = 4;
 	const GLsizei AABB_SIZE = 4;
-	
-	const GLsizei VERTEX_SIZE = (aabbLocation != -1) ? 
-		(POSITION_SIZE + COLOR_SIZE + AABB_SIZE) * sizeof(float) : 
-		(POSITION_SIZE + COLOR_SIZE) * sizeof(float);
+	const GLsizei LOCAL_SIZE = 2;
+	const GLsizei SHAPE_SIZE = 3;
+	const GLsizei UV_RECT_SIZE = 4;
 
-	const size_t POSITION_OFFSET = 0;	
-	const size_t COLOR_OFFSET = POSITION_OFFSET + POSITION_SIZE * sizeof(float);
+	GLsizei vertexSize = POSITION_SIZE + COLOR_SIZE;
+	if (this->sdfShape)
+	{
+		vertexSize += LOCAL_SIZE + SHAPE_SIZE;
+	}
+	else if (aabbLocation != -1)
+	{
+		vertexSize += AABB_SIZE;
+	}
+	if (uvRectLocation != -1)
+	{
+		vertexSize += UV_RECT_SIZE;
+	}
+
+	const GLsizei VERTEX_SIZE = vertexSize * sizeof(float);
+	size_t offset = 0;
 
-	GL_CHECK(glEnableVertexAttribArray(positionLocation));
-	GL_CHECK(glVertexAttribPointer(positionLocation, POSITION_SIZE,
-		GL_FLOAT, GL_FALSE,
-		VERTEX_SIZE, (void*)(POSITION_OFFSET)));
+	auto bindAttrib = [&](GLint location, GLsizei size) {
+		GL_CHECK(glEnableVertexAttribArray(location));
+		GL_CHECK(glVertexAttribPointer(location, size,
+			GL_FLOAT, GL_FALSE,
+			VERTEX_SIZE, (void*)(offset)));
+		offset += size * sizeof(float);
+	};
 
-	GL_CHECK(glEnableVertexAttribArray(colorLocation));
-	GL_CHECK(glVertexAttribPointer(colorLocation, COLOR_SIZE,
-		GL_FLOAT, GL_FALSE,
-		VERTEX_SIZE, (void*)(COLOR_OFFSET)));
+	bindAttrib(positionLocation, POSITION_SIZE);
+	bindAttrib(colorLocation, COLOR_SIZE);
 
-	if (aabbLocation != -1)
+	if (this->sdfShape)
+	{
+		bindAttrib(localLocation, LOCAL_SIZE);
+		bindAttrib(shapeLocation, SHAPE_SIZE);
+	}
+	else if (aabbLocation != -1)
 	{
-		const size_t AABB_OFFSET = COLOR_OFFSET + COLOR_SIZE * sizeof(float);
+		bindAttrib(aabbLocation, AABB_SIZE);
+	}
 
-		GL_CHECK(glEnableVertexAttribArray(aabbLocation));
-		GL_CHECK(glVertexAttribPointer(aabbLocation, AABB_SIZE,
-			GL_FLOAT, GL_FALSE,
-			VERTEX_SIZE, (void*)(AABB_OFFSET)));
+	if (uvRectLocation != -1)
+	{
+		bindAttrib(uvRectLocation, UV_RECT_SIZE);
 	}
 }
 
@@ -84,6 +134,7 @@ void BackgroundShaderManager::Clear()
 {
 	this->startingElements.clear();
 	this->counts.clear();
+	this->sdfQuadsCount = 0;
 }
 
 void BackgroundShaderManager::PreRender()
@@ -93,7 +144,27 @@ void BackgroundShaderManager::PreRender()
 
 void BackgroundShaderManager::Render(int quadsCount)
 {
-	auto type = (shape == BackgroundSettings::Shape::SQUARE) ? GL_TRIANGLES : GL_TRIANGLE_FAN;
+	if (this->sdfShape)
+	{
+		//one quad per background - single draw call
+		//quadsCount contains also groups without background color
+		IShaderManager::Render(this->sdfQuadsCount);
+		return;
+	}
+
+	if (counts.empty())
+	{
+		return;
+	}
+
+	if (shape == BackgroundSettings::Shape::SQUARE)
+	{
+		//squares are independent triangles - single draw call
+		GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, startingElements.back() + counts.back()));
+		return;
+	}
+
+	auto type = GL_TRIANGLE_FAN;
 	
 #if (defined(__APPLE__) || defined(__ANDROID_API__))
 	for (int i = 0; i < counts.size(); ++i)
@@ -107,6 +178,11 @@ void BackgroundShaderManager::Render(int quadsCount)
 
 int BackgroundShaderManager::GetQuadVertices() const
 {
+	if (this->sdfShape)
+	{
+		return (this->indexedQuads) ? 4 : 6;
+	}
+
 	return (shape == BackgroundSettings::Shape::SQUARE) ? 6 : 38;
 }
 
@@ -122,6 +198,12 @@ void BackgroundShaderManager::FillQuadVertexData(
 		return;
 	}
 
+	if (this->sdfShape)
+	{
+		this->FillSdfShapeQuad(minVertex, maxVertex, rp, vec);
+		return;
+	}
+
 	//if (vec.size() > 0) return;
 	const float minX = 2.0f * minVertex.x - 1.0f;
 	const float minY = -(2.0f * minVertex.y - 1.0f);
@@ -335,4 +417,115 @@ void BackgroundShaderManager::AddVertex(float x, float y, const AbstractRenderer
 		vec.push_back(min_x); vec.push_back(min_y);
 		vec.push_back(max_x); vec.push_back(max_y);
 	}
+
+	if (this->uvRectLocation != -1)
+	{
+		vec.push_back(uvRect[0]); vec.push_back(uvRect[1]);
+		vec.push_back(uvRect[2]); vec.push_back(uvRect[3]);
+	}
+}
+
+/// <summary>
+/// Calculate quad and shape of background for SDF shape mode
+/// Shape size and radius are in pixels, quad has extra pixel
+/// for anti-aliasing of edges
+/// </summary>
+/// <param name="shape"></param>
+/// <param name="radius">corner radius or circle radius (auto-calculated if <= 0)</param>
+/// <param name="canvasW"></param>
+/// <param name="canvasH"></param>
+/// <param name="minVertex">[0, 1] space</param>
+/// <param name="maxVertex">[0, 1] space</param>
+/// <param name="scale"></param>
+/// <param name="extraSize">extra size of quad around shape in pixels (eg. for shadow)</param>
+/// <returns></returns>
+BackgroundShaderManager::SdfShapeQuad BackgroundShaderManager::CalcSdfShapeQuad(BackgroundSettings::Shape shape, 
+	float radius, float canvasW, float canvasH,
+	const AbstractRenderer::Vertex& minVertex,
+	const AbstractRenderer::Vertex& maxVertex,
+	float scale, float extraSize)
+{
+	const float AA_SIZE = 1.0f;
+
+	SdfShapeQuad q;
+
+	const float cx = 0.5f * (minVertex.x + maxVertex.x);
+	const float cy = 0.5f * (minVertex.y + maxVertex.y);
+
+	q.halfW = 0.5f * std::abs(maxVertex.x - minVertex.x) * canvasW;
+	q.halfH = 0.5f * std::abs(maxVertex.y - minVertex.y) * canvasH;
+	q.radius = 0.0f;
+
+	if (shape == BackgroundSettings::Shape::ROUNDED_CORNER_SQUARE)
+	{
+		q.radius = std::min(radius * scale, std::min(q.halfW, q.halfH));
+	}
+	else if (shape == BackgroundSettings::Shape::CIRCLE)
+	{
+		q.radius = (radius > 0) ? radius * scale : std::max(q.halfW, q.halfH);
+		q.halfW = q.radius;
+		q.halfH = q.radius;
+	}
+
+	q.extX = q.halfW + AA_SIZE + extraSize;
+	q.extY = q.halfH + AA_SIZE + extraSize;
+
+	const float ex = q.extX / canvasW;
+	const float ey = q.extY / canvasH;
+
+	q.minX = 2.0f * (cx - ex) - 1.0f;
+	q.minY = -(2.0f * (cy - ey) - 1.0f);
+
+	q.maxX = 2.0f * (cx + ex) - 1.0f;
+	q.maxY = -(2.0f * (cy + ey) - 1.0f);
+
+	return q;
+}
+
+/// <summary>
+/// Add background as one quad, shape is evaluated in pixel shader
+/// </summary>
+/// <param name="minVertex"></param>
+/// <param name="maxVertex"></param>
+/// <param name="rp"></param>
+/// <param name="vec"></param>
+void BackgroundShaderManager::FillSdfShapeQuad(const AbstractRenderer::Vertex& minVertex,
+	const AbstractRenderer::Vertex& maxVertex,
+	const AbstractRenderer::RenderParams& rp, std::vector<float>& vec)
+{
+	const SdfShapeQuad q = CalcSdfShapeQuad(this->shape, this->roundCornerRadius,
+		this->canvasW, this->canvasH, minVertex, maxVertex, rp.scale);
+
+	this->sdfQuadsCount++;
+
+	this->AddSdfVertex(q.minX, q.minY, -q.extX, -q.extY, q, rp, vec);
+	this->AddSdfVertex(q.maxX, q.minY, q.extX, -q.extY, q, rp, vec);
+	this->AddSdfVertex(q.minX, q.maxY, -q.extX, q.extY, q, rp, vec);
+
+	if (this->indexedQuads)
+	{
+		//triangles (a, b, d), (b, c, d) are in index buffer
+		this->AddSdfVertex(q.maxX, q.maxY, q.extX, q.extY, q, rp, vec);
+		return;
+	}
+
+	this->AddSdfVertex(q.maxX, q.minY, q.extX, -q.extY, q, rp, vec);
+	this->AddSdfVertex(q.maxX, q.maxY, q.extX, q.extY, q, rp, vec);
+	this->AddSdfVertex(q.minX, q.maxY, -q.extX, q.extY, q, rp, vec);
+}
+
+void BackgroundShaderManager::AddSdfVertex(float x, float y, float lx, float ly, const SdfShapeQuad& q,
+	const AbstractRenderer::RenderParams& rp, std::vector<float>& vec) const
+{
+	vec.push_back(x); vec.push_back(y);
+	vec.push_back(rp.bgColor->r); vec.push_back(rp.bgColor->g);
+	vec.push_back(rp.bgColor->b); vec.push_back(rp.bgColor->a);
+	vec.push_back(lx); vec.push_back(ly);
+	vec.push_back(q.halfW); vec.push_back(q.halfH); vec.push_back(q.radius);
+
+	if (this->uvRectLocation != -1)
+	{
+		vec.push_back(uvRect[0]); vec.push_back(uvRect[1]);
+		vec.push_back(uvRect[2]); vec.push_back(uvRect[3]);
+	}
 }
@@ -8,10 +8,33 @@
 
 #include "./IShaderManager.h"
 
+/// <summary>
+/// Shader manager for backgrounds with color per background
+/// 
+/// Default mode builds shapes on CPU (rounded corners and circles
+/// are triangle fans with 38 vertices) and renders them with multi draw.
+/// In SDF shape mode, every background is one quad and the shape is evaluated 
+/// in pixel shader from signed distance - all backgrounds are rendered with one draw call.
+/// </summary>
 class BackgroundShaderManager : public IShaderManager
 {
 public:
-    BackgroundShaderManager();
+
+    /// <summary>
+    /// Quad of background in SDF shape mode
+    /// Quad is in projection space, shape in pixels
+    /// </summary>
+    struct SdfShapeQuad
+    {
+        float minX, minY;
+        float maxX, maxY;
+
+        float extX, extY; //half size of quad
+        float halfW, halfH; //half size of shape
+        float radius;
+    };
+
+    BackgroundShaderManager(bool sdfShape = false);
     virtual ~BackgroundShaderManager() = default;
 
     virtual const char* GetVertexShaderSource() const override;
@@ -22,6 +45,7 @@ public:
     void BindUniforms() override;
    
     void SetShape(BackgroundSettings::Shape shape, float radius = 0.0f);
+    bool IsSdfShape() const;
 
     int GetQuadVertices() const override;
 
@@ -36,11 +60,22 @@ public:
 
     virtual void Render(int quadsCount) override;
 
+    static SdfShapeQuad CalcSdfShapeQuad(BackgroundSettings::Shape shape, float radius,
+        float canvasW, float canvasH,
+        const AbstractRenderer::Vertex& minVertex,
+        const AbstractRenderer::Vertex& maxVertex,
+        float scale, float extraSize = 0.0f);
+
 protected:
     GLint positionLocation;
     GLint colorLocation;
     GLint aabbLocation;
+    GLint localLocation;
+    GLint shapeLocation;
+    GLint uvRectLocation;
     
+    bool sdfShape;
+    int sdfQuadsCount;
     
     BackgroundSettings::Shape shape;
     float roundCornerRadius;
@@ -50,6 +85,9 @@ protected:
     float max_x;
     float max_y;
 
+    //texture rect (u0, v0, u1, v1) of current background (if UVRECT is used)
+    float uvRect[4];
+
     std::vector<GLint> startingElements;
     std::vector<GLint> counts;
 
@@ -59,7 +97,13 @@ protected:
     void FillCircle(float cx, float cy, float rx, float ry, 
         const AbstractRenderer::RenderParams& rp, std::vector<float>& vec) const;
 
+    void FillSdfShapeQuad(const AbstractRenderer::Vertex& minVertex,
+        const AbstractRenderer::Vertex& maxVertex,
+        const AbstractRenderer::RenderParams& rp, std::vector<float>& vec);
+
     void AddVertex(float x, float y, const AbstractRenderer::RenderParams& rp, std::vector<float>& vec) const;
+    void AddSdfVertex(float x, float y, float lx, float ly, const SdfShapeQuad& q,
+        const AbstractRenderer::RenderParams& rp, std::vector<float>& vec) const;
 };
 
 
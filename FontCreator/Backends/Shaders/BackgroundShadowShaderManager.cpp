@@ -1,27 +1,28 @@
 #include "./BackgroundShadowShaderManager.h"
 
+#include <cmath>
+#include <algorithm>
+
 #include "./Shaders.h"
+#include "./BackgroundShaderManager.h"
 
 BackgroundShadowShaderManager::BackgroundShadowShaderManager(Shadow shadow) :
-	shadow(shadow),
 	positionLocation(-1),
 	colorLocation(-1),
-	aabbLocation(-1),
-	cornerRadiusUniform(-1),
-	blurRadiusUniform(-1),
+	localLocation(-1),
+	shapeLocation(-1),
+	sigmaUniform(-1),
 	shadowDirUniform(-1),
 	shadowColorUniform(-1),
+	shadow(shadow),
 	shape(BackgroundSettings::Shape::SQUARE),
 	roundCornerRadius(0.0f),
 	r(1.0f),
 	g(1.0f),
 	b(1.0f),
-	a(1.0f),
-	min_x(0),
-	min_y(0),
-	max_x(0),
-	max_y(0)
+	a(1.0f)
 {
+	this->SetIndexedQuads(true);
 }
 
 
@@ -54,31 +55,30 @@ void BackgroundShadowShaderManager::SetColor(float r, float g, float b, float a)
 /// </summary>
 void BackgroundShadowShaderManager::GetAttributtesUniforms()
 {
-	GL_CHECK(cornerRadiusUniform = glGetUniformLocation(shaderProgram, "cornerRadius"));
-	GL_CHECK(blurRadiusUniform = glGetUniformLocation(shaderProgram, "blurRadius"));
-	GL_CHECK(shadowPaddingSizeUniform = glGetUniformLocation(shaderProgram, "shadowPaddingSize"));
+	GL_CHECK(sigmaUniform = glGetUniformLocation(shaderProgram, "sigma"));
 	GL_CHECK(shadowDirUniform = glGetUniformLocation(shaderProgram, "shadowDir"));
 	GL_CHECK(shadowColorUniform = glGetUniformLocation(shaderProgram, "shadowColor"));
 
 
 	GL_CHECK(positionLocation = glGetAttribLocation(shaderProgram, "POSITION"));
 	GL_CHECK(colorLocation = glGetAttribLocation(shaderProgram, "COLOR"));
-	GL_CHECK(aabbLocation = glGetAttribLocation(shaderProgram, "AABB"));
-
+	GL_CHECK(localLocation = glGetAttribLocation(shaderProgram, "LOCAL"));
+	GL_CHECK(shapeLocation = glGetAttribLocation(shaderProgram, "SHAPE"));
 }
 
 void BackgroundShadowShaderManager::BindVertexAtribs()
 {
 	const GLsizei POSITION_SIZE = 2;
 	const GLsizei COLOR_SIZE = 4;
-	const GLsizei AABB_SIZE = 4;
+	const GLsizei LOCAL_SIZE = 2;
+	const GLsizei SHAPE_SIZE = 3;
 
-	const GLsizei VERTEX_SIZE = (aabbLocation != -1) ?
-		(POSITION_SIZE + COLOR_SIZE + AABB_SIZE) * sizeof(float) :
-		(POSITION_SIZE + COLOR_SIZE) * sizeof(float);
+	const GLsizei VERTEX_SIZE = (POSITION_SIZE + COLOR_SIZE + LOCAL_SIZE + SHAPE_SIZE) * sizeof(float);
 
 	const size_t POSITION_OFFSET = 0;
 	const size_t COLOR_OFFSET = POSITION_OFFSET + POSITION_SIZE * sizeof(float);
+	const size_t LOCAL_OFFSET = COLOR_OFFSET + COLOR_SIZE * sizeof(float);
+	const size_t SHAPE_OFFSET = LOCAL_OFFSET + LOCAL_SIZE * sizeof(float);
 
 	GL_CHECK(glEnableVertexAttribArray(positionLocation));
 	GL_CHECK(glVertexAttribPointer(positionLocation, POSITION_SIZE,
@@ -90,50 +90,22 @@ void BackgroundShadowShaderManager::BindVertexAtribs()
 		GL_FLOAT, GL_FALSE,
 		VERTEX_SIZE, (void*)(COLOR_OFFSET)));
 
-	if (aabbLocation != -1)
-	{
-		const size_t AABB_OFFSET = COLOR_OFFSET + COLOR_SIZE * sizeof(float);
+	GL_CHECK(glEnableVertexAttribArray(localLocation));
+	GL_CHECK(glVertexAttribPointer(localLocation, LOCAL_SIZE,
+		GL_FLOAT, GL_FALSE,
+		VERTEX_SIZE, (void*)(LOCAL_OFFSET)));
 
-		GL_CHECK(glEnableVertexAttribArray(aabbLocation));
-		GL_CHECK(glVertexAttribPointer(aabbLocation, AABB_SIZE,
-			GL_FLOAT, GL_FALSE,
-			VERTEX_SIZE, (void*)(AABB_OFFSET)));
-	}
+	GL_CHECK(glEnableVertexAttribArray(shapeLocation));
+	GL_CHECK(glVertexAttribPointer(shapeLocation, SHAPE_SIZE,
+		GL_FLOAT, GL_FALSE,
+		VERTEX_SIZE, (void*)(SHAPE_OFFSET)));
 }
 
 void BackgroundShadowShaderManager::BindUniforms()
 {
-	//We are sending same value to shadowPaddingSizeUniform
-	//bacse in shader, geometry is treated as square - its mapped
-	//to 0-1 inetreval in both axes
-
-	float pxBoxWidth = ((max_x - min_x) * this->canvasW);
-
-	if (this->shape == BackgroundSettings::Shape::SQUARE)
-	{
-		GL_CHECK(glUniform1f(cornerRadiusUniform, 0.0f));
-
-		float tmp = (1.0f - this->shadow.shadowPaddingSize) * 0.5f;		
-		GL_CHECK(glUniform2f(shadowPaddingSizeUniform, tmp, tmp));			
-	}
-	else if (this->shape == BackgroundSettings::Shape::CIRCLE)
-	{
-		float tmp = (1.0f - this->shadow.shadowPaddingSize) * 0.5f;
-
-		GL_CHECK(glUniform1f(cornerRadiusUniform, tmp));		
-		GL_CHECK(glUniform2f(shadowPaddingSizeUniform, tmp, tmp));			
-	}
-	else if (this->shape == BackgroundSettings::Shape::ROUNDED_CORNER_SQUARE)
-	{
-		float cornerRadius = this->roundCornerRadius / pxBoxWidth;
-		GL_CHECK(glUniform1f(cornerRadiusUniform, cornerRadius));
-
-		float tmp = (1.0f - this->shadow.shadowPaddingSize) * 0.5f;		
-		GL_CHECK(glUniform2f(shadowPaddingSizeUniform, tmp, tmp));		
-	}
-
-	float blurRadius = this->shadow.blurRadius / pxBoxWidth;
-	GL_CHECK(glUniform1f(blurRadiusUniform, blurRadius));
+	//blur radius is 2 sigma, sigma must not be 0 (division in shader)
+	const float sigma = std::max(0.5f * this->shadow.blurRadius, 0.01f);
+	GL_CHECK(glUniform1f(sigmaUniform, sigma));
 
 	//Y is considered up
 	GL_CHECK(glUniform2f(shadowDirUniform, this->shadow.dirX, this->shadow.dirY));
@@ -143,135 +115,64 @@ void BackgroundShadowShaderManager::BindUniforms()
 
 }
 
-void BackgroundShadowShaderManager::Clear()
-{
-	this->startingElements.clear();
-	this->counts.clear();
-}
-
 void BackgroundShadowShaderManager::PreRender()
 {
 
 }
 
-void BackgroundShadowShaderManager::Render(int quadsCount)
-{
-	auto type = GL_TRIANGLES;
-
-#if (defined(__APPLE__) || defined(__ANDROID_API__))
-	for (int i = 0; i < counts.size(); ++i)
-	{
-		GL_CHECK(glDrawArrays(type, startingElements[i], counts[i]));
-	}
-#else
-	GL_CHECK(glMultiDrawArrays(type, startingElements.data(), counts.data(), (GLsizei)counts.size()));
-#endif
-}
-
 int BackgroundShadowShaderManager::GetQuadVertices() const
 {
-	return 6;
+	return (this->indexedQuads) ? 4 : 6;
 }
 
-
+/// <summary>
+/// Add one quad with background and its shadow
+/// Quad is enlarged by shadow offset and 3 sigma of blur
+/// </summary>
+/// <param name="minVertex"></param>
+/// <param name="maxVertex"></param>
+/// <param name="rp"></param>
+/// <param name="vec"></param>
 void BackgroundShadowShaderManager::FillQuadVertexData(
 	const AbstractRenderer::Vertex& minVertex,
 	const AbstractRenderer::Vertex& maxVertex,
 	const AbstractRenderer::RenderParams& rp,
 	std::vector<float>& vec)
 {		
-	//if (vec.size() > 0) return;
-	float minX = 2.0f * (minVertex.x) - 1.0f;
-	float minY = -(2.0f * (minVertex.y ) - 1.0f);
+	//shape without shadow - only to get its size
+	auto q = BackgroundShaderManager::CalcSdfShapeQuad(this->shape, this->roundCornerRadius,
+		this->canvasW, this->canvasH, minVertex, maxVertex, rp.scale);
 
-	float maxX = 2.0f * (maxVertex.x) - 1.0f;
-	float maxY = -(2.0f * (maxVertex.y) - 1.0f);
-
-	if (shape == BackgroundSettings::Shape::CIRCLE)
-	{
-		const float cx = minX + 0.5f * (maxX - minX);
-		const float cy = minY + 0.5f * (maxY - minY);
-
-		float rx, ry;
-
-		//2 * - projection space is [-1, 1] and we calculate for 0, 1
-		if (this->roundCornerRadius > 0)
-		{
-			rx = this->roundCornerRadius * 2.0f * rp.scale * (1.0f / this->canvasW);
-			ry = this->roundCornerRadius * 2.0f * rp.scale * (1.0f / this->canvasH);
-		}
-		else
-		{
-			const float w = std::abs(maxX - minX);
-			const float h = std::abs(maxY - minY);
-
-
-			// circle fitting inside given rect in screen pixels
-			const float rPx = 0.5f * std::max(
-				w * 0.5f * this->canvasW,
-				h * 0.5f * this->canvasH
-			);
-
-			rx = 2.0f * rPx / this->canvasW;
-			ry = 2.0f * rPx / this->canvasH;
-		}
-
-		//swap Y in circle, we want Y to face upwards
-		minX = cx - rx;
-		minY = cy + ry;
-
-		maxX = cx + rx;
-		maxY = cy - ry;
-	}
-
-	float padW = rp.scale * (maxX - minX) * this->shadow.shadowPaddingSize;
-	float padH = rp.scale * (maxY - minY) * this->shadow.shadowPaddingSize;
-	
-	minX -= padW;
-	minY -= padH;
-	maxX += padW;
-	maxY += padH;
+	const float offset = 2.0f * std::max(
+		std::abs(this->shadow.dirX) * q.halfW,
+		std::abs(this->shadow.dirY) * q.halfH);
 	
-	min_x = minX;
-	min_y = minY;
-	max_x = maxX;
-	max_y = maxY;
-
-	this->AddVertex(minX, minY, rp, vec);
-	this->AddVertex(maxX, minY, rp, vec);
-	this->AddVertex(minX, maxY, rp, vec);
+	const float blur = 1.5f * std::abs(this->shadow.blurRadius); //3 sigma
 
-	//========================================================
-	//========================================================
-
-	this->AddVertex(maxX, minY, rp, vec);
-	this->AddVertex(maxX, maxY, rp, vec);
-	this->AddVertex(minX, maxY, rp, vec);
-	
-	/*
-	v[0] = a;
-	v[1] = b;
-	v[2] = d;
-	
-	v[3] = b;
-	v[4] = c;
-	v[5] = d;
-	*/
+	q = BackgroundShaderManager::CalcSdfShapeQuad(this->shape, this->roundCornerRadius,
+		this->canvasW, this->canvasH, minVertex, maxVertex, rp.scale, offset + blur);
 
+	//LOCAL has Y up (top of the quad is maxY in projection space)
+	this->AddVertex(q.minX, q.minY, -q.extX, q.extY, q.halfW, q.halfH, q.radius, rp, vec);
+	this->AddVertex(q.maxX, q.minY, q.extX, q.extY, q.halfW, q.halfH, q.radius, rp, vec);
+	this->AddVertex(q.minX, q.maxY, -q.extX, -q.extY, q.halfW, q.halfH, q.radius, rp, vec);
 
-	counts.push_back(this->GetQuadVertices());
-	if (startingElements.size() == 0)
+	if (this->indexedQuads)
 	{
-		startingElements.push_back(0);
-	}
-	else
-	{
-		startingElements.push_back(startingElements.back() + this->GetQuadVertices());
+		//triangles (a, b, d), (b, c, d) are in index buffer
+		this->AddVertex(q.maxX, q.maxY, q.extX, -q.extY, q.halfW, q.halfH, q.radius, rp, vec);
+		return;
 	}
+
+	this->AddVertex(q.maxX, q.minY, q.extX, q.extY, q.halfW, q.halfH, q.radius, rp, vec);
+	this->AddVertex(q.maxX, q.maxY, q.extX, -q.extY, q.halfW, q.halfH, q.radius, rp, vec);
+	this->AddVertex(q.minX, q.maxY, -q.extX, -q.extY, q.halfW, q.halfH, q.radius, rp, vec);
 }
 
 
-void BackgroundShadowShaderManager::AddVertex(float x, float y, const AbstractRenderer::RenderParams& rp,
+void BackgroundShadowShaderManager::AddVertex(float x, float y, float lx, float ly,
+	float halfW, float halfH, float radius,
+	const AbstractRenderer::RenderParams& rp,
 	std::vector<float>& vec) const
 {
 	vec.push_back(x); vec.push_back(y);
@@ -286,6 +187,6 @@ void BackgroundShadowShaderManager::AddVertex(float x, float y, const AbstractRe
 		vec.push_back(b); vec.push_back(a);
 	}
 
-	vec.push_back(min_x); vec.push_back(min_y);
-	vec.push_back(max_x); vec.push_back(max_y);	
-}
\ No newline at end of file
+	vec.push_back(lx); vec.push_back(ly);
+	vec.push_back(halfW); vec.push_back(halfH); vec.push_back(radius);
+}
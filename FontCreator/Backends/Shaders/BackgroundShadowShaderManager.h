@@ -8,6 +8,12 @@
 
 #include "./IShaderManager.h"
 
+/// <summary>
+/// Shader manager for backgrounds with drop shadow
+/// Every background is one quad large enough for its shadow.
+/// Fill and Gaussian shadow of rounded box are evaluated analytically 
+/// in pixel shader, all backgrounds are rendered with one draw call
+/// </summary>
 class BackgroundShadowShaderManager : public IShaderManager
 {
 public:
@@ -31,42 +37,28 @@ public:
         const AbstractRenderer::RenderParams& rp,
         std::vector<float>& vec) override;
 
-    void Clear() override;
-
     void PreRender() override;
 
-    void Render(int quadsCount) override;
-
 protected:
     GLint positionLocation;
     GLint colorLocation;
-    GLint aabbLocation;
+    GLint localLocation;
+    GLint shapeLocation;
 
-    GLint cornerRadiusUniform;
-    GLint blurRadiusUniform;
+    GLint sigmaUniform;
     GLint shadowDirUniform;
-    GLint shadowPaddingSizeUniform;
     GLint shadowColorUniform;
 
     Shadow shadow;
 
-    float xx, yy;
-
     BackgroundSettings::Shape shape;
     float roundCornerRadius;
     
     float r, g, b, a;    
 
-    float min_x;
-    float min_y;
-    float max_x;
-    float max_y;
-
-    std::vector<GLint> startingElements;
-    std::vector<GLint> counts;
-
-   
-    void AddVertex(float x, float y, const AbstractRenderer::RenderParams& rp, std::vector<float>& vec) const;
+    void AddVertex(float x, float y, float lx, float ly, 
+        float halfW, float halfH, float radius,
+        const AbstractRenderer::RenderParams& rp, std::vector<float>& vec) const;
 };
 
 
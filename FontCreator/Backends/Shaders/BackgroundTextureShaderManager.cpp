@@ -1,44 +1,43 @@
 #include "./BackgroundTextureShaderManager.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "./Shaders.h"
 
 #include "../../Externalncludes.h"
 
-BackgroundTextureShaderManager::BackgroundTextureShaderManager() :
-    BackgroundShaderManager(),
+BackgroundTextureShaderManager::BackgroundTextureShaderManager(bool sdfShape, int atlasSize) :
+    BackgroundShaderManager(sdfShape),
     r(1),
     g(1),
     b(1),
     a(1),
-    bgTextureUniform(-1)
+    bgTextureUniform(-1),
+    atlasSize(atlasSize),
+    atlasTexture(0),
+    shelvesEnd(0),
+    emptyImage(0)
 {
-    std::vector<uint8_t> dummy = { 255, 255, 255, 255 };
-    emptyTextureId = this->InitTexture(dummy, 1, 1, 4);
+    this->InitAtlas();
 
+    std::vector<uint8_t> dummy = { 255, 255, 255, 255 };
+    this->emptyImage = this->AddImage(dummy, 1, 1).value_or(0);
 }
 
 BackgroundTextureShaderManager::~BackgroundTextureShaderManager()
 {    
-    for (auto& texId : this->usedTextures)
-    {
-        if (texId == emptyTextureId)
-        {
-            continue;
-        }
-        GL_CHECK(glDeleteTextures(1, &texId));
-    }
-
-    GL_CHECK(glDeleteTextures(1, &this->emptyTextureId));
+    FONT_DELETE_TEXTURE(this->atlasTexture);
 }
 
 const char* BackgroundTextureShaderManager::GetVertexShaderSource() const
 {
-    return TEXTURE_BACKGROUND_VERTEX_SHADER_SOURCE;
+    return (this->sdfShape) ? TEXTURE_BACKGROUND_SDF_VERTEX_SHADER_SOURCE : TEXTURE_BACKGROUND_VERTEX_SHADER_SOURCE;
 }
 
 const char* BackgroundTextureShaderManager::GetPixelShaderSource() const
 {
-    return TEXTURE_BACKGROUND_PIXEL_SHADER_SOURCE;
+    return (this->sdfShape) ? TEXTURE_BACKGROUND_SDF_PIXEL_SHADER_SOURCE : TEXTURE_BACKGROUND_PIXEL_SHADER_SOURCE;
 }
 
 void BackgroundTextureShaderManager::SetBaseColor(float r, float g, float b, float a)
@@ -60,33 +59,16 @@ void BackgroundTextureShaderManager::GetAttributtesUniforms()
     
 }
 
-void BackgroundTextureShaderManager::Clear()
-{
-    BackgroundShaderManager::Clear();
-    
-    this->usedTextures.clear();
-}
-
+/// <summary>
+/// Render all backgrounds - only atlas texture is used
+/// </summary>
+/// <param name="quadsCount"></param>
 void BackgroundTextureShaderManager::Render(int quadsCount)
 {
-    auto type = (shape == BackgroundSettings::Shape::SQUARE) ? GL_TRIANGLES : GL_TRIANGLE_FAN;
-    
-    GL_CHECK(glActiveTexture(GL_TEXTURE0));
-    
-    GLuint lastTexId = std::numeric_limits<GLuint>::max();
-    
-    for (size_t i = 0; i < counts.size(); i++)
-    {
-        GLuint texId = this->usedTextures[i];
-        if (texId != lastTexId)
-        {
-            FONT_BIND_TEXTURE_2D(texId);
-        }
-        lastTexId = texId;
-        
-        GL_CHECK(glDrawArrays(type, startingElements[i], counts[i]));
-    }
+    FONT_ACTIVE_TEXTURE(GL_TEXTURE0);
+    FONT_BIND_TEXTURE_2D(this->atlasTexture);
     
+    BackgroundShaderManager::Render(quadsCount);
 }
 
 void BackgroundTextureShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex& minVertex,
@@ -94,6 +76,15 @@ void BackgroundTextureShaderManager::FillQuadVertexData(const AbstractRenderer::
     const AbstractRenderer::RenderParams& rp,
     std::vector<float>& vec)
 {
+    const size_t imageIndex = (rp.textureName.has_value()) ? 
+        this->GetImage(*rp.textureName) : this->emptyImage;
+
+    const AtlasImage& img = this->images[imageIndex];
+    this->uvRect[0] = img.u0;
+    this->uvRect[1] = img.v0;
+    this->uvRect[2] = img.u1;
+    this->uvRect[3] = img.v1;
+
     if (rp.bgColor.has_value())
     {
         BackgroundShaderManager::FillQuadVertexData(minVertex, maxVertex, rp, vec);
@@ -104,83 +95,203 @@ void BackgroundTextureShaderManager::FillQuadVertexData(const AbstractRenderer::
         tmp.bgColor = Color(r, g, b, a);
         BackgroundShaderManager::FillQuadVertexData(minVertex, maxVertex, tmp, vec);
     }
-    
-    if (rp.textureName.has_value())
+}
+
+/// <summary>
+/// Get image from atlas - if image is not loaded yet,
+/// its loading is requested and white image is used
+/// </summary>
+/// <param name="fileName"></param>
+/// <returns>index of image</returns>
+size_t BackgroundTextureShaderManager::GetImage(const std::string& fileName)
+{
+    auto it = this->texturesNames.find(fileName);
+    if (it != this->texturesNames.end())
     {
-        this->usedTextures.emplace_back(this->LoadTextureData(*rp.textureName));
+        return it->second;
     }
-    else
+    
+    this->loader.Request(fileName);
+
+    return this->emptyImage;
+}
+
+/// <summary>
+/// Start loading of images in background
+/// </summary>
+/// <param name="names"></param>
+void BackgroundTextureShaderManager::Preload(const std::vector<std::string>& names)
+{
+    for (const auto& name : names)
     {
-        this->usedTextures.emplace_back(emptyTextureId);
+        this->loader.Request(name);
     }
 }
 
+/// <summary>
+/// Test if some images are still loading or waiting for upload
+/// </summary>
+/// <returns></returns>
+bool BackgroundTextureShaderManager::IsLoading() const
+{
+    return this->loader.IsLoading();
+}
 
-GLuint BackgroundTextureShaderManager::LoadTextureData(const std::string& fileName)
+void BackgroundTextureShaderManager::PrefetchResources(const AbstractRenderer::RenderParams& rp)
 {
-    auto it = this->texturesNames.try_emplace(fileName);
-    if (it.second == false)
+    if (rp.textureName.has_value())
     {
-        return it.first->second;
+        this->loader.Request(*rp.textureName);
     }
-    
-    std::vector<uint8_t> buffer;
-    unsigned width, height;
-    lodepng::State state; //optionally customize this one
-    //state.decoder.color_convert = 0; //keep input data channels count
+}
 
-    size_t fileDataSize = 0;
-    uint8_t* fileData = LoadDataFontFromFile(fileName, &fileDataSize);
-    
-    auto error = lodepng::decode(buffer, width, height, state, fileData, fileDataSize);
+/// <summary>
+/// Upload loaded images to atlas
+/// </summary>
+/// <returns>true if some images were added</returns>
+bool BackgroundTextureShaderManager::SyncResources()
+{
+    auto loaded = this->loader.TakeLoaded();
 
-    SAFE_DELETE_ARRAY(fileData);
+    for (const auto& img : loaded)
+    {
+        size_t index = this->emptyImage;
 
-    int channelsCount = 4;
-    if (width * height * 3 == buffer.size()) channelsCount = 3;
-    else if (width * height == buffer.size()) channelsCount = 1;
-    
-    GLuint texId = this->InitTexture(buffer, width, height, channelsCount);
+        if (img.data.empty())
+        {
+            MY_LOG_ERROR("Failed to load background image %s", img.name.c_str());
+        }
+        else if (auto added = this->AddImage(img.data, img.w, img.h))
+        {
+            index = *added;
+        }
+        else
+        {
+            MY_LOG_ERROR("Background atlas is full - image %s is not used", img.name.c_str());
+        }
 
-    it.first->second = texId;
+        this->texturesNames[img.name] = index;
+    }
 
-    return texId;
+    return (loaded.empty() == false);
 }
 
-GLuint BackgroundTextureShaderManager::InitTexture(const std::vector<uint8_t>& data, int w, int h, int channelsCount)
+/// <summary>
+/// Create empty RGBA atlas texture
+/// </summary>
+void BackgroundTextureShaderManager::InitAtlas()
 {
-    GLuint texture;
+    //create texture
+    GL_CHECK(glGenTextures(1, &this->atlasTexture));
+    FONT_BIND_TEXTURE_2D(this->atlasTexture);
     
+    GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+        this->atlasSize, this->atlasSize, 0,
+        GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
     
-    //create texture
-    GL_CHECK(glGenTextures(1, &texture));
-    FONT_BIND_TEXTURE_2D(texture);
     
-    if (channelsCount == 1)
+    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+    FONT_UNBIND_TEXTURE_2D;
+}
+
+/// <summary>
+/// Find space for rect in atlas
+/// Rect is put to first shelf where it fits,
+/// otherwise new shelf is started
+/// </summary>
+/// <param name="w"></param>
+/// <param name="h"></param>
+/// <param name="x"></param>
+/// <param name="y"></param>
+/// <returns>false if atlas is full</returns>
+bool BackgroundTextureShaderManager::FindSpace(int w, int h, int& x, int& y)
+{
+    if ((w > this->atlasSize) || (h > this->atlasSize))
     {
-        GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, TEXTURE_SINGLE_CHANNEL,
-            w, h, 0,
-            TEXTURE_SINGLE_CHANNEL, GL_UNSIGNED_BYTE, data.data()));
+        return false;
     }
-    else if (channelsCount == 3)
+
+    for (Shelf& s : this->shelves)
     {
-        GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
-            w, h, 0,
-            GL_RGB, GL_UNSIGNED_BYTE, data.data()));
+        if ((h <= s.h) && (s.x + w <= this->atlasSize))
+        {
+            x = s.x;
+            y = s.y;
+            s.x += w;
+            return true;
+        }
     }
-    else if (channelsCount == 4)
+
+    if (this->shelvesEnd + h > this->atlasSize)
     {
-        GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
-            w, h, 0,
-            GL_RGBA, GL_UNSIGNED_BYTE, data.data()));
+        return false;
     }
 
-    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    
-    
-    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-    GL_CHECK(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-    
-    return texture;
+    Shelf s;
+    s.y = this->shelvesEnd;
+    s.h = h;
+    s.x = w;
+    this->shelves.push_back(s);
+
+    this->shelvesEnd += h;
+
+    x = 0;
+    y = s.y;
+    return true;
+}
+
+/// <summary>
+/// Add RGBA image to atlas
+/// Image is uploaded with padding filled by its edge pixels
+/// </summary>
+/// <param name="rgba"></param>
+/// <param name="w"></param>
+/// <param name="h"></param>
+/// <returns>index of image or nullopt if atlas is full</returns>
+std::optional<size_t> BackgroundTextureShaderManager::AddImage(const std::vector<uint8_t>& rgba, int w, int h)
+{
+    const int pw = w + 2 * ATLAS_PADDING;
+    const int ph = h + 2 * ATLAS_PADDING;
+
+    int x = 0;
+    int y = 0;
+    if (this->FindSpace(pw, ph, x, y) == false)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> padded(static_cast<size_t>(pw) * ph * 4);
+    for (int py = 0; py < ph; py++)
+    {
+        const int sy = std::clamp(py - ATLAS_PADDING, 0, h - 1);
+        for (int px = 0; px < pw; px++)
+        {
+            const int sx = std::clamp(px - ATLAS_PADDING, 0, w - 1);
+            std::memcpy(&padded[(static_cast<size_t>(py) * pw + px) * 4], 
+                &rgba[(static_cast<size_t>(sy) * w + sx) * 4], 4);
+        }
+    }
+
+    FONT_BIND_TEXTURE_2D(this->atlasTexture);
+    GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0,
+        x, y, pw, ph,
+        GL_RGBA, GL_UNSIGNED_BYTE, padded.data()));
+    FONT_UNBIND_TEXTURE_2D;
+
+    const float size = static_cast<float>(this->atlasSize);
+
+    AtlasImage img;
+    img.u0 = (x + ATLAS_PADDING) / size;
+    img.v0 = (y + ATLAS_PADDING) / size;
+    img.u1 = (x + ATLAS_PADDING + w) / size;
+    img.v1 = (y + ATLAS_PADDING + h) / size;
+
+    this->images.push_back(img);
+
+    return this->images.size() - 1;
 }
@@ -3,22 +3,38 @@
 
 #include <vector>
 #include <unordered_map>
+#include <optional>
 
 #include "../../Externalncludes.h"
 #include "../../Renderers/AbstractRenderer.h"
 
+#include "../../Utils/AsyncImageLoader.h"
+
 #include "./BackgroundShaderManager.h"
 
+/// <summary>
+/// Shader manager for backgrounds with images (RenderParams::textureName)
+/// All images are packed to one RGBA atlas (shelf packing) and every vertex
+/// has texture rect of its image, so all backgrounds are rendered with one texture
+/// 
+/// If atlas is full, new images are replaced by white image (only color is used)
+/// 
+/// Images are decoded on worker threads (see AsyncImageLoader) and uploaded
+/// to atlas in SyncResources. Until image is ready, background has only its color.
+/// </summary>
 class BackgroundTextureShaderManager : public BackgroundShaderManager
 {
 public:
-    BackgroundTextureShaderManager();
+    BackgroundTextureShaderManager(bool sdfShape = false, int atlasSize = 2048);
     virtual ~BackgroundTextureShaderManager();
 
     virtual const char* GetVertexShaderSource() const override;
     virtual const char* GetPixelShaderSource() const override;
 
     void SetBaseColor(float r, float g, float b, float a);
+
+    void Preload(const std::vector<std::string>& names);
+    bool IsLoading() const;
     
     void GetAttributtesUniforms() override;
    
@@ -27,20 +43,56 @@ public:
         const AbstractRenderer::RenderParams& rp,
         std::vector<float>& vec) override;
 
-    void Clear() override;
+    void PrefetchResources(const AbstractRenderer::RenderParams& rp) override;
+    bool SyncResources() override;
+
     void Render(int quadsCount) override;
 
 protected:
+
+    /// <summary>
+    /// Image in atlas - texture rect without padding
+    /// </summary>
+    struct AtlasImage
+    {
+        float u0, v0;
+        float u1, v1;
+    };
+
+    /// <summary>
+    /// Row of images in atlas
+    /// </summary>
+    struct Shelf
+    {
+        int y;
+        int h;
+        int x; //first free pixel
+    };
+
+    //every image has border with copied edge pixels
+    //so linear filtering does not mix neighbour images
+    static const int ATLAS_PADDING = 1;
+
     float r, g, b, a;
     GLint bgTextureUniform;
 
-    GLuint emptyTextureId;
-    
-    std::unordered_map<std::string, int> texturesNames;
-    std::vector<GLuint> usedTextures;
+    int atlasSize;
+    GLuint atlasTexture;
+
+    std::vector<Shelf> shelves;
+    int shelvesEnd;
+
+    std::vector<AtlasImage> images;
+    size_t emptyImage;
+
+    std::unordered_map<std::string, size_t> texturesNames;
+    AsyncImageLoader loader;
     
-    GLuint LoadTextureData(const std::string& fileName);
-    GLuint InitTexture(const std::vector<uint8_t>& data, int w, int h, int channelsCount);
+    size_t GetImage(const std::string& fileName);
+
+    void InitAtlas();
+    std::optional<size_t> AddImage(const std::vector<uint8_t>& rgba, int w, int h);
+    bool FindSpace(int w, int h, int& x, int& y);
 };
 
 
@@ -1,5 +1,7 @@
 #include "./ColoredFontShaderManager.h"
 
+#include <typeinfo>
+
 #include "./Shaders.h"
 
 ColoredFontShaderManager::ColoredFontShaderManager(bool enableTransparency) :
@@ -7,6 +9,7 @@ ColoredFontShaderManager::ColoredFontShaderManager(bool enableTransparency) :
     positionLocation(0),
     texCoordLocation(0)    
 {
+    this->SetIndexedQuads(true);
 }
 
 const char* ColoredFontShaderManager::GetVertexShaderSource() const
@@ -64,9 +67,22 @@ void ColoredFontShaderManager::BindUniforms()
 {   
 }
 
+bool ColoredFontShaderManager::CanBatchWith(const IShaderManager* sm) const
+{
+    if ((sm == nullptr) || (typeid(*sm) != typeid(*this)))
+    {
+        return false;
+    }
+
+    auto o = static_cast<const ColoredFontShaderManager*>(sm);
+
+    return (this->enableTransparency == o->enableTransparency) &&
+        (this->indexedQuads == o->indexedQuads);
+}
+
 int ColoredFontShaderManager::GetQuadVertices() const
 {
-    return 6;
+    return (this->indexedQuads) ? 4 : 6;
 }
 
 
@@ -96,6 +112,15 @@ void ColoredFontShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex
         vec.push_back(minVertex.u); vec.push_back(maxVertex.v);
         vec.push_back(rp.color.a);
 
+        if (this->indexedQuads)
+        {
+            //only c is added, triangles (a, b, d), (b, c, d) are in index buffer
+            vec.push_back(maxX); vec.push_back(maxY);
+            vec.push_back(maxVertex.u); vec.push_back(maxVertex.v);
+            vec.push_back(rp.color.a);
+            return;
+        }
+
         //========================================================
         //========================================================
 
@@ -122,6 +147,14 @@ void ColoredFontShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex
         vec.push_back(minX); vec.push_back(maxY);
         vec.push_back(minVertex.u); vec.push_back(maxVertex.v);        
 
+        if (this->indexedQuads)
+        {
+            //only c is added, triangles (a, b, d), (b, c, d) are in index buffer
+            vec.push_back(maxX); vec.push_back(maxY);
+            vec.push_back(maxVertex.u); vec.push_back(maxVertex.v);
+            return;
+        }
+
         //========================================================
         //========================================================
 
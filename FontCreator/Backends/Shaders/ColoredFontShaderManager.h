@@ -25,6 +25,7 @@ public:
     void BindUniforms() override;
 
     int GetQuadVertices() const override;
+    bool CanBatchWith(const IShaderManager* sm) const override;
 
     void FillQuadVertexData(const AbstractRenderer::Vertex& minVertex,
         const AbstractRenderer::Vertex& maxVertex,
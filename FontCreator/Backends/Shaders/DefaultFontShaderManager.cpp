@@ -1,19 +1,31 @@
 #include "./DefaultFontShaderManager.h"
 
+#include <cmath>
+#include <algorithm>
+#include <typeinfo>
+
 #include "./Shaders.h"
 
 #include "./SdfShaderSupport.h"
 
-DefaultFontShaderManager::DefaultFontShaderManager(std::optional<SDF> sdf) :
+DefaultFontShaderManager::DefaultFontShaderManager(std::optional<SDF> sdf, bool quantized) :
     sdf(sdf.has_value() ? std::make_shared<SdfShaderSupport>(*sdf) : nullptr),
+    quantized(quantized),
     positionLocation(0),
     texCoordLocation(0),
-    colorLocation(0)    
+    colorLocation(0),
+    canvasScaleUniform(-1),
+    textureScaleUniform(-1)
 {
+    this->SetIndexedQuads(true);
 }
 
 const char* DefaultFontShaderManager::GetVertexShaderSource() const
 {
+    if (quantized)
+    {
+        return (sdf) ? DEFAULT_QUANTIZED_SDF_VERTEX_SHADER_SOURCE : DEFAULT_QUANTIZED_VERTEX_SHADER_SOURCE;
+    }
     return (sdf) ? DEFAULT_SDF_VERTEX_SHADER_SOURCE : DEFAULT_VERTEX_SHADER_SOURCE;
 }
 
@@ -34,6 +46,12 @@ void DefaultFontShaderManager::GetAttributtesUniforms()
     GL_CHECK(texCoordLocation = glGetAttribLocation(shaderProgram, "TEXCOORD0"));
     GL_CHECK(colorLocation = glGetAttribLocation(shaderProgram, "COLOR"));
 
+    if (quantized)
+    {
+        GL_CHECK(canvasScaleUniform = glGetUniformLocation(shaderProgram, "canvasScale"));
+        GL_CHECK(textureScaleUniform = glGetUniformLocation(shaderProgram, "textureScale"));
+    }
+
     if (sdf)
     {        
         sdf->LoadUniforms(shaderProgram);                
@@ -43,6 +61,28 @@ void DefaultFontShaderManager::GetAttributtesUniforms()
 
 void DefaultFontShaderManager::BindVertexAtribs()
 {
+    if (quantized)
+    {
+        //12 bytes per vertex
+        const GLsizei Q_VERTEX_SIZE = 3 * sizeof(float);
+
+        GL_CHECK(glEnableVertexAttribArray(positionLocation));
+        GL_CHECK(glVertexAttribPointer(positionLocation, 2,
+                                       GL_SHORT, GL_FALSE,
+                                       Q_VERTEX_SIZE, (void*)(0)));
+
+        GL_CHECK(glEnableVertexAttribArray(texCoordLocation));
+        GL_CHECK(glVertexAttribPointer(texCoordLocation, 2,
+                                       GL_UNSIGNED_SHORT, GL_FALSE,
+                                       Q_VERTEX_SIZE, (void*)(sizeof(float))));
+
+        GL_CHECK(glEnableVertexAttribArray(colorLocation));
+        GL_CHECK(glVertexAttribPointer(colorLocation, 4,
+                                       GL_UNSIGNED_BYTE, GL_TRUE,
+                                       Q_VERTEX_SIZE, (void*)(2 * sizeof(float))));
+        return;
+    }
+
     const GLsizei POSITION_SIZE = 2;
     const GLsizei TEXCOORD_SIZE = 2;
     const GLsizei COLOR_SIZE = 4;
@@ -72,15 +112,35 @@ void DefaultFontShaderManager::BindVertexAtribs()
 
 void DefaultFontShaderManager::BindUniforms()
 {
+    if (quantized)
+    {
+        GL_CHECK(glUniform2f(canvasScaleUniform, 2.0f / canvasW, 2.0f / canvasH));
+        GL_CHECK(glUniform2f(textureScaleUniform, 1.0f / textureW, 1.0f / textureH));
+    }
+
     if (sdf)
     {    
         sdf->BindUniforms();        
     }
 }
 
+bool DefaultFontShaderManager::CanBatchWith(const IShaderManager* sm) const
+{
+    if ((sm == nullptr) || (typeid(*sm) != typeid(*this)))
+    {
+        return false;
+    }
+
+    auto o = static_cast<const DefaultFontShaderManager*>(sm);
+
+    return (this->quantized == o->quantized) &&
+        (this->indexedQuads == o->indexedQuads) &&
+        SdfShaderSupport::IsSame(this->sdf.get(), o->sdf.get());
+}
+
 int DefaultFontShaderManager::GetQuadVertices() const
 {
-    return 6;
+    return (this->indexedQuads) ? 4 : 6;
 }
 
 
@@ -89,6 +149,11 @@ void DefaultFontShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex
                                               const AbstractRenderer::RenderParams & rp,
                                               std::vector<float> & vec)
 {
+    if (this->quantized)
+    {
+        this->FillQuantizedQuadVertexData(minVertex, maxVertex, rp, vec);
+        return;
+    }
     
     float minX = 2.0f * minVertex.x - 1.0f;
     float minY = -(2.0f * minVertex.y - 1.0f);
@@ -111,6 +176,16 @@ void DefaultFontShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex
     vec.push_back(rp.color.r); vec.push_back(rp.color.g);
     vec.push_back(rp.color.b); vec.push_back(rp.color.a);
     
+    if (this->indexedQuads)
+    {
+        //only c is added, triangles (a, b, d), (b, c, d) are in index buffer
+        vec.push_back(maxX); vec.push_back(maxY);
+        vec.push_back(maxVertex.u); vec.push_back(maxVertex.v);
+        vec.push_back(rp.color.r); vec.push_back(rp.color.g);
+        vec.push_back(rp.color.b); vec.push_back(rp.color.a);
+        return;
+    }
+
     //========================================================
     //========================================================
     
@@ -140,3 +215,66 @@ void DefaultFontShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex
     */
 }
 
+/// <summary>
+/// Fill quad with quantized vertices
+/// Input vertices are normalized to [0, 1], they are converted back
+/// to pixels and texels (rounded), scale is applied in shader
+/// </summary>
+/// <param name="minVertex"></param>
+/// <param name="maxVertex"></param>
+/// <param name="rp"></param>
+/// <param name="vec"></param>
+void DefaultFontShaderManager::FillQuantizedQuadVertexData(const AbstractRenderer::Vertex& minVertex,
+    const AbstractRenderer::Vertex& maxVertex,
+    const AbstractRenderer::RenderParams& rp,
+    std::vector<float>& vec)
+{
+    const uint32_t a = PackInt16(minVertex.x * canvasW, minVertex.y * canvasH);
+    const uint32_t b = PackInt16(maxVertex.x * canvasW, minVertex.y * canvasH);
+    const uint32_t c = PackInt16(maxVertex.x * canvasW, maxVertex.y * canvasH);
+    const uint32_t d = PackInt16(minVertex.x * canvasW, maxVertex.y * canvasH);
+
+    const uint32_t ta = PackUInt16(minVertex.u * textureW, minVertex.v * textureH);
+    const uint32_t tb = PackUInt16(maxVertex.u * textureW, minVertex.v * textureH);
+    const uint32_t tc = PackUInt16(maxVertex.u * textureW, maxVertex.v * textureH);
+    const uint32_t td = PackUInt16(minVertex.u * textureW, maxVertex.v * textureH);
+
+    const uint32_t color = PackColor(rp.color);
+
+    PushBits(a, vec); PushBits(ta, vec); PushBits(color, vec);
+    PushBits(b, vec); PushBits(tb, vec); PushBits(color, vec);
+    PushBits(d, vec); PushBits(td, vec); PushBits(color, vec);
+
+    if (this->indexedQuads)
+    {
+        PushBits(c, vec); PushBits(tc, vec); PushBits(color, vec);
+        return;
+    }
+
+    PushBits(b, vec); PushBits(tb, vec); PushBits(color, vec);
+    PushBits(c, vec); PushBits(tc, vec); PushBits(color, vec);
+    PushBits(d, vec); PushBits(td, vec); PushBits(color, vec);
+}
+
+/// <summary>
+/// Round and pack two values to int16 pair (first value in lower bytes)
+/// </summary>
+uint32_t DefaultFontShaderManager::PackInt16(float a, float b) noexcept
+{
+    const int32_t ia = static_cast<int32_t>(std::clamp(std::round(a), -32768.0f, 32767.0f));
+    const int32_t ib = static_cast<int32_t>(std::clamp(std::round(b), -32768.0f, 32767.0f));
+
+    return static_cast<uint32_t>(static_cast<uint16_t>(ia)) |
+        (static_cast<uint32_t>(static_cast<uint16_t>(ib)) << 16);
+}
+
+/// <summary>
+/// Round and pack two values to uint16 pair (first value in lower bytes)
+/// </summary>
+uint32_t DefaultFontShaderManager::PackUInt16(float a, float b) noexcept
+{
+    const uint32_t ua = static_cast<uint32_t>(std::clamp(std::round(a), 0.0f, 65535.0f));
+    const uint32_t ub = static_cast<uint32_t>(std::clamp(std::round(b), 0.0f, 65535.0f));
+
+    return ua | (ub << 16);
+}
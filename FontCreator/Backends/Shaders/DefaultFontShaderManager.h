@@ -15,7 +15,7 @@ class SdfShaderSupport;
 class DefaultFontShaderManager : public IShaderManager
 {
 public:
-    DefaultFontShaderManager(std::optional<SDF> sdf);
+    DefaultFontShaderManager(std::optional<SDF> sdf, bool quantized = false);
 	virtual ~DefaultFontShaderManager() = default;
     
     virtual const char* GetVertexShaderSource() const override;
@@ -26,6 +26,7 @@ public:
     void BindUniforms() override;
     
     int GetQuadVertices() const override;
+    bool CanBatchWith(const IShaderManager* sm) const override;
 
     void FillQuadVertexData(const AbstractRenderer::Vertex & minVertex,
                         const AbstractRenderer::Vertex & maxVertex,
@@ -36,9 +37,24 @@ protected:
     
     std::shared_ptr<SdfShaderSupport> sdf;
 
+    //vertex is int16 x, y (pixels), uint16 u, v (texels), RGBA8 color
+    //each pair / color is stored as raw bits of one float in geometry
+    bool quantized;
+
     GLint positionLocation;
     GLint texCoordLocation;
     GLint colorLocation;     
+
+    GLint canvasScaleUniform;
+    GLint textureScaleUniform;
+
+    void FillQuantizedQuadVertexData(const AbstractRenderer::Vertex & minVertex,
+                        const AbstractRenderer::Vertex & maxVertex,
+                        const AbstractRenderer::RenderParams & rp,
+                        std::vector<float> & vec);
+
+    static uint32_t PackInt16(float a, float b) noexcept;
+    static uint32_t PackUInt16(float a, float b) noexcept;
    
 };
 
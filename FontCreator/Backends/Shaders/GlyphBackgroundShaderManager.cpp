@@ -0,0 +1,178 @@
+#include "./GlyphBackgroundShaderManager.h"
+
+#include "./Shaders.h"
+#include "./BackgroundShaderManager.h"
+
+GlyphBackgroundShaderManager::GlyphBackgroundShaderManager() :
+	positionLocation(0),
+	texCoordLocation(0),
+	colorLocation(0),
+	shapeLocation(0),
+	shape(BackgroundSettings::Shape::SQUARE),
+	roundCornerRadius(0.0f),
+	bgColor(std::nullopt)
+{
+	this->SetIndexedQuads(true);
+}
+
+const char* GlyphBackgroundShaderManager::GetVertexShaderSource() const
+{
+	return GLYPH_BACKGROUND_VERTEX_SHADER_SOURCE;
+}
+
+const char* GlyphBackgroundShaderManager::GetPixelShaderSource() const
+{
+	return GLYPH_BACKGROUND_PIXEL_SHADER_SOURCE;
+}
+
+/// <summary>
+/// Get shader uniforms and attributes locations
+/// </summary>
+void GlyphBackgroundShaderManager::GetAttributtesUniforms()
+{
+	GL_CHECK(positionLocation = glGetAttribLocation(shaderProgram, "POSITION"));
+	GL_CHECK(texCoordLocation = glGetAttribLocation(shaderProgram, "TEXCOORD0"));
+	GL_CHECK(colorLocation = glGetAttribLocation(shaderProgram, "COLOR"));
+	GL_CHECK(shapeLocation = glGetAttribLocation(shaderProgram, "SHAPE"));
+}
+
+void GlyphBackgroundShaderManager::BindVertexAtribs()
+{
+	const GLsizei POSITION_SIZE = 2;
+	const GLsizei TEXCOORD_SIZE = 2;
+	const GLsizei COLOR_SIZE = 4;
+	const GLsizei SHAPE_SIZE = 4;
+
+	const GLsizei STRIDE = VERTEX_SIZE * sizeof(float);
+	const size_t POSITION_OFFSET = 0;
+	const size_t TEX_COORD_OFFSET = POSITION_OFFSET + POSITION_SIZE * sizeof(float);
+	const size_t COLOR_OFFSET = TEX_COORD_OFFSET + TEXCOORD_SIZE * sizeof(float);
+	const size_t SHAPE_OFFSET = COLOR_OFFSET + COLOR_SIZE * sizeof(float);
+
+	GL_CHECK(glEnableVertexAttribArray(positionLocation));
+	GL_CHECK(glVertexAttribPointer(positionLocation, POSITION_SIZE,
+		GL_FLOAT, GL_FALSE,
+		STRIDE, (void*)(POSITION_OFFSET)));
+
+	GL_CHECK(glEnableVertexAttribArray(texCoordLocation));
+	GL_CHECK(glVertexAttribPointer(texCoordLocation, TEXCOORD_SIZE,
+		GL_FLOAT, GL_FALSE,
+		STRIDE, (void*)(TEX_COORD_OFFSET)));
+
+	GL_CHECK(glEnableVertexAttribArray(colorLocation));
+	GL_CHECK(glVertexAttribPointer(colorLocation, COLOR_SIZE,
+		GL_FLOAT, GL_FALSE,
+		STRIDE, (void*)(COLOR_OFFSET)));
+
+	GL_CHECK(glEnableVertexAttribArray(shapeLocation));
+	GL_CHECK(glVertexAttribPointer(shapeLocation, SHAPE_SIZE,
+		GL_FLOAT, GL_FALSE,
+		STRIDE, (void*)(SHAPE_OFFSET)));
+}
+
+void GlyphBackgroundShaderManager::BindUniforms()
+{
+}
+
+/// <summary>
+/// Set shape and default color of backgrounds
+/// Shadow is not supported (it is rendered by separate background pass)
+/// </summary>
+/// <param name="bs"></param>
+void GlyphBackgroundShaderManager::SetBackgroundSettings(const BackgroundSettings& bs)
+{
+	this->shape = bs.shape;
+	this->roundCornerRadius = bs.cornerRadius;
+	this->bgColor = bs.color;
+}
+
+int GlyphBackgroundShaderManager::GetQuadVertices() const
+{
+	return (this->indexedQuads) ? 4 : 6;
+}
+
+/// <summary>
+/// Add glyph quad (mode 0)
+/// </summary>
+/// <param name="minVertex"></param>
+/// <param name="maxVertex"></param>
+/// <param name="rp"></param>
+/// <param name="vec"></param>
+void GlyphBackgroundShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex& minVertex,
+	const AbstractRenderer::Vertex& maxVertex,
+	const AbstractRenderer::RenderParams& rp,
+	std::vector<float>& vec)
+{
+	const float minX = 2.0f * minVertex.x - 1.0f;
+	const float minY = -(2.0f * minVertex.y - 1.0f);
+
+	const float maxX = 2.0f * maxVertex.x - 1.0f;
+	const float maxY = -(2.0f * maxVertex.y - 1.0f);
+
+	AddVertex(minX, minY, minVertex.u, minVertex.v, rp.color, 0, 0, 0, 0, vec);
+	AddVertex(maxX, minY, maxVertex.u, minVertex.v, rp.color, 0, 0, 0, 0, vec);
+	AddVertex(minX, maxY, minVertex.u, maxVertex.v, rp.color, 0, 0, 0, 0, vec);
+
+	if (this->indexedQuads)
+	{
+		//triangles (a, b, d), (b, c, d) are in index buffer
+		AddVertex(maxX, maxY, maxVertex.u, maxVertex.v, rp.color, 0, 0, 0, 0, vec);
+		return;
+	}
+
+	AddVertex(maxX, minY, maxVertex.u, minVertex.v, rp.color, 0, 0, 0, 0, vec);
+	AddVertex(maxX, maxY, maxVertex.u, maxVertex.v, rp.color, 0, 0, 0, 0, vec);
+	AddVertex(minX, maxY, minVertex.u, maxVertex.v, rp.color, 0, 0, 0, 0, vec);
+}
+
+/// <summary>
+/// Add background quad (mode 1)
+/// Color is taken from render params or from background settings
+/// </summary>
+/// <param name="minVertex"></param>
+/// <param name="maxVertex"></param>
+/// <param name="rp"></param>
+/// <param name="vec"></param>
+/// <returns>false if background has no color and nothing was added</returns>
+bool GlyphBackgroundShaderManager::FillBackgroundVertexData(const AbstractRenderer::Vertex& minVertex,
+	const AbstractRenderer::Vertex& maxVertex,
+	const AbstractRenderer::RenderParams& rp,
+	std::vector<float>& vec) const
+{
+	if ((rp.bgColor.has_value() == false) && (this->bgColor.has_value() == false))
+	{
+		return false;
+	}
+
+	const Color& c = (rp.bgColor.has_value()) ? *rp.bgColor : *this->bgColor;
+
+	const auto q = BackgroundShaderManager::CalcSdfShapeQuad(this->shape, this->roundCornerRadius,
+		this->canvasW, this->canvasH, minVertex, maxVertex, rp.scale);
+
+	AddVertex(q.minX, q.minY, -q.extX, -q.extY, c, q.halfW, q.halfH, q.radius, 1, vec);
+	AddVertex(q.maxX, q.minY, q.extX, -q.extY, c, q.halfW, q.halfH, q.radius, 1, vec);
+	AddVertex(q.minX, q.maxY, -q.extX, q.extY, c, q.halfW, q.halfH, q.radius, 1, vec);
+
+	if (this->indexedQuads)
+	{
+		AddVertex(q.maxX, q.maxY, q.extX, q.extY, c, q.halfW, q.halfH, q.radius, 1, vec);
+		return true;
+	}
+
+	AddVertex(q.maxX, q.minY, q.extX, -q.extY, c, q.halfW, q.halfH, q.radius, 1, vec);
+	AddVertex(q.maxX, q.maxY, q.extX, q.extY, c, q.halfW, q.halfH, q.radius, 1, vec);
+	AddVertex(q.minX, q.maxY, -q.extX, q.extY, c, q.halfW, q.halfH, q.radius, 1, vec);
+
+	return true;
+}
+
+void GlyphBackgroundShaderManager::AddVertex(float x, float y, float u, float v, const Color& c,
+	float halfW, float halfH, float radius, float mode, std::vector<float>& vec)
+{
+	vec.push_back(x); vec.push_back(y);
+	vec.push_back(u); vec.push_back(v);
+	vec.push_back(c.r); vec.push_back(c.g);
+	vec.push_back(c.b); vec.push_back(c.a);
+	vec.push_back(halfW); vec.push_back(halfH);
+	vec.push_back(radius); vec.push_back(mode);
+}
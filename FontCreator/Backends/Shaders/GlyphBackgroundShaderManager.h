@@ -0,0 +1,66 @@
+#ifndef GLYPH_BACKGROUND_SHADER_MANAGER_H
+#define GLYPH_BACKGROUND_SHADER_MANAGER_H
+
+#include <vector>
+#include <optional>
+
+#include "../../Externalncludes.h"
+#include "../../Renderers/AbstractRenderer.h"
+
+#include "./IShaderManager.h"
+
+/// <summary>
+/// Shader manager for glyphs and color backgrounds in one vertex stream
+/// Vertex: position, texcoord / local position, color and shape (half size, radius, mode)
+/// Background is one quad with shape evaluated in pixel shader (see BackgroundShaderManager)
+/// It is added before glyphs of its group, so later strings cover earlier ones
+/// and everything is rendered with one draw call
+/// </summary>
+class GlyphBackgroundShaderManager : public IShaderManager
+{
+public:
+
+	/// <summary>
+	/// Floats per vertex: x, y, u, v, r, g, b, a, halfW, halfH, radius, mode
+	/// </summary>
+	static const int VERTEX_SIZE = 12;
+
+	GlyphBackgroundShaderManager();
+	virtual ~GlyphBackgroundShaderManager() = default;
+
+	virtual const char* GetVertexShaderSource() const override;
+	virtual const char* GetPixelShaderSource() const override;
+
+	void GetAttributtesUniforms() override;
+	void BindVertexAtribs() override;
+	void BindUniforms() override;
+
+	void SetBackgroundSettings(const BackgroundSettings& bs);
+
+	int GetQuadVertices() const override;
+
+	void FillQuadVertexData(const AbstractRenderer::Vertex& minVertex,
+		const AbstractRenderer::Vertex& maxVertex,
+		const AbstractRenderer::RenderParams& rp,
+		std::vector<float>& vec) override;
+
+	bool FillBackgroundVertexData(const AbstractRenderer::Vertex& minVertex,
+		const AbstractRenderer::Vertex& maxVertex,
+		const AbstractRenderer::RenderParams& rp,
+		std::vector<float>& vec) const;
+
+protected:
+	GLint positionLocation;
+	GLint texCoordLocation;
+	GLint colorLocation;
+	GLint shapeLocation;
+
+	BackgroundSettings::Shape shape;
+	float roundCornerRadius;
+	std::optional<Color> bgColor;
+
+	static void AddVertex(float x, float y, float u, float v, const Color& c,
+		float halfW, float halfH, float radius, float mode, std::vector<float>& vec);
+};
+
+#endif
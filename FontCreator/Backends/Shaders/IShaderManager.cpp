@@ -1,9 +1,14 @@
 #include "./IShaderManager.h"
 
+#include <algorithm>
+
 #if defined(_DEBUG) || defined(DEBUG)
 #	define NV_REPORT_COMPILE_ERRORS
 #endif
 
+GLuint IShaderManager::quadIndexBuffer = 0;
+int IShaderManager::quadIndexCapacity = 0;
+
 GLuint IShaderManager::BuildFromSources(const char* vSource, const char* pSource)
 {
 	GLuint program = 0;
@@ -19,9 +24,28 @@ GLuint IShaderManager::BuildFromSources(const char* vSource, const char* pSource
 
 	this->SetShaderProgram(program);
 
+	GL_CHECK(this->viewTransformUniform = glGetUniformLocation(program, "viewTransform"));
+
 	return program;
 }
 
+/// <summary>
+/// Bind transform of vertex positions to clip space to active shader
+/// clip = position * (sx, sy) + (tx, ty)
+/// Must be called before every render - uniform is zero after link
+/// and shader manager can be shared by backends with different views
+/// </summary>
+/// <param name="transform">sx, sy, tx, ty</param>
+void IShaderManager::BindViewTransform(const float* transform)
+{
+	if (this->viewTransformUniform < 0)
+	{
+		return;
+	}
+
+	GL_CHECK(glUniform4fv(this->viewTransformUniform, 1, transform));
+}
+
 /// <summary>
 /// Compile input shader
 /// </summary>
@@ -100,7 +124,94 @@ GLuint IShaderManager::LinkGLSLProgram(GLuint vertexShader, GLuint fragmentShade
 	return program;
 }
 
+/// <summary>
+/// Set if quads are indexed (4 vertices per quad + shared index buffer)
+/// or use 6 vertices per quad
+/// Must be set before geometry is generated, since it changes
+/// the vertex count of quads
+/// Only managers that support it (eg. fonts) are switched
+/// </summary>
+/// <param name="val"></param>
+void IShaderManager::SetIndexedQuads(bool val)
+{
+	this->indexedQuads = val;
+}
+
+bool IShaderManager::IsIndexedQuads() const
+{
+	return this->indexedQuads;
+}
+
+/// <summary>
+/// Bind shared index buffer with at least quadsCount quads
+/// Buffer is grow-only, quad q has indices
+/// (4q, 4q + 1, 4q + 2), (4q + 1, 4q + 3, 4q + 2)
+/// Binding is stored in currently bound VAO
+/// </summary>
+/// <param name="quadsCount"></param>
+void IShaderManager::BindQuadIndices(int quadsCount)
+{
+	if (quadIndexBuffer == 0)
+	{
+		GL_CHECK(glGenBuffers(1, &quadIndexBuffer));
+	}
+
+	GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer));
+
+	if (quadsCount <= quadIndexCapacity)
+	{
+		return;
+	}
+
+	const int capacity = std::max(quadsCount + quadsCount / 2, 1024);
+
+	std::vector<uint32_t> indices;
+	indices.reserve(static_cast<size_t>(capacity) * 6);
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(capacity); i++)
+	{
+		const uint32_t v = 4 * i;
+		indices.push_back(v);
+		indices.push_back(v + 1);
+		indices.push_back(v + 2);
+
+		indices.push_back(v + 1);
+		indices.push_back(v + 3);
+		indices.push_back(v + 2);
+	}
+
+	GL_CHECK(glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+		indices.size() * sizeof(uint32_t),
+		indices.data(),
+		GL_STATIC_DRAW));
+
+	quadIndexCapacity = capacity;
+}
+
+/// <summary>
+/// Release index buffer shared by all shader managers
+/// Called when the last OpenGL backend is destroyed (context must be current),
+/// buffer is created again if it is needed later
+/// </summary>
+void IShaderManager::ReleaseSharedBuffers()
+{
+	if (quadIndexBuffer != 0)
+	{
+		GL_CHECK(glDeleteBuffers(1, &quadIndexBuffer));
+		quadIndexBuffer = 0;
+	}
+
+	quadIndexCapacity = 0;
+}
+
 void IShaderManager::Render(int quadsCount)
 {
+	if (this->indexedQuads)
+	{
+		this->BindQuadIndices(quadsCount);
+		GL_CHECK(glDrawElements(GL_TRIANGLES, quadsCount * 6, GL_UNSIGNED_INT, nullptr));
+		return;
+	}
+
 	GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, quadsCount * this->GetQuadVertices()));
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define ISHADER_MANAGER_H
 
 #include <vector>
+#include <cstring>
+#include <algorithm>
 
 #include "../../Externalncludes.h"
 #include "../../Renderers/AbstractRenderer.h"
@@ -13,7 +15,11 @@ public:
     IShaderManager() : 
         shaderProgram(0),
         canvasW(1),
-        canvasH(1)
+        canvasH(1),
+        textureW(1),
+        textureH(1),
+        indexedQuads(false),
+        viewTransformUniform(-1)
     {}
     virtual ~IShaderManager() = default;
 
@@ -41,8 +47,28 @@ public:
         canvasH = static_cast<float>(h);
     }
 
+    virtual void SetTextureSize(int w, int h)
+    {
+        textureW = static_cast<float>(w);
+        textureH = static_cast<float>(h);
+    }
+
     virtual int GetQuadVertices() const = 0;
 
+    /// <summary>
+    /// Test if geometry of both managers can be rendered with this manager
+    /// in one draw call (same vertex layout, shaders and uniforms)
+    /// </summary>
+    virtual bool CanBatchWith(const IShaderManager* /*sm*/) const
+    {
+        return false;
+    }
+
+    void SetIndexedQuads(bool val);
+    bool IsIndexedQuads() const;
+
+    void BindViewTransform(const float* transform);
+
     virtual void FillQuadVertexData(const AbstractRenderer::Vertex& minVertex,
         const AbstractRenderer::Vertex& maxVertex,
         const AbstractRenderer::RenderParams& rp,
@@ -50,16 +76,70 @@ public:
 
     virtual void Clear() { }
 
+    /// <summary>
+    /// Called when new render params are added (can be called from any thread)
+    /// Resources used by params can be loaded in advance
+    /// </summary>
+    virtual void PrefetchResources(const AbstractRenderer::RenderParams& /*rp*/) { }
+
+    /// <summary>
+    /// Called on render thread before geometry is generated
+    /// Upload of resources loaded in background is done here
+    /// </summary>
+    /// <returns>true if geometry must be generated again</returns>
+    virtual bool SyncResources() { return false; }
+
     virtual void PreRender() {	}
 
     virtual void Render(int quadsCount);
 
+    static void ReleaseSharedBuffers();
+
+    /// <summary>
+    /// Append packed integer data to geometry as one float
+    /// Bits are copied with memcpy and never loaded as float,
+    /// so NaN patterns are kept unchanged
+    /// </summary>
+    static void PushBits(uint32_t bits, std::vector<float>& vec)
+    {
+        vec.push_back(0.0f);
+        std::memcpy(&vec.back(), &bits, sizeof(uint32_t));
+    }
+
+    /// <summary>
+    /// Pack color to RGBA8 (r in lowest byte)
+    /// </summary>
+    static uint32_t PackColor(const Color& c) noexcept
+    {
+        auto toByte = [](float v) {
+            return static_cast<uint32_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+
+        return toByte(c.r) | (toByte(c.g) << 8) | (toByte(c.b) << 16) | (toByte(c.a) << 24);
+    }
+
 protected:
     GLuint shaderProgram;
 
     float canvasW;
     float canvasH;
 
+    float textureW;
+    float textureH;
+
+    //quads have 4 vertices and are rendered with shared index buffer
+    bool indexedQuads;
+
+    //-1 if shader does not use view transform (eg. custom shaders)
+    GLint viewTransformUniform;
+
+    //index buffer shared by all shader managers
+    //it only grows, it is released with the last OpenGL backend
+    static GLuint quadIndexBuffer;
+    static int quadIndexCapacity;
+
+    void BindQuadIndices(int quadsCount);
+
     GLuint CompileGLSLShader(GLenum target, const char* shader) const;
     GLuint LinkGLSLProgram(GLuint vertexShader, GLuint fragmentShader) const;
 };
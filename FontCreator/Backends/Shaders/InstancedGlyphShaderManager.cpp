@@ -0,0 +1,166 @@
+#include "./InstancedGlyphShaderManager.h"
+
+#include <typeinfo>
+
+#include "./Shaders.h"
+
+#include "./SdfShaderSupport.h"
+
+GLuint InstancedGlyphShaderManager::unitQuadBuffer = 0;
+
+InstancedGlyphShaderManager::InstancedGlyphShaderManager(std::optional<SDF> sdf) :
+	sdf(sdf.has_value() ? std::make_shared<SdfShaderSupport>(*sdf) : nullptr),
+	cornerLocation(0),
+	positionLocation(0),
+	texCoordLocation(0),
+	colorLocation(0)
+{
+}
+
+const char* InstancedGlyphShaderManager::GetVertexShaderSource() const
+{
+	return INSTANCED_GLYPH_VERTEX_SHADER_SOURCE;
+}
+
+const char* InstancedGlyphShaderManager::GetPixelShaderSource() const
+{
+	return (sdf) ? (
+		sdf->GetSettings().outlineColor.has_value() ? DEFAULT_SDF_OUTLINE_PIXEL_SHADER_SOURCE : DEFAULT_SDF_PIXEL_SHADER_SOURCE
+		) : INSTANCED_PIXEL_SHADER_SOURCE;
+}
+
+/// <summary>
+/// Get shader uniforms and attributes locations
+/// </summary>
+void InstancedGlyphShaderManager::GetAttributtesUniforms()
+{
+	GL_CHECK(cornerLocation = glGetAttribLocation(shaderProgram, "CORNER"));
+	GL_CHECK(positionLocation = glGetAttribLocation(shaderProgram, "POSITION"));
+	GL_CHECK(texCoordLocation = glGetAttribLocation(shaderProgram, "TEXCOORD0"));
+	GL_CHECK(colorLocation = glGetAttribLocation(shaderProgram, "COLOR"));
+
+	if (sdf)
+	{
+		sdf->LoadUniforms(shaderProgram);
+	}
+}
+
+/// <summary>
+/// Instance attributes are read from currently bound buffer,
+/// CORNER from static unit quad buffer
+/// </summary>
+void InstancedGlyphShaderManager::BindVertexAtribs()
+{
+	const GLsizei POSITION_SIZE = 4;
+	const GLsizei TEXCOORD_SIZE = 4;
+	const GLsizei COLOR_SIZE = 4;
+
+	const GLsizei VERTEX_SIZE = INSTANCE_SIZE * sizeof(float);
+	const size_t POSITION_OFFSET = 0;
+	const size_t TEX_COORD_OFFSET = POSITION_OFFSET + POSITION_SIZE * sizeof(float);
+	const size_t COLOR_OFFSET = TEX_COORD_OFFSET + TEXCOORD_SIZE * sizeof(float);
+
+	GL_CHECK(glEnableVertexAttribArray(positionLocation));
+	GL_CHECK(glVertexAttribPointer(positionLocation, POSITION_SIZE,
+		GL_FLOAT, GL_FALSE,
+		VERTEX_SIZE, (void*)(POSITION_OFFSET)));
+	GL_CHECK(glVertexAttribDivisor(positionLocation, 1));
+
+	GL_CHECK(glEnableVertexAttribArray(texCoordLocation));
+	GL_CHECK(glVertexAttribPointer(texCoordLocation, TEXCOORD_SIZE,
+		GL_FLOAT, GL_FALSE,
+		VERTEX_SIZE, (void*)(TEX_COORD_OFFSET)));
+	GL_CHECK(glVertexAttribDivisor(texCoordLocation, 1));
+
+	GL_CHECK(glEnableVertexAttribArray(colorLocation));
+	GL_CHECK(glVertexAttribPointer(colorLocation, COLOR_SIZE,
+		GL_UNSIGNED_BYTE, GL_TRUE,
+		VERTEX_SIZE, (void*)(COLOR_OFFSET)));
+	GL_CHECK(glVertexAttribDivisor(colorLocation, 1));
+
+	//unit quad - triangle strip
+	GLint instanceBuffer = 0;
+	GL_CHECK(glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &instanceBuffer));
+
+	if (unitQuadBuffer == 0)
+	{
+		const float corners[8] = {
+			0.0f, 0.0f,
+			1.0f, 0.0f,
+			0.0f, 1.0f,
+			1.0f, 1.0f
+		};
+
+		GL_CHECK(glGenBuffers(1, &unitQuadBuffer));
+		FONT_BIND_ARRAY_BUFFER(unitQuadBuffer);
+		GL_CHECK(glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW));
+	}
+	else
+	{
+		FONT_BIND_ARRAY_BUFFER(unitQuadBuffer);
+	}
+
+	GL_CHECK(glEnableVertexAttribArray(cornerLocation));
+	GL_CHECK(glVertexAttribPointer(cornerLocation, 2,
+		GL_FLOAT, GL_FALSE,
+		2 * sizeof(float), (void*)(0)));
+	GL_CHECK(glVertexAttribDivisor(cornerLocation, 0));
+
+	FONT_BIND_ARRAY_BUFFER(static_cast<GLuint>(instanceBuffer));
+}
+
+/// <summary>
+/// Release unit quad shared by all instanced glyph managers
+/// Called when the last OpenGL backend is destroyed (context must be current),
+/// unit quad is created again if it is needed later
+/// </summary>
+void InstancedGlyphShaderManager::ReleaseUnitQuad()
+{
+	if (unitQuadBuffer != 0)
+	{
+		FONT_DELETE_BUFFER(unitQuadBuffer);
+		unitQuadBuffer = 0;
+	}
+}
+
+void InstancedGlyphShaderManager::BindUniforms()
+{
+	if (sdf)
+	{
+		sdf->BindUniforms();
+	}
+}
+
+bool InstancedGlyphShaderManager::CanBatchWith(const IShaderManager* sm) const
+{
+	if ((sm == nullptr) || (typeid(*sm) != typeid(*this)))
+	{
+		return false;
+	}
+
+	auto o = static_cast<const InstancedGlyphShaderManager*>(sm);
+
+	return SdfShaderSupport::IsSame(this->sdf.get(), o->sdf.get());
+}
+
+int InstancedGlyphShaderManager::GetQuadVertices() const
+{
+	return 4;
+}
+
+void InstancedGlyphShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex& minVertex,
+	const AbstractRenderer::Vertex& maxVertex,
+	const AbstractRenderer::RenderParams& rp,
+	std::vector<float>& vec)
+{
+	FillInstanceData(minVertex, maxVertex, rp.color, vec);
+}
+
+/// <summary>
+/// Render instances - quadsCount is number of glyphs
+/// </summary>
+/// <param name="quadsCount"></param>
+void InstancedGlyphShaderManager::Render(int quadsCount)
+{
+	GL_CHECK(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, this->GetQuadVertices(), quadsCount));
+}
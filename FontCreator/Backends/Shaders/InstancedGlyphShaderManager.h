@@ -0,0 +1,130 @@
+#ifndef INSTANCED_GLYPH_SHADER_MANAGER_H
+#define INSTANCED_GLYPH_SHADER_MANAGER_H
+
+class SdfShaderSupport;
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cmath>
+
+#include "../../Externalncludes.h"
+#include "../../Renderers/AbstractRenderer.h"
+
+#include "./IShaderManager.h"
+
+/// <summary>
+/// Shader manager that renders every glyph as one instance
+/// Instance: rect (x, y, w, h), UV rect (u0, v0, u1, v1) and RGBA8 color
+/// Static unit quad (4 vertices, triangle strip) is expanded in vertex shader,
+/// so geometry has INSTANCE_SIZE floats per glyph
+///
+/// Instance functions are static and do not use OpenGL
+/// </summary>
+class InstancedGlyphShaderManager : public IShaderManager
+{
+public:
+
+	/// <summary>
+	/// Floats per instance: x, y, w, h, u0, v0, u1, v1, color (RGBA8 bits)
+	/// </summary>
+	static const int INSTANCE_SIZE = 9;
+
+	InstancedGlyphShaderManager(std::optional<SDF> sdf);
+	virtual ~InstancedGlyphShaderManager() = default;
+
+	virtual const char* GetVertexShaderSource() const override;
+	virtual const char* GetPixelShaderSource() const override;
+
+	void GetAttributtesUniforms() override;
+	void BindVertexAtribs() override;
+	void BindUniforms() override;
+
+	int GetQuadVertices() const override;
+	bool CanBatchWith(const IShaderManager* sm) const override;
+
+	void FillQuadVertexData(const AbstractRenderer::Vertex & minVertex,
+						const AbstractRenderer::Vertex & maxVertex,
+						const AbstractRenderer::RenderParams & rp,
+						std::vector<float> & vec) override;
+
+	void Render(int quadsCount) override;
+
+	static void FillInstanceData(const AbstractRenderer::Vertex & minVertex,
+		const AbstractRenderer::Vertex & maxVertex,
+		const Color & color,
+		std::vector<float> & vec);
+
+	static bool IsInstanceValid(const float * instance) noexcept;
+
+	static void ReleaseUnitQuad();
+
+protected:
+
+	//unit quad shared by all instanced glyph managers
+	//it is released with the last OpenGL backend
+	static GLuint unitQuadBuffer;
+
+	std::shared_ptr<SdfShaderSupport> sdf;
+
+	GLint cornerLocation;
+	GLint positionLocation;
+	GLint texCoordLocation;
+	GLint colorLocation;
+};
+
+//====================================================================================
+
+/// <summary>
+/// Append one glyph instance
+/// Vertices are normalized to [0, 1] (see BackendOpenGL::AddQuad)
+/// </summary>
+/// <param name="minVertex"></param>
+/// <param name="maxVertex"></param>
+/// <param name="color"></param>
+/// <param name="vec"></param>
+inline void InstancedGlyphShaderManager::FillInstanceData(const AbstractRenderer::Vertex& minVertex,
+	const AbstractRenderer::Vertex& maxVertex,
+	const Color& color,
+	std::vector<float>& vec)
+{
+	vec.push_back(minVertex.x); vec.push_back(minVertex.y);
+	vec.push_back(maxVertex.x - minVertex.x); vec.push_back(maxVertex.y - minVertex.y);
+	vec.push_back(minVertex.u); vec.push_back(minVertex.v);
+	vec.push_back(maxVertex.u); vec.push_back(maxVertex.v);
+	PushBits(PackColor(color), vec);
+}
+
+/// <summary>
+/// Test if instance data are valid
+/// (finite rect with non-negative size and UVs inside texture)
+/// </summary>
+/// <param name="instance">INSTANCE_SIZE floats</param>
+/// <returns></returns>
+inline bool InstancedGlyphShaderManager::IsInstanceValid(const float* instance) noexcept
+{
+	for (int i = 0; i < 8; i++)
+	{
+		if (std::isfinite(instance[i]) == false)
+		{
+			return false;
+		}
+	}
+
+	if ((instance[2] < 0.0f) || (instance[3] < 0.0f))
+	{
+		return false;
+	}
+
+	for (int i = 4; i < 8; i++)
+	{
+		if ((instance[i] < 0.0f) || (instance[i] > 1.0f))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "./InstancedNumberShaderManager.h"
+
+#include "./Shaders.h"
+
+#include "./SdfShaderSupport.h"
+
+InstancedNumberShaderManager::InstancedNumberShaderManager(std::optional<SDF> sdf) :
+	sdf(sdf.has_value() ? std::make_shared<SdfShaderSupport>(*sdf) : nullptr),
+	positionLocation(0),
+	scaleLocation(0),
+	colorLocation(0),
+	digitsLocation(0),
+	glyphRectUniform(-1),
+	glyphMetricsUniform(-1),
+	canvasSizeUniform(-1),
+	textureSizeUniform(-1),
+	spacingUniform(-1),
+	glyphRects{},
+	glyphMetrics{},
+	spacing(0.0f)
+{
+}
+
+const char* InstancedNumberShaderManager::GetVertexShaderSource() const
+{
+	return INSTANCED_NUMBER_VERTEX_SHADER_SOURCE;
+}
+
+const char* InstancedNumberShaderManager::GetPixelShaderSource() const
+{
+	return (sdf) ? (
+		sdf->GetSettings().outlineColor.has_value() ? DEFAULT_SDF_OUTLINE_PIXEL_SHADER_SOURCE : DEFAULT_SDF_PIXEL_SHADER_SOURCE
+		) : INSTANCED_PIXEL_SHADER_SOURCE;
+}
+
+/// <summary>
+/// Set glyph for code
+/// </summary>
+/// <param name="code"></param>
+/// <param name="gi"></param>
+void InstancedNumberShaderManager::SetGlyph(uint8_t code, const GlyphInfo& gi)
+{
+	if (code >= GLYPH_CODES)
+	{
+		return;
+	}
+
+	float* r = this->glyphRects.data() + 4 * code;
+	r[0] = static_cast<float>(gi.tx);
+	r[1] = static_cast<float>(gi.ty);
+	r[2] = static_cast<float>(gi.bmpW);
+	r[3] = static_cast<float>(gi.bmpH);
+
+	float* m = this->glyphMetrics.data() + 4 * code;
+	m[0] = static_cast<float>(gi.bmpX);
+	m[1] = static_cast<float>(gi.bmpY);
+	m[2] = static_cast<float>(gi.adv);
+	m[3] = 0.0f;
+}
+
+/// <summary>
+/// Set extra spacing between glyphs in pixels
+/// </summary>
+/// <param name="spacing"></param>
+void InstancedNumberShaderManager::SetSpacing(float spacing)
+{
+	this->spacing = spacing;
+}
+
+/// <summary>
+/// Get shader uniforms and attributes locations
+/// </summary>
+void InstancedNumberShaderManager::GetAttributtesUniforms()
+{
+	GL_CHECK(positionLocation = glGetAttribLocation(shaderProgram, "POSITION"));
+	GL_CHECK(scaleLocation = glGetAttribLocation(shaderProgram, "SCALE"));
+	GL_CHECK(colorLocation = glGetAttribLocation(shaderProgram, "COLOR"));
+	GL_CHECK(digitsLocation = glGetAttribLocation(shaderProgram, "DIGITS"));
+
+	GL_CHECK(glyphRectUniform = glGetUniformLocation(shaderProgram, "glyphRect"));
+	GL_CHECK(glyphMetricsUniform = glGetUniformLocation(shaderProgram, "glyphMetrics"));
+	GL_CHECK(canvasSizeUniform = glGetUniformLocation(shaderProgram, "canvasSize"));
+	GL_CHECK(textureSizeUniform = glGetUniformLocation(shaderProgram, "textureSize"));
+	GL_CHECK(spacingUniform = glGetUniformLocation(shaderProgram, "spacing"));
+
+	if (sdf)
+	{
+		sdf->LoadUniforms(shaderProgram);
+	}
+}
+
+/// <summary>
+/// All attributes are per instance
+/// </summary>
+void InstancedNumberShaderManager::BindVertexAtribs()
+{
+	const GLsizei POSITION_SIZE = 2;
+	const GLsizei SCALE_SIZE = 1;
+	const GLsizei COLOR_SIZE = 4;
+	const GLsizei DIGITS_SIZE = 2;
+
+	const GLsizei VERTEX_SIZE = INSTANCE_SIZE * sizeof(float);
+	const size_t POSITION_OFFSET = 0;
+	const size_t SCALE_OFFSET = POSITION_OFFSET + POSITION_SIZE * sizeof(float);
+	const size_t COLOR_OFFSET = SCALE_OFFSET + SCALE_SIZE * sizeof(float);
+	const size_t DIGITS_OFFSET = COLOR_OFFSET + COLOR_SIZE * sizeof(float);
+
+	GL_CHECK(glEnableVertexAttribArray(positionLocation));
+	GL_CHECK(glVertexAttribPointer(positionLocation, POSITION_SIZE,
+		GL_FLOAT, GL_FALSE,
+		VERTEX_SIZE, (void*)(POSITION_OFFSET)));
+	GL_CHECK(glVertexAttribDivisor(positionLocation, 1));
+
+	GL_CHECK(glEnableVertexAttribArray(scaleLocation));
+	GL_CHECK(glVertexAttribPointer(scaleLocation, SCALE_SIZE,
+		GL_FLOAT, GL_FALSE,
+		VERTEX_SIZE, (void*)(SCALE_OFFSET)));
+	GL_CHECK(glVertexAttribDivisor(scaleLocation, 1));
+
+	GL_CHECK(glEnableVertexAttribArray(colorLocation));
+	GL_CHECK(glVertexAttribPointer(colorLocation, COLOR_SIZE,
+		GL_FLOAT, GL_FALSE,
+		VERTEX_SIZE, (void*)(COLOR_OFFSET)));
+	GL_CHECK(glVertexAttribDivisor(colorLocation, 1));
+
+	//packed codes are integers - no conversion to float
+	GL_CHECK(glEnableVertexAttribArray(digitsLocation));
+	GL_CHECK(glVertexAttribIPointer(digitsLocation, DIGITS_SIZE,
+		GL_UNSIGNED_INT,
+		VERTEX_SIZE, (void*)(DIGITS_OFFSET)));
+	GL_CHECK(glVertexAttribDivisor(digitsLocation, 1));
+}
+
+void InstancedNumberShaderManager::BindUniforms()
+{
+	GL_CHECK(glUniform4fv(glyphRectUniform, GLYPH_CODES, this->glyphRects.data()));
+	GL_CHECK(glUniform4fv(glyphMetricsUniform, GLYPH_CODES, this->glyphMetrics.data()));
+	GL_CHECK(glUniform2f(canvasSizeUniform, canvasW, canvasH));
+	GL_CHECK(glUniform2f(textureSizeUniform, textureW, textureH));
+	GL_CHECK(glUniform1f(spacingUniform, spacing));
+
+	if (sdf)
+	{
+		sdf->BindUniforms();
+	}
+}
+
+int InstancedNumberShaderManager::GetQuadVertices() const
+{
+	return 6;
+}
+
+/// <summary>
+/// Quads are generated in vertex shader - instances are added
+/// directly with FillInstanceData
+/// </summary>
+void InstancedNumberShaderManager::FillQuadVertexData(const AbstractRenderer::Vertex& /*minVertex*/,
+	const AbstractRenderer::Vertex& /*maxVertex*/,
+	const AbstractRenderer::RenderParams& /*rp*/,
+	std::vector<float>& /*vec*/)
+{
+}
+
+/// <summary>
+/// Render instances - quadsCount is number of instances
+/// Every instance has MAX_GLYPHS quads, unused are degenerated
+/// </summary>
+/// <param name="quadsCount"></param>
+void InstancedNumberShaderManager::Render(int quadsCount)
+{
+	GL_CHECK(glDrawArraysInstanced(GL_TRIANGLES, 0, MAX_GLYPHS * this->GetQuadVertices(), quadsCount));
+}
@@ -0,0 +1,203 @@
+#ifndef INSTANCED_NUMBER_SHADER_MANAGER_H
+#define INSTANCED_NUMBER_SHADER_MANAGER_H
+
+class SdfShaderSupport;
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <array>
+#include <algorithm>
+
+#include "../../Externalncludes.h"
+#include "../../Renderers/AbstractRenderer.h"
+
+#include "./IShaderManager.h"
+
+/// <summary>
+/// Shader manager for instanced numbers
+/// One instance is one number: pen position (in pixels), scale, color
+/// and up to MAX_GLYPHS glyph codes packed to 2 x uint32 (4 bits per glyph)
+/// Longer numbers are split to more instances (see GetInstancesCount)
+/// Glyph quads are generated in vertex shader from gl_VertexID
+/// and uniform table of glyph rects and metrics
+///
+/// Packing functions are static and do not use OpenGL
+/// </summary>
+class InstancedNumberShaderManager : public IShaderManager
+{
+public:
+
+	/// <summary>
+	/// Glyphs for codes 0 - 14, code END marks end of number
+	/// </summary>
+	static constexpr const char* CODE_CHARS = "0123456789-.e+,";
+	static const int GLYPH_CODES = 15;
+	static const uint8_t END = 15;
+
+	static const int MAX_GLYPHS = 16;
+
+	/// <summary>
+	/// Floats per instance: x, y, scale, r, g, b, a, digitsLo, digitsHi
+	/// </summary>
+	static const int INSTANCE_SIZE = 9;
+
+	InstancedNumberShaderManager(std::optional<SDF> sdf);
+	virtual ~InstancedNumberShaderManager() = default;
+
+	virtual const char* GetVertexShaderSource() const override;
+	virtual const char* GetPixelShaderSource() const override;
+
+	void GetAttributtesUniforms() override;
+	void BindVertexAtribs() override;
+	void BindUniforms() override;
+
+	int GetQuadVertices() const override;
+
+	void FillQuadVertexData(const AbstractRenderer::Vertex & minVertex,
+						const AbstractRenderer::Vertex & maxVertex,
+						const AbstractRenderer::RenderParams & rp,
+						std::vector<float> & vec) override;
+
+	void Render(int quadsCount) override;
+
+	void SetGlyph(uint8_t code, const GlyphInfo & gi);
+	void SetSpacing(float spacing);
+
+	static int GetInstancesCount(int glyphsCount) noexcept;
+	static uint8_t GetCode(char c) noexcept;
+	static uint8_t GetPackedCode(uint32_t lo, uint32_t hi, int index) noexcept;
+	static bool PackCodes(const char * str, size_t count, uint32_t & lo, uint32_t & hi) noexcept;
+	static void FillInstanceData(float x, float y, float scale, const Color & color,
+		uint32_t lo, uint32_t hi, std::vector<float> & vec);
+
+protected:
+	std::shared_ptr<SdfShaderSupport> sdf;
+
+	GLint positionLocation;
+	GLint scaleLocation;
+	GLint colorLocation;
+	GLint digitsLocation;
+
+	GLint glyphRectUniform;
+	GLint glyphMetricsUniform;
+	GLint canvasSizeUniform;
+	GLint textureSizeUniform;
+	GLint spacingUniform;
+
+	std::array<float, 4 * GLYPH_CODES> glyphRects;
+	std::array<float, 4 * GLYPH_CODES> glyphMetrics;
+	float spacing;
+};
+
+//====================================================================================
+
+/// <summary>
+/// Get number of instances needed for number with glyphsCount glyphs
+/// (at least one instance)
+/// </summary>
+/// <param name="glyphsCount"></param>
+/// <returns></returns>
+inline int InstancedNumberShaderManager::GetInstancesCount(int glyphsCount) noexcept
+{
+	return std::max(1, (glyphsCount + MAX_GLYPHS - 1) / MAX_GLYPHS);
+}
+
+/// <summary>
+/// Get glyph code of character
+/// </summary>
+/// <param name="c"></param>
+/// <returns>code or END for unknown character</returns>
+inline uint8_t InstancedNumberShaderManager::GetCode(char c) noexcept
+{
+	if ((c >= '0') && (c <= '9'))
+	{
+		return static_cast<uint8_t>(c - '0');
+	}
+
+	for (uint8_t i = 10; i < GLYPH_CODES; i++)
+	{
+		if (CODE_CHARS[i] == c)
+		{
+			return i;
+		}
+	}
+
+	return END;
+}
+
+/// <summary>
+/// Get code of glyph at index from packed codes
+/// (same as in vertex shader)
+/// </summary>
+/// <param name="lo"></param>
+/// <param name="hi"></param>
+/// <param name="index"></param>
+/// <returns></returns>
+inline uint8_t InstancedNumberShaderManager::GetPackedCode(uint32_t lo, uint32_t hi, int index) noexcept
+{
+	const uint32_t bits = (index < 8) ? lo : hi;
+	return static_cast<uint8_t>((bits >> (4 * (index % 8))) & 0xF);
+}
+
+/// <summary>
+/// Pack characters to 4-bit glyph codes
+/// Unused codes are filled with END
+/// </summary>
+/// <param name="str"></param>
+/// <param name="count"></param>
+/// <param name="lo">codes 0 - 7</param>
+/// <param name="hi">codes 8 - 15</param>
+/// <returns>false if string is too long or contains unknown character</returns>
+inline bool InstancedNumberShaderManager::PackCodes(const char* str, size_t count,
+	uint32_t& lo, uint32_t& hi) noexcept
+{
+	lo = 0xFFFFFFFF;
+	hi = 0xFFFFFFFF;
+
+	if (count > MAX_GLYPHS)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint32_t code = GetCode(str[i]);
+		if (code == END)
+		{
+			lo = 0xFFFFFFFF;
+			hi = 0xFFFFFFFF;
+			return false;
+		}
+
+		uint32_t& bits = (i < 8) ? lo : hi;
+		const uint32_t shift = static_cast<uint32_t>(4 * (i % 8));
+		bits = (bits & ~(0xFu << shift)) | (code << shift);
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Append one instance to vertex buffer data
+/// Packed codes are stored as raw bits of floats
+/// </summary>
+/// <param name="x">pen position in pixels</param>
+/// <param name="y">baseline position in pixels</param>
+/// <param name="scale"></param>
+/// <param name="color"></param>
+/// <param name="lo"></param>
+/// <param name="hi"></param>
+/// <param name="vec"></param>
+inline void InstancedNumberShaderManager::FillInstanceData(float x, float y, float scale,
+	const Color& color, uint32_t lo, uint32_t hi, std::vector<float>& vec)
+{
+	vec.push_back(x); vec.push_back(y);
+	vec.push_back(scale);
+	vec.push_back(color.r); vec.push_back(color.g);
+	vec.push_back(color.b); vec.push_back(color.a);
+	PushBits(lo, vec);
+	PushBits(hi, vec);
+}
+
+#endif
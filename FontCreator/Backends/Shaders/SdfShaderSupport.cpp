@@ -28,6 +28,39 @@ void SdfShaderSupport::LoadUniforms(GLuint shaderProgram)
     }
 }
 
+/// <summary>
+/// Test if two SDF supports set the same uniforms
+/// (nullptr = SDF not used)
+/// </summary>
+/// <param name="a"></param>
+/// <param name="b"></param>
+/// <returns></returns>
+bool SdfShaderSupport::IsSame(const SdfShaderSupport* a, const SdfShaderSupport* b)
+{
+    if ((a == nullptr) || (b == nullptr))
+    {
+        return (a == b);
+    }
+
+    const SDF& sa = a->sdf;
+    const SDF& sb = b->sdf;
+
+    if ((sa.edgeValue != sb.edgeValue) || (sa.softness != sb.softness) ||
+        (sa.outlineColor.has_value() != sb.outlineColor.has_value()))
+    {
+        return false;
+    }
+
+    if (sa.outlineColor.has_value() == false)
+    {
+        return true;
+    }
+
+    return (sa.outlineWidth == sb.outlineWidth) &&
+        (sa.outlineColor->r == sb.outlineColor->r) && (sa.outlineColor->g == sb.outlineColor->g) &&
+        (sa.outlineColor->b == sb.outlineColor->b) && (sa.outlineColor->a == sb.outlineColor->a);
+}
+
 void SdfShaderSupport::BindUniforms()
 {
     glUniform1f(sdfEdgeLocation, sdf.edgeValue);
@@ -18,6 +18,8 @@ public:
     void LoadUniforms(GLuint shaderProgram);
     void BindUniforms();
 
+    static bool IsSame(const SdfShaderSupport* a, const SdfShaderSupport* b);
+
 protected:
     SDF sdf;
 
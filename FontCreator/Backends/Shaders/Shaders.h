@@ -22,6 +22,12 @@
 #   define PS_CODE_3(x) "#version 300 es\nprecision highp float; " #x
 #endif
 
+//============================================================
+// All vertex shaders map positions to clip space with
+// viewTransform: clip = position * xy + zw
+// (identity, if view transform is not used - see IShaderManager)
+//============================================================
+
 //============================================================
 // Default shaders
 //============================================================
@@ -31,12 +37,14 @@ static const char* DEFAULT_VERTEX_SHADER_SOURCE = VS_CODE(
     attribute vec2 TEXCOORD0;
     attribute vec4 COLOR;
     
+    uniform vec4 viewTransform;
+
     varying vec2 texCoord;
     varying vec4 color;
 
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
         texCoord = TEXCOORD0;
         color = COLOR;
     }
@@ -64,12 +72,14 @@ static const char* DEFAULT_SDF_VERTEX_SHADER_SOURCE = VS_CODE_3(
     in vec2 TEXCOORD0;
     in vec4 COLOR;
     
+    uniform vec4 viewTransform;
+
     out vec2 texCoord;
     out vec4 color;
 
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
         texCoord = TEXCOORD0;
         color = COLOR;
     }
@@ -132,6 +142,169 @@ static const char* DEFAULT_SDF_OUTLINE_PIXEL_SHADER_SOURCE = PS_CODE_3(
     }
 );
 
+//============================================================
+// Quantized default shaders
+// POSITION is in pixels, TEXCOORD0 in texels, COLOR is normalized RGBA8
+// canvasScale = 2 / canvas size, textureScale = 1 / texture size
+//============================================================
+
+static const char* DEFAULT_QUANTIZED_VERTEX_SHADER_SOURCE = VS_CODE(
+    attribute vec2 POSITION;
+    attribute vec2 TEXCOORD0;
+    attribute vec4 COLOR;
+
+    uniform vec2 canvasScale;
+    uniform vec2 textureScale;
+    uniform vec4 viewTransform;
+
+    varying vec2 texCoord;
+    varying vec4 color;
+
+    void main()
+    {
+        vec2 p = POSITION * canvasScale - 1.0;
+        gl_Position = vec4(vec2(p.x, -p.y) * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        texCoord = TEXCOORD0 * textureScale;
+        color = COLOR;
+    }
+);
+
+static const char* DEFAULT_QUANTIZED_SDF_VERTEX_SHADER_SOURCE = VS_CODE_3(
+    in vec2 POSITION;
+    in vec2 TEXCOORD0;
+    in vec4 COLOR;
+
+    uniform vec2 canvasScale;
+    uniform vec2 textureScale;
+    uniform vec4 viewTransform;
+
+    out vec2 texCoord;
+    out vec4 color;
+
+    void main()
+    {
+        vec2 p = POSITION * canvasScale - 1.0;
+        gl_Position = vec4(vec2(p.x, -p.y) * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        texCoord = TEXCOORD0 * textureScale;
+        color = COLOR;
+    }
+);
+
+//============================================================
+// Instanced numbers
+// One instance = one number, glyphs are generated from
+// packed 4-bit glyph codes (see InstancedNumberShaderManager)
+//============================================================
+
+static const char* INSTANCED_NUMBER_VERTEX_SHADER_SOURCE = VS_CODE_3(
+    in vec2 POSITION;
+    in float SCALE;
+    in vec4 COLOR;
+    in uvec2 DIGITS;
+
+    uniform vec4 glyphRect[15]; //tx, ty, bmpW, bmpH in texels
+    uniform vec4 glyphMetrics[15]; //bmpX, bmpY, adv, 0
+    uniform vec2 canvasSize;
+    uniform vec2 textureSize;
+    uniform float spacing;
+    uniform vec4 viewTransform;
+
+    out vec2 texCoord;
+    out vec4 color;
+
+    int GetCode(int index)
+    {
+        uint bits = (index < 8) ? DIGITS.x : DIGITS.y;
+        return int((bits >> uint(4 * (index % 8))) & 15u);
+    }
+
+    void main()
+    {
+        int glyph = gl_VertexID / 6;
+        int corner = gl_VertexID % 6;
+
+        int code = GetCode(glyph);
+        color = COLOR;
+
+        if (code >= 15)
+        {
+            //end of number - degenerated triangle
+            texCoord = vec2(0.0);
+            gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+
+        //pen position - same rounding as CPU path
+        float x = POSITION.x;
+        for (int i = 0; i < glyph; i++)
+        {
+            x += floor((glyphMetrics[GetCode(i)].z + spacing) * SCALE);
+        }
+
+        vec4 rect = glyphRect[code];
+        vec4 metrics = glyphMetrics[code];
+
+        //corners order: (min, min), (max, min), (min, max), (max, min), (max, max), (min, max)
+        vec2 useMax = vec2(
+            ((corner == 1) || (corner == 3) || (corner == 4)) ? 1.0 : 0.0,
+            ((corner == 2) || (corner >= 4)) ? 1.0 : 0.0);
+
+        vec2 p = vec2(x + metrics.x * SCALE, POSITION.y - metrics.y * SCALE);
+        p += useMax * rect.zw * SCALE;
+
+        p = 2.0 * (p / canvasSize) - 1.0;
+
+        gl_Position = vec4(vec2(p.x, -p.y) * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        texCoord = (rect.xy + useMax * rect.zw) / textureSize;
+    }
+);
+
+//============================================================
+// Instanced glyphs
+// One instance = one glyph quad, static unit quad (CORNER)
+// is expanded to instance rect (see InstancedGlyphShaderManager)
+//============================================================
+
+static const char* INSTANCED_GLYPH_VERTEX_SHADER_SOURCE = VS_CODE_3(
+    in vec2 CORNER;
+    in vec4 POSITION; //x, y, w, h - normalized to [0, 1]
+    in vec4 TEXCOORD0; //u0, v0, u1, v1
+    in vec4 COLOR;
+
+    uniform vec4 viewTransform;
+
+    out vec2 texCoord;
+    out vec4 color;
+
+    void main()
+    {
+        vec2 p = POSITION.xy + CORNER * POSITION.zw;
+        p = 2.0 * p - 1.0;
+
+        gl_Position = vec4(vec2(p.x, -p.y) * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        texCoord = mix(TEXCOORD0.xy, TEXCOORD0.zw, CORNER);
+        color = COLOR;
+    }
+);
+
+//============================================================
+// Pixel shader for instanced numbers and glyphs
+//============================================================
+
+static const char* INSTANCED_PIXEL_SHADER_SOURCE = PS_CODE_3(
+    in vec2 texCoord;
+    in vec4 color;
+
+    out vec4 fragColor;
+
+    uniform sampler2D fontTex;
+
+    void main()
+    {
+        fragColor = vec4(color.rgb, color.a * texture(fontTex, texCoord.xy).x);
+    }
+);
+
 //============================================================
 // Single color special
 //============================================================
@@ -140,11 +313,13 @@ static const char* SINGLE_COLOR_VERTEX_SHADER_SOURCE = VS_CODE(
     attribute vec2 POSITION;
     attribute vec2 TEXCOORD0;
     
+    uniform vec4 viewTransform;
+
     varying vec2 texCoord;
 	
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
         texCoord = TEXCOORD0;
     }
 );
@@ -171,11 +346,13 @@ static const char* SINGLE_COLOR_SDF_VERTEX_SHADER_SOURCE = VS_CODE_3(
     in vec2 POSITION;
     in vec2 TEXCOORD0;
     
+    uniform vec4 viewTransform;
+
     out vec2 texCoord;
     
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
         texCoord = TEXCOORD0;
     }
 );
@@ -246,11 +423,13 @@ static const char* COLORED_TRANSPARENT_GLYPHS_VERTEX_SHADER_SOURCE = VS_CODE(
     attribute vec2 POSITION;
     attribute vec3 TEXCOORD0;
 
+    uniform vec4 viewTransform;
+
     varying vec3 texCoord;    
 
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
         texCoord = TEXCOORD0;        
     }
 );
@@ -287,11 +466,13 @@ static const char* BACKGROUND_VERTEX_SHADER_SOURCE = VS_CODE(
     attribute vec2 POSITION;
     attribute vec4 COLOR;        
     
+    uniform vec4 viewTransform;
+
     varying vec4 color;
 
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
         color = COLOR;
     }
 );
@@ -305,13 +486,19 @@ static const char* BACKGROUND_PIXEL_SHADER_SOURCE = PS_CODE(
     }
 );
 
+//UVRECT - rect of image in background atlas (u0, v0, u1, v1)
+
 static const char* TEXTURE_BACKGROUND_VERTEX_SHADER_SOURCE = VS_CODE(
     attribute vec2 POSITION;
     attribute vec4 COLOR;
     attribute vec4 AABB;
+    attribute vec4 UVRECT;
     
+    uniform vec4 viewTransform;
+
     varying vec4 color;
     varying vec2 texCoord;
+    varying vec4 uvRect;
 
     vec2 mapTo01(vec2 s, vec2 from1, vec2 from2) {
         return (s - from1) * vec2(1.0) / (from2 - from1);
@@ -319,22 +506,77 @@ static const char* TEXTURE_BACKGROUND_VERTEX_SHADER_SOURCE = VS_CODE(
                                                                      
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
         color = COLOR;
         texCoord = mapTo01(POSITION.xy, AABB.xy, AABB.zw);
         texCoord.y = 1.0 - texCoord.y;
+        uvRect = UVRECT;
     }
 );
 
 static const char* TEXTURE_BACKGROUND_PIXEL_SHADER_SOURCE = PS_CODE(
     varying vec4 color;
     varying vec2 texCoord;
+    varying vec4 uvRect;
 
     uniform sampler2D bgTex;
                                                                     
     void main()
     {
-        gl_FragColor = color * texture2D( bgTex, texCoord );
+        //clamp to image - atlas contains other images
+        vec2 uv = mix(uvRect.xy, uvRect.zw, clamp(texCoord, 0.0, 1.0));
+        gl_FragColor = color * texture2D( bgTex, uv );
+    }
+);
+
+static const char* TEXTURE_BACKGROUND_SDF_VERTEX_SHADER_SOURCE = VS_CODE(
+    attribute vec2 POSITION;
+    attribute vec4 COLOR;
+    attribute vec2 LOCAL;
+    attribute vec3 SHAPE;
+    attribute vec4 UVRECT;
+
+    uniform vec4 viewTransform;
+
+    varying vec4 color;
+    varying vec2 local;
+    varying vec3 shape;
+    varying vec4 uvRect;
+
+    void main()
+    {
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        color = COLOR;
+        local = LOCAL;
+        shape = SHAPE;
+        uvRect = UVRECT;
+    }
+);
+
+static const char* TEXTURE_BACKGROUND_SDF_PIXEL_SHADER_SOURCE = PS_CODE(
+    varying vec4 color;
+    varying vec2 local;
+    varying vec3 shape;
+    varying vec4 uvRect;
+
+    uniform sampler2D bgTex;
+
+    float sdRoundRect(vec2 p, vec2 b, float r) {
+        vec2 q = abs(p) - b + r;
+        return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;
+    }
+
+    void main()
+    {
+        float d = sdRoundRect(local, shape.xy, shape.z);
+        float alpha = clamp(0.5 - d, 0.0, 1.0);
+
+        //image is stretched over shape
+        vec2 t = clamp(local / (2.0 * shape.xy) + 0.5, 0.0, 1.0);
+        vec2 uv = mix(uvRect.xy, uvRect.zw, t);
+
+        vec4 c = color * texture2D(bgTex, uv);
+        gl_FragColor = vec4(c.rgb, c.a * alpha);
     }
 );
 
@@ -345,9 +587,11 @@ static const char* TEXTURE_BACKGROUND_PIXEL_SHADER_SOURCE = PS_CODE(
 static const char* SINGLE_COLOR_BACKGROUND_VERTEX_SHADER_SOURCE = VS_CODE(
     attribute vec2 POSITION;	
 
+    uniform vec4 viewTransform;
+
     void main()
     {        
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
     }
 );
 
@@ -361,39 +605,133 @@ static const char* SINGLE_COLOR_BACKGROUND_PIXEL_SHADER_SOURCE = PS_CODE(
 );
 
 //============================================================
+// SDF shape backgrounds - one quad per background
+// LOCAL - position relative to shape center (in pixels)
+// SHAPE - half size and corner radius (in pixels)
+// circle is rounded rect with half size equal to radius
+//============================================================
+
+static const char* BACKGROUND_SDF_VERTEX_SHADER_SOURCE = VS_CODE(
+    attribute vec2 POSITION;
+    attribute vec4 COLOR;
+    attribute vec2 LOCAL;
+    attribute vec3 SHAPE;
+
+    uniform vec4 viewTransform;
+
+    varying vec4 color;
+    varying vec2 local;
+    varying vec3 shape;
+
+    void main()
+    {
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        color = COLOR;
+        local = LOCAL;
+        shape = SHAPE;
+    }
+);
+
+static const char* BACKGROUND_SDF_PIXEL_SHADER_SOURCE = PS_CODE(
+    varying vec4 color;
+    varying vec2 local;
+    varying vec3 shape;
+
+    float sdRoundRect(vec2 p, vec2 b, float r) {
+        vec2 q = abs(p) - b + r;
+        return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;
+    }
+
+    void main()
+    {
+        float d = sdRoundRect(local, shape.xy, shape.z);
+
+        //distance is in pixels - one pixel wide anti-aliasing
+        float alpha = clamp(0.5 - d, 0.0, 1.0);
+
+        gl_FragColor = vec4(color.rgb, color.a * alpha);
+    }
+);
+
+static const char* SINGLE_COLOR_BACKGROUND_SDF_VERTEX_SHADER_SOURCE = VS_CODE(
+    attribute vec2 POSITION;
+    attribute vec2 LOCAL;
+    attribute vec3 SHAPE;
+
+    uniform vec4 viewTransform;
+
+    varying vec2 local;
+    varying vec3 shape;
+
+    void main()
+    {
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        local = LOCAL;
+        shape = SHAPE;
+    }
+);
+
+static const char* SINGLE_COLOR_BACKGROUND_SDF_PIXEL_SHADER_SOURCE = PS_CODE(
+    varying vec2 local;
+    varying vec3 shape;
+
+    uniform vec4 bgColor;
+
+    float sdRoundRect(vec2 p, vec2 b, float r) {
+        vec2 q = abs(p) - b + r;
+        return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;
+    }
+
+    void main()
+    {
+        float d = sdRoundRect(local, shape.xy, shape.z);
+
+        //distance is in pixels - one pixel wide anti-aliasing
+        float alpha = clamp(0.5 - d, 0.0, 1.0);
+
+        gl_FragColor = vec4(bgColor.rgb, bgColor.a * alpha);
+    }
+);
+
+//============================================================
+
+//Background with drop shadow in one pass - one quad per background
+//LOCAL - position relative to background center (in pixels, Y up)
+//SHAPE - half size and corner radius (in pixels)
+//Shadow is rounded box convolved with Gaussian, computed analytically:
+//erf in X, 4 samples along Y
+//https://madebyevan.com/shaders/fast-rounded-rectangle-shadows/
 
 static const char* SHADOW_BACKGROUND_VERTEX_SHADER_SOURCE = VS_CODE_3(
     in vec2 POSITION;
     in vec4 COLOR;
-    in vec4 AABB;
+    in vec2 LOCAL;
+    in vec3 SHAPE;
+
+    uniform vec4 viewTransform;
 
-    out vec2 pos;
-    out vec4 aabb;
     out vec4 color;
+    out vec2 local;
+    out vec3 shape;
 
     void main()
     {
-        gl_Position = vec4(POSITION.x, POSITION.y, 0.0, 1.0);
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
 
-        pos = POSITION;
-        aabb = AABB;
         color = COLOR;
+        local = LOCAL;
+        shape = SHAPE;
     }
 );
 
-//https://www.shadertoy.com/view/NtVSW1
-//+ ChatGPT
-
 static const char* SHADOW_BACKGROUND_PIXEL_SHADER_SOURCE = PS_CODE_3(
-    in vec2 pos;
-    in vec4 aabb;
     in vec4 color;
+    in vec2 local;
+    in vec3 shape;
 
     out vec4 fragColor;
 
-    uniform float cornerRadius;
-    uniform float blurRadius;
-    uniform vec2 shadowPaddingSize;
+    uniform float sigma;
     uniform vec2 shadowDir;
     uniform vec4 shadowColor;
    
@@ -405,66 +743,117 @@ static const char* SHADOW_BACKGROUND_PIXEL_SHADER_SOURCE = PS_CODE_3(
     vec4 normalBlend(vec4 src, vec4 dst) {
         float finalAlpha = src.a + dst.a * (1.0 - src.a);
         return vec4(
-            (src.rgb * src.a + dst.rgb * dst.a * (1.0 - src.a)) / finalAlpha,
+            (src.rgb * src.a + dst.rgb * dst.a * (1.0 - src.a)) / max(finalAlpha, 1e-5),
             finalAlpha
         );
     }
 
-    float sigmoid(float t) {
-        return 1.0 / (1.0 + exp(-t));
+    float gaussian(float x, float s) {
+        return exp(-(x * x) / (2.0 * s * s)) / (2.50662827 * s);
     }
 
-    vec2 mapTo01(vec2 s, vec2 from1, vec2 from2) {
-        return (s - from1) * vec2(1.0) / (from2 - from1);
+    vec2 erf2(vec2 x) {
+        vec2 s = sign(x);
+        vec2 a = abs(x);
+        x = 1.0 + (0.278393 + (0.230389 + 0.078108 * (a * a)) * a) * a;
+        x *= x;
+        return s - s / (x * x);
     }
 
-    
+    //blurred box in X for one row
+    float shadowX(float x, float y, float s, float r, vec2 halfSize) {
+        float delta = min(halfSize.y - r - abs(y), 0.0);
+        float curved = halfSize.x - r + sqrt(max(0.0, r * r - delta * delta));
+        vec2 integral = 0.5 + 0.5 * erf2((x + vec2(-curved, curved)) * (0.70710678 / s));
+        return integral.y - integral.x;
+    }
+
+    float roundedBoxShadow(vec2 p, vec2 halfSize, float s, float r) {
+        float low = p.y - halfSize.y;
+        float high = p.y + halfSize.y;
+        float start = clamp(-3.0 * s, low, high);
+        float end = clamp(3.0 * s, low, high);
+
+        float dy = (end - start) / 4.0;
+        float y = start + dy * 0.5;
+        float value = 0.0;
+        for (int i = 0; i < 4; i++) {
+            value += shadowX(p.x, p.y - y, s, r, halfSize) * gaussian(y, s) * dy;
+            y += dy;
+        }
+        return value;
+    }
     
     void main()
     {
-        //map fragment to (0, 1) inside AABB
-        vec2 fragCoord = mapTo01(pos, aabb.xy, aabb.zw);
-
-        //put fragment to (-0.5, 0.5)
-        vec2 fc = fragCoord - vec2(0.5);
-                
-        float shadowSdf = sdRoundRect(
-            fc + shadowDir,
-            shadowPaddingSize,
-            cornerRadius + blurRadius
-        );
+        //direction is relative to background size
+        vec2 shadowCenter = -shadowDir * 2.0 * shape.xy;
 
-        float rectSdf = sdRoundRect(fc, shadowPaddingSize, cornerRadius);
+        float shadow = roundedBoxShadow(local - shadowCenter, shape.xy, sigma, shape.z);
 
-        float shadow = clamp(sigmoid(shadowSdf / blurRadius), 0.0, 1.0);
+        //anti-aliased fill, distance is in pixels
+        float rectSdf = sdRoundRect(local, shape.xy, shape.z);
+        float insideRect = clamp(0.5 - rectSdf, 0.0, 1.0);
 
+        vec4 inside = vec4(color.rgb, color.a * insideRect);
 
-        // rectangle mask
-        //float insideRect = step(rectSdf, 0.0);
-       
-        //anti-aliased
-        float aaRadius = fwidth(rectSdf);
-        float insideRect = smoothstep(aaRadius, -aaRadius, rectSdf);
+        vec4 shadowCol = shadowColor;
+        shadowCol.a *= shadow * (1.0 - insideRect);
 
-        // colors
-        
-        // outsideColor is only shadow opacity now.
-        // Everywhere else outside rect is transparent/background.
+        fragColor = normalBlend(inside, shadowCol);
+    }
+);
 
-        float outsideAlpha = 1.0 - insideRect;
+//============================================================
+// Glyphs and backgrounds in one vertex stream
+// SHAPE.w is mode: 0 - glyph, 1 - background
+// glyph: TEXCOORD0 is texture coordinate
+// background: TEXCOORD0 is position relative to shape center (in pixels)
+// and SHAPE.xyz half size and corner radius (in pixels)
+//============================================================
 
-        // shadow: 0 = dark, 1 = no shadow
-        float shadowAlpha = outsideAlpha * (1.0 - shadow);
+static const char* GLYPH_BACKGROUND_VERTEX_SHADER_SOURCE = VS_CODE(
+    attribute vec2 POSITION;
+    attribute vec2 TEXCOORD0;
+    attribute vec4 COLOR;
+    attribute vec4 SHAPE;
 
-        vec4 inside = color * insideRect;
+    uniform vec4 viewTransform;
 
-        vec4 shadowCol = shadowColor;
-        shadowCol.a *= shadowAlpha;
-        //shadowCol.a = 1.0;
+    varying vec2 texCoord;
+    varying vec4 color;
+    varying vec4 shape;
+
+    void main()
+    {
+        gl_Position = vec4(POSITION.xy * viewTransform.xy + viewTransform.zw, 0.0, 1.0);
+        texCoord = TEXCOORD0;
+        color = COLOR;
+        shape = SHAPE;
+    }
+);
+
+static const char* GLYPH_BACKGROUND_PIXEL_SHADER_SOURCE = PS_CODE(
+    varying vec2 texCoord;
+    varying vec4 color;
+    varying vec4 shape;
+
+    uniform sampler2D fontTex;
+
+    float sdRoundRect(vec2 p, vec2 b, float r) {
+        vec2 q = abs(p) - b + r;
+        return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;
+    }
 
-        vec4 col = normalBlend(inside, shadowCol);
+    void main()
+    {
+        //both alphas are evaluated and selected by mode,
+        //so texture is not sampled inside non-uniform branch
+        float glyphAlpha = texture2D(fontTex, texCoord.xy).x;
+        float bgAlpha = clamp(0.5 - sdRoundRect(texCoord, shape.xy, shape.z), 0.0, 1.0);
 
-        fragColor = col;
+        gl_FragColor.rgb = color.xyz;
+        gl_FragColor.a = color.w * mix(glyphAlpha, bgAlpha, shape.w);
     }
 );
 
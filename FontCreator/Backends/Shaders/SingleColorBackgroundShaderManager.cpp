@@ -1,10 +1,15 @@
 #include "./SingleColorBackgroundShaderManager.h"
 
+#include <cmath>
+
 #include "./Shaders.h"
 
-SingleColorBackgroundShaderManager::SingleColorBackgroundShaderManager() :
+SingleColorBackgroundShaderManager::SingleColorBackgroundShaderManager(bool sdfShape) :
 	positionLocation(-1),	
+	localLocation(-1),
+	shapeLocation(-1),
 	colorUniform(-1),
+	sdfShape(sdfShape),
 	r(1.0f),
 	g(1.0f),
 	b(1.0f),
@@ -12,16 +17,25 @@ SingleColorBackgroundShaderManager::SingleColorBackgroundShaderManager() :
 	shape(BackgroundSettings::Shape::SQUARE),
 	roundCornerRadius(0)
 {
+	if (this->sdfShape)
+	{
+		this->SetIndexedQuads(true);
+	}
 }
 
 const char* SingleColorBackgroundShaderManager::GetVertexShaderSource() const
 {
-	return SINGLE_COLOR_BACKGROUND_VERTEX_SHADER_SOURCE;
+	return (this->sdfShape) ? SINGLE_COLOR_BACKGROUND_SDF_VERTEX_SHADER_SOURCE : SINGLE_COLOR_BACKGROUND_VERTEX_SHADER_SOURCE;
 }
 
 const char* SingleColorBackgroundShaderManager::GetPixelShaderSource() const
 {
-	return SINGLE_COLOR_BACKGROUND_PIXEL_SHADER_SOURCE;
+	return (this->sdfShape) ? SINGLE_COLOR_BACKGROUND_SDF_PIXEL_SHADER_SOURCE : SINGLE_COLOR_BACKGROUND_PIXEL_SHADER_SOURCE;
+}
+
+bool SingleColorBackgroundShaderManager::IsSdfShape() const
+{
+	return this->sdfShape;
 }
 
 void SingleColorBackgroundShaderManager::SetColor(float r, float g, float b, float a)
@@ -47,6 +61,12 @@ void SingleColorBackgroundShaderManager::GetAttributtesUniforms()
 
 	GL_CHECK(positionLocation = glGetAttribLocation(shaderProgram, "POSITION"));
 	//GL_CHECK(texCoordLocation = glGetAttribLocation(shaderProgram, "TEXCOORD0"));
+
+	if (this->sdfShape)
+	{
+		GL_CHECK(localLocation = glGetAttribLocation(shaderProgram, "LOCAL"));
+		GL_CHECK(shapeLocation = glGetAttribLocation(shaderProgram, "SHAPE"));
+	}
 }
 
 void SingleColorBackgroundShaderManager::BindVertexAtribs()
@@ -54,6 +74,32 @@ void SingleColorBackgroundShaderManager::BindVertexAtribs()
 	const GLsizei POSITION_SIZE = 2;
 	const GLsizei TEXCOORD_SIZE = 2;
 
+	if (this->sdfShape)
+	{
+		const GLsizei LOCAL_SIZE = 2;
+		const GLsizei SHAPE_SIZE = 3;
+
+		const GLsizei SDF_VERTEX_SIZE = (POSITION_SIZE + LOCAL_SIZE + SHAPE_SIZE) * sizeof(float);
+		const size_t LOCAL_OFFSET = POSITION_SIZE * sizeof(float);
+		const size_t SHAPE_OFFSET = LOCAL_OFFSET + LOCAL_SIZE * sizeof(float);
+
+		GL_CHECK(glEnableVertexAttribArray(positionLocation));
+		GL_CHECK(glVertexAttribPointer(positionLocation, POSITION_SIZE,
+			GL_FLOAT, GL_FALSE,
+			SDF_VERTEX_SIZE, (void*)(0)));
+
+		GL_CHECK(glEnableVertexAttribArray(localLocation));
+		GL_CHECK(glVertexAttribPointer(localLocation, LOCAL_SIZE,
+			GL_FLOAT, GL_FALSE,
+			SDF_VERTEX_SIZE, (void*)(LOCAL_OFFSET)));
+
+		GL_CHECK(glEnableVertexAttribArray(shapeLocation));
+		GL_CHECK(glVertexAttribPointer(shapeLocation, SHAPE_SIZE,
+			GL_FLOAT, GL_FALSE,
+			SDF_VERTEX_SIZE, (void*)(SHAPE_OFFSET)));
+		return;
+	}
+
 	//const GLsizei VERTEX_SIZE = (POSITION_SIZE + TEXCOORD_SIZE) * sizeof(float);
 	const GLsizei VERTEX_SIZE = (POSITION_SIZE) * sizeof(float);
 	const size_t POSITION_OFFSET = 0;	
@@ -91,6 +137,13 @@ void SingleColorBackgroundShaderManager::PreRender()
 
 void SingleColorBackgroundShaderManager::Render(int quadsCount)
 {
+	if (this->sdfShape)
+	{
+		//one quad per background - single draw call
+		IShaderManager::Render(quadsCount);
+		return;
+	}
+
 	auto type = (shape == BackgroundSettings::Shape::SQUARE) ? GL_TRIANGLES : GL_TRIANGLE_FAN;
 
 	//GL_CHECK(glDrawArrays(type, 0, quadsCount * this->GetQuadVertices()));	
@@ -109,6 +162,11 @@ void SingleColorBackgroundShaderManager::Render(int quadsCount)
 
 int SingleColorBackgroundShaderManager::GetQuadVertices() const
 {
+	if (this->sdfShape)
+	{
+		return (this->indexedQuads) ? 4 : 6;
+	}
+
 	return (shape == BackgroundSettings::Shape::SQUARE) ? 6 : 38;
 }
 
@@ -118,6 +176,12 @@ void SingleColorBackgroundShaderManager::FillQuadVertexData(
 	const AbstractRenderer::RenderParams& rp,
 	std::vector<float>& vec)
 {
+	if (this->sdfShape)
+	{
+		this->FillSdfShapeQuad(minVertex, maxVertex, rp.scale, vec);
+		return;
+	}
+
 	//if (vec.size() > 0) return;
 	const float minX = 2.0f * minVertex.x - 1.0f;
 	const float minY = -(2.0f * minVertex.y - 1.0f);
@@ -299,3 +363,41 @@ void SingleColorBackgroundShaderManager::AddVertex(float x, float y, std::vector
 	vec.push_back(x);
 	vec.push_back(y);
 }
+
+/// <summary>
+/// Add background as one quad, shape is evaluated in pixel shader
+/// </summary>
+/// <param name="minVertex"></param>
+/// <param name="maxVertex"></param>
+/// <param name="scale"></param>
+/// <param name="vec"></param>
+void SingleColorBackgroundShaderManager::FillSdfShapeQuad(const AbstractRenderer::Vertex& minVertex,
+	const AbstractRenderer::Vertex& maxVertex,
+	float scale, std::vector<float>& vec) const
+{
+	const auto q = BackgroundShaderManager::CalcSdfShapeQuad(this->shape, this->roundCornerRadius,
+		this->canvasW, this->canvasH, minVertex, maxVertex, scale);
+
+	this->AddSdfVertex(q.minX, q.minY, -q.extX, -q.extY, q, vec);
+	this->AddSdfVertex(q.maxX, q.minY, q.extX, -q.extY, q, vec);
+	this->AddSdfVertex(q.minX, q.maxY, -q.extX, q.extY, q, vec);
+
+	if (this->indexedQuads)
+	{
+		//triangles (a, b, d), (b, c, d) are in index buffer
+		this->AddSdfVertex(q.maxX, q.maxY, q.extX, q.extY, q, vec);
+		return;
+	}
+
+	this->AddSdfVertex(q.maxX, q.minY, q.extX, -q.extY, q, vec);
+	this->AddSdfVertex(q.maxX, q.maxY, q.extX, q.extY, q, vec);
+	this->AddSdfVertex(q.minX, q.maxY, -q.extX, q.extY, q, vec);
+}
+
+void SingleColorBackgroundShaderManager::AddSdfVertex(float x, float y, float lx, float ly,
+	const BackgroundShaderManager::SdfShapeQuad& q, std::vector<float>& vec) const
+{
+	vec.push_back(x); vec.push_back(y);
+	vec.push_back(lx); vec.push_back(ly);
+	vec.push_back(q.halfW); vec.push_back(q.halfH); vec.push_back(q.radius);
+}
@@ -7,11 +7,16 @@
 #include "../../Renderers/AbstractRenderer.h"
 
 #include "./IShaderManager.h"
+#include "./BackgroundShaderManager.h"
 
+/// <summary>
+/// Shader manager for backgrounds with one color
+/// SDF shape mode is the same as in BackgroundShaderManager
+/// </summary>
 class SingleColorBackgroundShaderManager : public IShaderManager
 {
 public:
-    SingleColorBackgroundShaderManager();
+    SingleColorBackgroundShaderManager(bool sdfShape = false);
     virtual ~SingleColorBackgroundShaderManager() = default;
 
     virtual const char* GetVertexShaderSource() const override;
@@ -23,6 +28,7 @@ public:
    
     void SetColor(float r, float g, float b, float a);
     void SetShape(BackgroundSettings::Shape shape, float radius = 0.0);
+    bool IsSdfShape() const;
 
     int GetQuadVertices() const override;
 
@@ -39,8 +45,12 @@ public:
 
 protected:
     GLint positionLocation;
+    GLint localLocation;
+    GLint shapeLocation;
     GLint colorUniform;
 
+    bool sdfShape;
+
     float r, g, b, a;
     BackgroundSettings::Shape shape;
     float roundCornerRadius;
@@ -52,7 +62,13 @@ protected:
     void FillRoundCornersQuad(float cx, float cy, float dx, float dy, float rx, float ry, std::vector<float>& vec) const;
     void FillCircle(float cx, float cy, float rx, float ry, std::vector<float>& vec) const;
 
+    void FillSdfShapeQuad(const AbstractRenderer::Vertex& minVertex,
+        const AbstractRenderer::Vertex& maxVertex,
+        float scale, std::vector<float>& vec) const;
+
     void AddVertex(float x, float y, std::vector<float>& vec) const;
+    void AddSdfVertex(float x, float y, float lx, float ly, 
+        const BackgroundShaderManager::SdfShapeQuad& q, std::vector<float>& vec) const;
 };
 
 
@@ -1,5 +1,7 @@
 #include "./SingleColorFontShaderManager.h"
 
+#include <typeinfo>
+
 #include "./Shaders.h"
 
 #include "./SdfShaderSupport.h"
@@ -14,6 +16,7 @@ SingleColorFontShaderManager::SingleColorFontShaderManager(std::optional<SDF> sd
 	b(1.0f),
 	a(1.0f)
 {
+	this->SetIndexedQuads(true);
 }
 
 const char* SingleColorFontShaderManager::GetVertexShaderSource() const
@@ -87,9 +90,23 @@ void SingleColorFontShaderManager::PreRender()
 {	
 }
 
+bool SingleColorFontShaderManager::CanBatchWith(const IShaderManager* sm) const
+{
+	if ((sm == nullptr) || (typeid(*sm) != typeid(*this)))
+	{
+		return false;
+	}
+
+	auto o = static_cast<const SingleColorFontShaderManager*>(sm);
+
+	return (this->r == o->r) && (this->g == o->g) && (this->b == o->b) && (this->a == o->a) &&
+		(this->indexedQuads == o->indexedQuads) &&
+		SdfShaderSupport::IsSame(this->sdf.get(), o->sdf.get());
+}
+
 int SingleColorFontShaderManager::GetQuadVertices() const
 {
-	return 6;
+	return (this->indexedQuads) ? 4 : 6;
 }
 
 void SingleColorFontShaderManager::FillQuadVertexData(
@@ -114,6 +131,14 @@ void SingleColorFontShaderManager::FillQuadVertexData(
 	vec.push_back(minX); vec.push_back(maxY);
 	vec.push_back(minVertex.u); vec.push_back(maxVertex.v);
 	
+	if (this->indexedQuads)
+	{
+		//only c is added, triangles (a, b, d), (b, c, d) are in index buffer
+		vec.push_back(maxX); vec.push_back(maxY);
+		vec.push_back(maxVertex.u); vec.push_back(maxVertex.v);
+		return;
+	}
+
 	//========================================================
 	//========================================================
 
@@ -28,6 +28,7 @@ public:
 	void SetColor(float r, float g, float b, float a);
 
 	int GetQuadVertices() const override;
+	bool CanBatchWith(const IShaderManager* sm) const override;
 
 	void FillQuadVertexData(const AbstractRenderer::Vertex & minVertex,
 						const AbstractRenderer::Vertex & maxVertex,
@@ -13,6 +13,18 @@
 #	define THREAD_SAFETY
 #endif
 
+//Route FONT_BIND_* / FONT_UNBIND_* macros through GLStateCache
+//redundant binds are skipped (see Backends/GLStateCache.h)
+//#ifndef USE_GL_STATE_CACHE
+//#	define USE_GL_STATE_CACHE
+//#endif
+
+//Use recording OpenGL implementation instead of real OpenGL (headless runs, eg. CI without GPU)
+//calls are logged and uploaded bytes are counted (see Backends/GLRecorder.h)
+//#ifndef USE_GL_RECORDER
+//#	define USE_GL_RECORDER
+//#endif
+
 //Path to this can be changes - eg. if you are not using freeglut - include OpenGL here
 //if you want to move strings change dir here
 //the same goes if you want to move lodepng
@@ -25,18 +37,22 @@
 
 #include "./TextureBuilders/lodepng.h"
 
-
-#include "./freeglut/include/GL/wgl/glew.h"
-#include "./freeglut/include/GL/wgl/wglew.h"
-#include "./freeglut/include/GL/glut.h"
+#ifdef USE_GL_RECORDER
+#	include "./Backends/GLRecorder.h"
+#else
+#	include "./freeglut/include/GL/wgl/glew.h"
+#	include "./freeglut/include/GL/wgl/wglew.h"
+#	include "./freeglut/include/GL/glut.h"
+#endif
 
 #ifdef USE_ICU_LIBRARY
 #	include <unicode/unistr.h>
 #	include <unicode/schriter.h>
-#	include "./Unicode/BidiHelper.h"
 #	include "./Unicode/ICUUtils.h"
 #endif
 
+#include "./Unicode/BidiHelper.h"
+
 
 #include "./Utils/utf8/utf8.h"
 
@@ -115,14 +131,38 @@ static void CheckOpenGLError(const char* stmt, const char* fname, int line)
 
 //You can override here binding / unbinding of OpenGL things and 
 //use your own management system
-#define FONT_BIND_SHADER(id) GL_CHECK(glUseProgram(id))
-#define FONT_UNBIND_SHADER GL_CHECK(glUseProgram(0))
-#define FONT_BIND_VAO(id) GL_CHECK(glBindVertexArray(id))
-#define FONT_UNBIND_VAO GL_CHECK(glBindVertexArray(0))
-#define FONT_BIND_ARRAY_BUFFER(id) GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, id))
-#define FONT_UNBIND_ARRAY_BUFFER GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0))
-#define FONT_BIND_TEXTURE_2D(id) GL_CHECK(glBindTexture(GL_TEXTURE_2D, id))
-#define FONT_UNBIND_TEXTURE_2D GL_CHECK(glBindTexture(GL_TEXTURE_2D, 0))
+//Objects that can be bound are deleted with FONT_DELETE_*,
+//so the management system can forget their bindings
+#ifdef USE_GL_STATE_CACHE
+#	include "./Backends/GLStateCache.h"
+#	define FONT_BIND_SHADER(id) GLStateCache::GetCurrent()->UseProgram(id)
+#	define FONT_UNBIND_SHADER GLStateCache::GetCurrent()->UnbindProgram()
+#	define FONT_BIND_VAO(id) GLStateCache::GetCurrent()->BindVertexArray(id)
+#	define FONT_UNBIND_VAO GLStateCache::GetCurrent()->UnbindVertexArray()
+#	define FONT_BIND_ARRAY_BUFFER(id) GLStateCache::GetCurrent()->BindArrayBuffer(id)
+#	define FONT_UNBIND_ARRAY_BUFFER GLStateCache::GetCurrent()->UnbindArrayBuffer()
+#	define FONT_ACTIVE_TEXTURE(unit) GLStateCache::GetCurrent()->ActiveTexture(unit)
+#	define FONT_BIND_TEXTURE_2D(id) GLStateCache::GetCurrent()->BindTexture2D(id)
+#	define FONT_UNBIND_TEXTURE_2D GLStateCache::GetCurrent()->UnbindTexture2D()
+#	define FONT_DELETE_PROGRAM(id) GLStateCache::GetCurrent()->DeleteProgram(id)
+#	define FONT_DELETE_VAO(id) GLStateCache::GetCurrent()->DeleteVertexArray(id)
+#	define FONT_DELETE_BUFFER(id) GLStateCache::GetCurrent()->DeleteBuffer(id)
+#	define FONT_DELETE_TEXTURE(id) GLStateCache::GetCurrent()->DeleteTexture(id)
+#else
+#	define FONT_BIND_SHADER(id) GL_CHECK(glUseProgram(id))
+#	define FONT_UNBIND_SHADER GL_CHECK(glUseProgram(0))
+#	define FONT_BIND_VAO(id) GL_CHECK(glBindVertexArray(id))
+#	define FONT_UNBIND_VAO GL_CHECK(glBindVertexArray(0))
+#	define FONT_BIND_ARRAY_BUFFER(id) GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, id))
+#	define FONT_UNBIND_ARRAY_BUFFER GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0))
+#	define FONT_ACTIVE_TEXTURE(unit) GL_CHECK(glActiveTexture(unit))
+#	define FONT_BIND_TEXTURE_2D(id) GL_CHECK(glBindTexture(GL_TEXTURE_2D, id))
+#	define FONT_UNBIND_TEXTURE_2D GL_CHECK(glBindTexture(GL_TEXTURE_2D, 0))
+#	define FONT_DELETE_PROGRAM(id) GL_CHECK(glDeleteProgram(id))
+#	define FONT_DELETE_VAO(id) GL_CHECK(glDeleteVertexArrays(1, &(id)))
+#	define FONT_DELETE_BUFFER(id) GL_CHECK(glDeleteBuffers(1, &(id)))
+#	define FONT_DELETE_TEXTURE(id) GL_CHECK(glDeleteTextures(1, &(id)))
+#endif
 
 
 #ifdef TARGET_COMPUTER
@@ -212,6 +212,9 @@ struct RenderSettings
 
 	//OpenGL related
 	bool useTextureLinearFilter = false;
+	bool useQuantizedVertices = false; //int16 position, uint16 texel, RGBA8 color (default shader)
+	bool useAsyncTextureUpload = false; //font texture is updated through pixel buffer objects (OpenGL ES 3)
+	bool useViewTransform = false; //vertices are in pixels, canvas size, pan and zoom are applied in vertex shader (see AbstractRenderer::SetView)
 
 #ifdef __ANDROID_API__
 	int glVersion = GetDefaultGlversion();
@@ -253,11 +256,9 @@ struct SDF
 
 struct Shadow 
 {
-	float blurRadius = 0.03f;
+	float blurRadius = 0.03f; //blur size in pixels (2 * sigma of Gaussian)
 
-	float shadowPaddingSize = 0.2f; //size of shadow padding area around the background
-
-	float dirX = 0.0f;
+	float dirX = 0.0f; //shadow is moved by -dir * background size (Y is up)
 	float dirY = 0.05f;
 
 	Color color = Color(0, 0, 0, 0.65f);
@@ -294,6 +295,9 @@ struct BackgroundSettings
 							   
 	std::optional<Shadow> shadow = std::nullopt;
 	Shape shape = Shape::SQUARE;
+
+	bool sdfShape = false; //every background is one quad, shape is evaluated in pixel shader
+						   //(used by default color backgrounds, all are rendered with one draw call)
 };
 
 /// <summary>
@@ -394,5 +398,48 @@ struct AABB
 
 };
 
+/// <summary>
+/// Rectangle of texture in pixels (eg. changed part of font atlas)
+/// </summary>
+struct TextureRegion
+{
+	uint16_t x = 0;
+	uint16_t y = 0;
+	uint16_t w = 0;
+	uint16_t h = 0;
+
+	bool IsEmpty() const noexcept
+	{
+		return (w == 0) || (h == 0);
+	}
+
+	void Update(int px, int py, int pw, int ph) noexcept
+	{
+		if ((pw <= 0) || (ph <= 0))
+		{
+			return;
+		}
+
+		if (this->IsEmpty())
+		{
+			x = static_cast<uint16_t>(px);
+			y = static_cast<uint16_t>(py);
+			w = static_cast<uint16_t>(pw);
+			h = static_cast<uint16_t>(ph);
+			return;
+		}
+
+		const int minX = std::min<int>(x, px);
+		const int minY = std::min<int>(y, py);
+		const int maxX = std::max<int>(x + w, px + pw);
+		const int maxY = std::max<int>(y + h, py + ph);
+
+		x = static_cast<uint16_t>(minX);
+		y = static_cast<uint16_t>(minY);
+		w = static_cast<uint16_t>(maxX - minX);
+		h = static_cast<uint16_t>(maxY - minY);
+	}
+};
+
 
 #endif
@@ -52,6 +52,12 @@ AbstractRenderer::AbstractRenderer(std::shared_ptr<IFontBuilder> fb,
 {
 
 	this->backend->SetMainRenderer(this);
+
+	if (this->backend->GetSettings().useViewTransform)
+	{
+		//visible area changes with view
+		this->checkVisibility = false;
+	}
 	
 	this->SetCaption(u8"\u2022", 10);			
 }
@@ -69,6 +75,9 @@ AbstractRenderer::~AbstractRenderer()
 /// If test is disabled, we "render" all strings
 /// Can be disabled, if we check it before or know that all strings are visible
 /// (in this case the test is useless)
+/// With view transform (RenderSettings::useViewTransform), test is disabled by default,
+/// if enabled, strings outside canvas at the time of geometry generation are not visible
+/// after pan or zoom
 /// </summary>
 /// <param name="val"></param>
 void AbstractRenderer::SetVisibilityCheck(bool val) noexcept
@@ -108,18 +117,66 @@ void AbstractRenderer::SetExtraGlyphSpacingSize(int sizeInPixels)
 	this->extraGlyphSpacingSize = sizeInPixels;
 }
 
+/// <summary>
+/// Enable / disable per-pass timing of backend
+/// (CPU times, GPU times if backend supports them)
+/// </summary>
+/// <param name="val"></param>
+void AbstractRenderer::SetProfilingEnabled(bool val)
+{
+	this->backend->SetProfilingEnabled(val);
+}
+
+/// <summary>
+/// Set canvas size
+/// With view transform, geometry is generated again only 
+/// if layout depends on canvas (see IsLayoutCanvasDependent)
+/// </summary>
+/// <param name="w"></param>
+/// <param name="h"></param>
 void AbstractRenderer::SetCanvasSize(int w, int h)
 {
 	this->backend->SetCanvasSize(w, h);
 
-	this->strChanged = true;
+	this->strChanged |= this->IsLayoutCanvasDependent();
 }
 
 void AbstractRenderer::SwapCanvasWidthHeight()
 {
 	this->backend->SwapCanvasWidthHeight();
 	
-	this->strChanged = true;
+	this->strChanged |= this->IsLayoutCanvasDependent();
+}
+
+/// <summary>
+/// Set view (pan and zoom) of geometry
+/// Used only with view transform (RenderSettings::useViewTransform), 
+/// geometry is not generated again, only shader uniform is changed
+/// Position on canvas = position * zoom + (x, y)
+/// </summary>
+/// <param name="x">translation in pixels</param>
+/// <param name="y">translation in pixels</param>
+/// <param name="zoom"></param>
+void AbstractRenderer::SetView(float x, float y, float zoom)
+{
+	this->backend->SetView(x, y, zoom);
+}
+
+/// <summary>
+/// Test if generated geometry depends on canvas size
+/// Without view transform, positions are normalized by canvas size
+/// With view transform, positions are in pixels - only flip of y axis
+/// (AxisYOrigin::DOWN) and visibility test use canvas
+/// </summary>
+/// <returns></returns>
+bool AbstractRenderer::IsLayoutCanvasDependent() const
+{
+	if (this->backend->GetSettings().useViewTransform == false)
+	{
+		return true;
+	}
+
+	return (this->axisYOrigin == AxisYOrigin::DOWN) || (this->checkVisibility);
 }
 
 void AbstractRenderer::SetAxisYOrigin(AxisYOrigin axisY)
@@ -153,6 +210,15 @@ int AbstractRenderer::GetCaptionOffset() const
 	return this->ci.offset;
 }
 
+/// <summary>
+/// Get stats of last rendered frames
+/// </summary>
+/// <returns>nullptr if profiling is disabled</returns>
+const RenderProfiler* AbstractRenderer::GetProfiler() const
+{
+	return this->backend->GetProfiler();
+}
+
 
 /// <summary>
 /// Remove all added strings
@@ -3,6 +3,7 @@
 
 class IFontBuilder;
 class BackendBase;
+class RenderProfiler;
 
 #include <vector>
 #include <list>
@@ -66,6 +67,7 @@ public:
 
 	std::shared_ptr<IFontBuilder> GetFontBuilder();
 	void SetCanvasSize(int w, int h);
+	void SetView(float x, float y, float zoom);
 		
 	void SetAxisYOrigin(AxisYOrigin axisY);
 	void SetCaption(const StringUtf8& mark);
@@ -73,11 +75,13 @@ public:
 	void SetCaptionOffset(int offsetInPixels);
 	void SetBackgroundSettings(std::optional<BackgroundSettings> bs);
 	void SetExtraGlyphSpacingSize(int sizeInPixels);
+	void SetProfilingEnabled(bool val);
 
 	const RenderSettings& GetRenderSettings() const;
 	int GetCanvasWidth() const;
 	int GetCanvasHeight() const;
 	int GetCaptionOffset() const;
+	const RenderProfiler* GetProfiler() const;
 
 	
 	void SwapCanvasWidthHeight();
@@ -90,6 +94,7 @@ public:
 	friend class BackendBase;
 	friend class BackendImage;
 	friend class BackendOpenGL;
+	friend class BatchCompositorOpenGL;
 
 protected:
 
@@ -107,6 +112,8 @@ protected:
 	bool checkVisibility;
 	bool strChanged;
 
+	bool IsLayoutCanvasDependent() const;
+
 	AxisYOrigin axisYOrigin;
 	int extraGlyphSpacingSize;
 				
@@ -2,22 +2,55 @@
 
 #include <limits>
 #include <algorithm>
+#include <charconv>
+#include <cmath>
 
 #include "../TextureBuilders/IFontBuilder.h"
 
 #include "../Backends/Shaders/DefaultFontShaderManager.h"
 #include "../Backends/Shaders/SingleColorFontShaderManager.h"
+#include "../Backends/Shaders/InstancedNumberShaderManager.h"
 
 #include "../Backends/BackendBase.h"
 #include "../Backends/BackendOpenGL.h"
 
-const std::string NumberRenderer::NUMBERS_STRING = "0123456789,.-";
+const std::string NumberRenderer::NUMBERS_STRING = "0123456789,.-+e";
 
-const std::array<uint64_t, 10> NumberRenderer::INT_DIVISORS = {
-	1U, 100U, 1'000U, 10'000U, 100'000U, 1'000'000U,
-	10'000'000U, 100'000'000U, 1'000'000'000U, 10'000'000'000U
+/// <summary>
+/// Digits of all 1, 2 and 3 digits groups (with leading zeroes)
+/// Group with value v and n digits is at index GROUP_OFFSET[n] + v
+/// </summary>
+struct DigitGroup
+{
+	uint8_t digits[3];
+	uint8_t count;
 };
 
+static constexpr std::array<size_t, 4> GROUP_OFFSET = { 0, 0, 10, 110 };
+
+static constexpr std::array<DigitGroup, 1110> DIGIT_GROUPS = []() {
+	std::array<DigitGroup, 1110> groups = {};
+
+	for (uint8_t count = 1; count <= 3; count++)
+	{
+		const uint32_t maxVal = (count == 1) ? 10 : ((count == 2) ? 100 : 1000);
+		for (uint32_t v = 0; v < maxVal; v++)
+		{
+			DigitGroup& g = groups[GROUP_OFFSET[count] + v];
+			g.count = count;
+
+			uint32_t tmp = v;
+			for (int i = count - 1; i >= 0; i--)
+			{
+				g.digits[i] = static_cast<uint8_t>(tmp % 10);
+				tmp /= 10;
+			}
+		}
+	}
+
+	return groups;
+}();
+
 /// <summary>
 /// Create optimized Number renderer that will use only one color for every number
 /// If we pass color parameter during AddNumber... method call,
@@ -43,7 +76,27 @@ NumberRenderer * NumberRenderer::CreateSingleColor(Color color, const FontBuilde
 NumberRenderer* NumberRenderer::CreateDefault(const FontBuilderSettings& fs,
 	const RenderSettings& r)
 {
-	auto sm = std::make_shared<DefaultFontShaderManager>(fs.sdf);
+	auto sm = std::make_shared<DefaultFontShaderManager>(fs.sdf, r.useQuantizedVertices);
+
+	auto backend = std::make_unique<BackendOpenGL>(r, nullptr, nullptr, sm);
+
+	return new NumberRenderer(fs, std::move(backend));
+}
+
+/// <summary>
+/// Create Number renderer that renders every number as one instance
+/// Glyph quads are generated on GPU from packed glyph codes,
+/// so geometry has only 9 floats per number
+/// Numbers longer than 16 glyphs are split to more instances
+/// Limitations: caption mark, backgrounds and render size threshold are not used
+/// </summary>
+/// <param name="fs"></param>
+/// <param name="r"></param>
+/// <returns></returns>
+NumberRenderer* NumberRenderer::CreateInstanced(const FontBuilderSettings& fs,
+	const RenderSettings& r)
+{
+	auto sm = std::make_shared<InstancedNumberShaderManager>(fs.sdf);
 
 	auto backend = std::make_unique<BackendOpenGL>(r, nullptr, nullptr, sm);
 
@@ -59,22 +112,22 @@ NumberRenderer* NumberRenderer::CreateDefault(const FontBuilderSettings& fs,
 /// <param name="glVersion"></param>
 NumberRenderer::NumberRenderer(const FontBuilderSettings& fs, std::unique_ptr<BackendBase>&& backend) :
 	AbstractRenderer(fs, std::move(backend)),
-	decimalPlaces(0),
-	decimalMult(1),
 	checkIfExist(true),
 	overlapCheck(false),
-	enlargePercent(0.0f)
+	enlargePercent(0.0f),
+	decimalPlaces(0),
+	exponentNotation(false)
 {
 	this->Init();
 }
 
 NumberRenderer::NumberRenderer(std::shared_ptr<IFontBuilder> fb, std::unique_ptr<BackendBase>&& backend) :
 	AbstractRenderer(fb, std::move(backend)),
-	decimalPlaces(0),
-	decimalMult(1),
 	checkIfExist(true),
 	overlapCheck(false),
-	enlargePercent(0.0f)
+	enlargePercent(0.0f),
+	decimalPlaces(0),
+	exponentNotation(false)
 {
 	this->Init();
 }
@@ -130,7 +183,7 @@ void NumberRenderer::Init()
 		}
 
 		
-		this->gi[c] = *g;
+		this->gi[static_cast<uint8_t>(c)] = *g;
 	}
 
 
@@ -158,47 +211,46 @@ void NumberRenderer::Init()
 	this->newLineOffset = this->fb->GetMaxNewLineOffset();	
 
 	this->Precompute();
+
+	//instanced rendering - fill glyph table of shader
+	if (auto gl = dynamic_cast<BackendOpenGL*>(this->backend.get()))
+	{
+		this->instancedSm = std::dynamic_pointer_cast<InstancedNumberShaderManager>(gl->GetShaderManager());
+	}
+
+	if (this->instancedSm)
+	{
+		for (uint8_t i = 0; i < InstancedNumberShaderManager::GLYPH_CODES; i++)
+		{
+			this->instancedSm->SetGlyph(i, this->gi[static_cast<uint8_t>(InstancedNumberShaderManager::CODE_CHARS[i])]);
+		}
+	}
 }
 
 
 /// <summary>
-/// Precompute array of double-digits glyphs
+/// Precompute glyphs, AABBs and advances of all 1 - 3 digits groups
+/// Digits are taken from compile-time table DIGIT_GROUPS
 /// </summary>
 void NumberRenderer::Precompute()
 {
-	char digits[20];
-	for (int i = 0; i < 100; i++)
+	for (size_t i = 0; i < GROUPS_COUNT; i++)
 	{
-		int lastDigit = 0;
-		int intPart = i;
-
-		do
-		{
-			digits[lastDigit] = (intPart % 10);
-			lastDigit++;
-			intPart /= 10;
-		} while (intPart);
-
-		this->precomputed[i].gi[0] = &this->gi['0'];
-		this->precomputed[i].gi[1] = this->precomputed[i].gi[0];
-
-		while (lastDigit > 0)
-		{
-			lastDigit--;			
-			this->precomputed[i].gi[lastDigit] = &this->gi[digits[lastDigit] + '0'];
-		}
+		const DigitGroup& g = DIGIT_GROUPS[i];
+		Precomputed& p = this->precomputed[i];
 
+		p.count = g.count;
+		p.aabb = AABB();
 		
-		//precompute AABBs for double numbers
-		int x = 0;		
-		for (int j = 0; j < 2; j++)
+		int x = 0;
+		for (int j = 0; j < g.count; j++)
 		{
-			const GlyphInfo * gi = this->precomputed[i].gi[j];
-			this->precomputed[i].aabb.Update(x + gi->bmpX, -gi->bmpY, gi->bmpW, gi->bmpH);			
+			const GlyphInfo * gi = &this->gi[g.digits[j] + '0'];
+			p.gi[j] = gi;
+			p.aabb.Update(x + gi->bmpX, -gi->bmpY, gi->bmpW, gi->bmpH);
 			x += gi->adv;
 		}
-		this->precomputed[i].xOffset = x;
-
+		p.xOffset = x;
 	}
 }
 
@@ -235,16 +287,24 @@ void NumberRenderer::SetOverlapCheck(bool val, float enlargePercent) noexcept
 
 /// <summary>
 /// Set precision for decimal part in digits count
+/// Precision is clamped to [0, MAX_DECIMAL_PLACES]
+/// Numbers are correctly rounded to this precision
 /// </summary>
 /// <param name="digits"></param>
 void NumberRenderer::SetDecimalPrecission(int digits) noexcept
 {
-    if (this->decimalPlaces == digits)
-    {
-        return;
-    }
-	this->decimalPlaces = digits;
-	this->decimalMult = std::pow(10, decimalPlaces);
+	this->decimalPlaces = std::clamp(digits, 0, MAX_DECIMAL_PLACES);
+}
+
+/// <summary>
+/// Set whether float numbers are shown in exponent notation (eg. 1.5e+07)
+/// Numbers with integer part that does not fit to uint64_t
+/// are always shown in exponent notation
+/// </summary>
+/// <param name="val"></param>
+void NumberRenderer::SetExponentNotation(bool val) noexcept
+{
+	this->exponentNotation = val;
 }
 
 
@@ -278,20 +338,167 @@ void NumberRenderer::Clear()
 	AbstractRenderer::Clear();
 	this->nmbrs.clear();
 	this->nmbrsAABB.clear();
+	this->nmbrsKeys.clear();
+	this->nmbrsGrid.Clear();
+}
+
+
+/// <summary>
+/// Add persistent number slot with initial value 0
+/// Slot is not removed by Clear and its value can be changed
+/// with UpdateValue without rebuilding the other geometry
+/// Visibility, existence and overlap checks are not used for slots
+/// </summary>
+/// <param name="x"></param>
+/// <param name="y"></param>
+/// <param name="maxLength">max number of glyphs (digits, sign, decimal point...)</param>
+/// <param name="rp"></param>
+/// <param name="anchor"></param>
+/// <returns>slot index</returns>
+size_t NumberRenderer::AddNumberSlot(int x, int y, int maxLength,
+	const RenderParams& rp, TextAnchor anchor)
+{
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(m);
+#endif
+
+	if (this->axisYOrigin == AbstractRenderer::AxisYOrigin::DOWN)
+	{
+		y = this->backend->GetSettings().deviceH - y;
+	}
+
+	NumberSlot slot;
+	slot.info = NumberInfo(rp, anchor, TextType::TEXT);
+	slot.maxLength = std::max(maxLength, 1);
+	slot.geomStart = 0;
+	slot.geomEnd = 0;
+
+	this->FormatIntegral(false, 0, slot.info);
+
+	AABB aabb = this->CalcNumberAABB(slot.info, x, y);
+	slot.info.x = static_cast<int16_t>(x);
+	slot.info.y = static_cast<int16_t>(y);
+	slot.info.w = static_cast<int16_t>(aabb.GetWidth());
+	slot.info.h = static_cast<int16_t>(aabb.GetHeight());
+
+	this->slots.push_back(slot);
+
+	this->strChanged = true;
+
+	return this->slots.size() - 1;
+}
+
+/// <summary>
+/// Remove all number slots
+/// </summary>
+void NumberRenderer::RemoveNumberSlots()
+{
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(m);
+#endif
+
+	this->slots.clear();
+	this->strChanged = true;
+}
+
+size_t NumberRenderer::GetNumberSlotsCount() const noexcept
+{
+	return this->slots.size();
+}
+
+/// <summary>
+/// Set formatted value to slot and rewrite its quads
+/// If geometry can not be rewritten (eg. glyphs are skipped
+/// by render size threshold), entire geometry is rebuilt
+/// </summary>
+/// <param name="slot"></param>
+/// <param name="n">formatted value</param>
+/// <returns></returns>
+bool NumberRenderer::UpdateSlot(size_t slot, const NumberInfo& n)
+{
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(m);
+#endif
+
+	if (slot >= this->slots.size())
+	{
+		return false;
+	}
+
+	NumberSlot& s = this->slots[slot];
+
+	if (this->GetGlyphsCount(n) > s.maxLength)
+	{
+		return false;
+	}
+
+	NumberInfo& info = s.info;
+	info.intPart = n.intPart;
+	info.fractPart = n.fractPart;
+	info.exponent = n.exponent;
+	info.intDigits = n.intDigits;
+	info.fractDigits = n.fractDigits;
+	info.negative = n.negative;
+	info.hasExponent = n.hasExponent;
+
+	AABB aabb = this->CalcNumberAABB(info, info.x, info.y);
+	info.w = static_cast<int16_t>(aabb.GetWidth());
+	info.h = static_cast<int16_t>(aabb.GetHeight());
+
+	if (this->strChanged)
+	{
+		//entire geometry will be rebuilt
+		return true;
+	}
+
+	if (this->backend->RewriteGeometry(s.geomStart, s.geomEnd, [&]() {
+		this->AddSlotQuads(s);
+	}) == false)
+	{
+		this->strChanged = true;
+	}
+
+	return true;
 }
 
+/// <summary>
+/// Add quads of slot number
+/// Unused quads (up to maxLength) are filled with empty quads
+/// </summary>
+/// <param name="slot"></param>
+void NumberRenderer::AddSlotQuads(const NumberSlot& slot)
+{
+	if (this->instancedSm)
+	{
+		//slot has always instances for maxLength glyphs (unused are empty)
+		this->AddNumberInstance(slot.info, InstancedNumberShaderManager::GetInstancesCount(slot.maxLength));
+		return;
+	}
+
+	this->AddNumberQuads(slot.info);
+
+	int x, y;
+	this->GetAnchoredPosition(slot.info, x, y);
+
+	const GlyphInfo empty;
+	for (int i = this->GetGlyphsCount(slot.info); i < slot.maxLength; i++)
+	{
+		this->AddQuad(empty, x, y, slot.info.renderParams);
+	}
+}
 
 /// <summary>
 /// Add integer number - internal method
 /// This is called from template method based on type
 /// </summary>
-/// <param name="val"></param>
+/// <param name="negative"></param>
+/// <param name="absVal"></param>
 /// <param name="x"></param>
 /// <param name="y"></param>
 /// <param name="color"></param>
 /// <param name="anchor"></param>
 /// <param name="type"></param>
-bool NumberRenderer::AddIntegralNumberInternal(long val,
+bool NumberRenderer::AddIntegralNumberInternal(bool negative, uint64_t absVal,
 	int x, int y, const RenderParams & rp,
 	TextAnchor anchor, TextType type)
 {
@@ -300,38 +507,25 @@ bool NumberRenderer::AddIntegralNumberInternal(long val,
 		y = this->backend->GetSettings().deviceH - y;
 	}
 
-	if (this->checkIfExist)
+	NumberKey key(negative, absVal, x, y, anchor, type);
+
+	if ((this->checkIfExist) && (this->nmbrsKeys.contains(key)))
 	{
-		for (const NumberInfo & s : this->nmbrs)
-		{
-			if ((s.x == x) && (s.y == y) &&
-				(s.anchor == anchor) && (s.type == type))
-			{
-				if ((s.negative) && (-s.val == val))
-				{
-					//same number on the same position and with same align
-					//already exist - do not add it again
-					return false;
-				}
-				else if (s.val == val)
-				{
-					//same number on the same position and with same align
-					//already exist - do not add it again
-					return false;
-				}
-			}
-		}
+		//same number on the same position and with same align
+		//already exist - do not add it again
+		return false;
 	}
 
-	NumberInfo i(val, rp, anchor, type);				
-	i.intPartOrderIndex = this->GetIntDivisorIndex(i.intPart);	
+	NumberInfo i(rp, anchor, type);				
+	this->FormatIntegral(negative, absVal, i);
 
-	return this->AddNumber(i, x, y);	
+	return this->AddNumber(i, key, x, y);	
 }
 
 /// <summary>
 /// Add float number - internal method
 /// This is called from template method based on type
+/// NaN and infinity are not added
 /// </summary>
 /// <param name="val"></param>
 /// <param name="x"></param>
@@ -348,60 +542,34 @@ bool NumberRenderer::AddFloatNumberInternal(double val,
 		y = this->backend->GetSettings().deviceH - y;
 	}
 
-	if (this->checkIfExist)
+	NumberKey key(val, x, y, anchor, type);
+
+	if ((this->checkIfExist) && (this->nmbrsKeys.contains(key)))
 	{
-		for (const NumberInfo & s : this->nmbrs)
-		{
-			if ((s.x == x) && (s.y == y) &&
-				(s.anchor == anchor) && (s.type == type))
-			{
-				if ((s.negative) && (-s.val == val))
-				{
-					//same number on the same position and with same align
-					//already exist - do not add it again
-					return false;
-				}
-				else if (s.val == val)
-				{
-					//same number on the same position and with same align
-					//already exist - do not add it again
-					return false;
-				}
-			}
-		}
+		//same number on the same position and with same align
+		//already exist - do not add it again
+		return false;
 	}
 
-	NumberInfo i(val, rp, anchor, type);	
-	if (i.negative)
-	{		
-		val *= -1;
-	}	
-		
-	i.intPartOrderIndex = this->GetIntDivisorIndex(i.intPart);
-	i.fractPartReverse = this->GetFractPartReversed(val, i.intPart);
-
-	//remove negative zero
-	if ((i.negative) && (i.fractPartReverse == 0) && (i.intPart == 0))
+	NumberInfo i(rp, anchor, type);	
+	if (this->FormatFloat(val, i) == false)
 	{
-		i.negative = false;
+		return false;
 	}
 
-	return this->AddNumber(i, x, y);
+	return this->AddNumber(i, key, x, y);
 }
 
 /// <summary>
 /// Add new number 
 /// </summary>
 /// <param name="n"></param>
+/// <param name="key">key for existence check</param>
 /// <param name="x"></param>
 /// <param name="y"></param>
-/// <param name="color"></param>
-/// <param name="anchor"></param>
-/// <param name="type"></param>
-bool NumberRenderer::AddNumber(NumberInfo& n, int x, int y)
+bool NumberRenderer::AddNumber(NumberInfo& n, const NumberKey& key, int x, int y)
 {	
-	AABB aabb = this->CalcNumberAABB(n.val, x, y, n.negative,
-		n.intPart, n.intPartOrderIndex, n.fractPartReverse, n.renderParams.scale);
+	AABB aabb = this->CalcNumberAABB(n, x, y);
 
 	//test if entire string is outside visible area
 
@@ -427,28 +595,9 @@ bool NumberRenderer::AddNumber(NumberInfo& n, int x, int y)
 		if (aabb.minY > this->backend->GetSettings().deviceH) return false;
 	}
 
-	if (this->overlapCheck)
+	if ((this->overlapCheck) && (this->IsOverlapping(aabb)))
 	{
-		if (this->enlargePercent == 0.0f)
-		{
-			for (const auto& nmbrAABB : this->nmbrsAABB)
-			{
-				if (aabb.Intersect(nmbrAABB))
-				{
-					return false;
-				}
-			}
-		}
-		else 
-		{
-			for (const auto& nmbrAABB : this->nmbrsAABB)
-			{
-				if (aabb.IntersectEnlarged(nmbrAABB, this->enlargePercent))
-				{
-					return false;
-				}
-			}
-		}
+		return false;
 	}
 
 	//new number - add it
@@ -464,121 +613,372 @@ bool NumberRenderer::AddNumber(NumberInfo& n, int x, int y)
 	std::lock_guard<std::shared_timed_mutex> lk(m);
 #endif
 
+	this->StoreNumber(n, key, aabb);
+
+	return true;
+}
+
+/// <summary>
+/// Store already tested number
+/// and update structures for existence and overlap checks
+/// </summary>
+/// <param name="n"></param>
+/// <param name="key"></param>
+/// <param name="aabb"></param>
+void NumberRenderer::StoreNumber(const NumberInfo& n, const NumberKey& key, const AABB& aabb)
+{
 	this->nmbrs.push_back(n);
 
+	//key is stored even if existence check is disabled,
+	//so the check is valid after it is enabled again
+	this->nmbrsKeys.insert(key);
+
 	if (this->overlapCheck)
 	{
+		this->UpdateOverlapGrid();
+
+		this->nmbrsGrid.Add(aabb, static_cast<uint32_t>(this->nmbrsAABB.size()));
 		this->nmbrsAABB.push_back(aabb);
 	}
 
 	this->strChanged = true;
-
-	return true;
 }
 
 /// <summary>
-/// Reverse fraction part
-/// of positive number
+/// Add block of already formatted numbers - internal method
+/// Data are kept in separate arrays per property (one item per lane),
+/// so the simple per-lane loops can be vectorized by compiler.
+/// Existence and overlap checks depend on previously added numbers
+/// and are done in the final sequential pass
 /// </summary>
-/// <param name="val">entire number</param>
-/// <param name="intPart">integer part only</param>
-/// <returns></returns>
-uint32_t NumberRenderer::GetFractPartReversed(double val, uint32_t intPart) const noexcept
+/// <param name="infos">formatted numbers</param>
+/// <param name="keys">keys with values, position is filled here</param>
+/// <param name="xs"></param>
+/// <param name="ys"></param>
+/// <param name="count">at most BULK_LANES</param>
+/// <param name="rp"></param>
+/// <param name="anchor"></param>
+/// <returns>number of added numbers</returns>
+size_t NumberRenderer::AddNumbersInternal(NumberInfo* infos, NumberKey* keys,
+	const int* xs, const int* ys, size_t count,
+	const RenderParams& rp, TextAnchor anchor)
 {
-	double fractPart = val - intPart;
+	std::array<int, BULK_LANES> y;
+	std::array<AABB, BULK_LANES> aabb;
+	std::array<uint8_t, BULK_LANES> visible;
+
+	count = std::min(count, BULK_LANES);
 
-	//reversed number is without leading zeroes
-	//eg: 0.0157 => will reverse to 751
-	//but we need one leading zero
-	uint32_t fractPartReverse = this->ReversDigits((uint32_t)(fractPart * decimalMult));
-	if (fractPartReverse == 0)
+	const int deviceW = this->backend->GetSettings().deviceW;
+	const int deviceH = this->backend->GetSettings().deviceH;
+	const bool flipY = (this->axisYOrigin == AbstractRenderer::AxisYOrigin::DOWN);
+
+	for (size_t i = 0; i < count; i++)
 	{
-		return fractPartReverse;
+		y[i] = flipY ? (deviceH - ys[i]) : ys[i];
 	}
 
-	//calculate number of leading zeroes
-	int fractLeadingZeros = 0;	
-	while (fractPart < 1)
+	for (size_t i = 0; i < count; i++)
 	{
-		fractLeadingZeros++;
-		fractPart *= 10;
+		infos[i].renderParams = rp;
+		infos[i].anchor = anchor;
+		infos[i].type = TextType::TEXT;
+
+		aabb[i] = this->CalcNumberAABB(infos[i], xs[i], y[i]);
 	}
-	fractLeadingZeros--;
 
-	//move reversed part 
-	//751 => 7510
-	while (fractLeadingZeros > 0)
+	if (this->checkVisibility)
 	{
-		fractPartReverse *= 10;
-		fractLeadingZeros--;
+		if (anchor == TextAnchor::CENTER)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const float wHalf = aabb[i].GetWidth() / 2.0f;
+				const float hHalf = aabb[i].GetHeight() / 2.0f;
+
+				aabb[i].minX -= wHalf;
+				aabb[i].maxX -= wHalf;
+				aabb[i].minY -= hHalf;
+				aabb[i].maxY -= hHalf;
+			}
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			visible[i] = (aabb[i].maxX > 0) && (aabb[i].maxY > 0) &&
+				(aabb[i].minX <= deviceW) && (aabb[i].minY <= deviceH);
+		}
 	}
+	else
+	{
+		std::fill_n(visible.begin(), count, 1);
+	}
+
+	//final sequential pass - existence, overlap and append
+
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(m);
+#endif
+
+	size_t added = 0;
 
-	return fractPartReverse;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (visible[i] == 0)
+		{
+			continue;
+		}
+
+		NumberKey& key = keys[i];
+		key.x = xs[i];
+		key.y = y[i];
+
+		if ((this->checkIfExist) && (this->nmbrsKeys.contains(key)))
+		{
+			continue;
+		}
+
+		if ((this->overlapCheck) && (this->IsOverlapping(aabb[i])))
+		{
+			continue;
+		}
+
+		NumberInfo& n = infos[i];
+		n.x = static_cast<int16_t>(xs[i]);
+		n.y = static_cast<int16_t>(y[i]);
+		n.w = static_cast<int16_t>(aabb[i].GetWidth());
+		n.h = static_cast<int16_t>(aabb[i].GetHeight());
+
+		this->StoreNumber(n, key, aabb[i]);
+		added++;
+	}
+
+	return added;
 }
 
 /// <summary>
-/// Reverse digits in input number
-/// Input: 123
-/// Output: 321
+/// Test if aabb overlaps any already added number
+/// Only numbers from grid cells touched by the (enlarged) aabb are tested
 /// </summary>
-/// <param name="num"></param>
+/// <param name="aabb"></param>
 /// <returns></returns>
-uint32_t NumberRenderer::ReversDigits(uint32_t num) const noexcept
+bool NumberRenderer::IsOverlapping(const AABB& aabb)
 {
-	if (num < 10) return num;
+	this->UpdateOverlapGrid();
 
-	uint32_t rev_num = 0;
-	while (num > 0)
+	//IntersectEnlarged enlarges the tested box by its own size
+	const float ex = aabb.GetWidth() * this->enlargePercent;
+	const float ey = aabb.GetHeight() * this->enlargePercent;
+
+	if (this->enlargePercent == 0.0f)
 	{
-		rev_num = rev_num * 10 + num % 10;
-		num = num / 10;
+		return this->nmbrsGrid.AnyOf(aabb.minX, aabb.minY, aabb.maxX, aabb.maxY,
+			[&](uint32_t id) {
+			return aabb.Intersect(this->nmbrsAABB[id]);
+		});
 	}
-	return rev_num;
+
+	return this->nmbrsGrid.AnyOf(aabb.minX - ex, aabb.minY - ey, aabb.maxX + ex, aabb.maxY + ey,
+		[&](uint32_t id) {
+		return aabb.IntersectEnlarged(this->nmbrsAABB[id], this->enlargePercent);
+	});
 }
 
 /// <summary>
-/// Get starting integer divisor if integer is divided by 100
-/// to get first two digits
+/// (Re)build overlap grid if device size, font size or enlargePercent changed
+/// Cell size is based on typical number size (4 digits, one line)
 /// </summary>
-/// <param name="x"></param>
-/// <returns></returns>
-uint8_t NumberRenderer::GetIntDivisorIndex(const uint32_t x) const noexcept
+void NumberRenderer::UpdateOverlapGrid()
 {
-	if (x >= 10000U) {
-		if (x >= 10000000U) {
-			if (x >= 100000000U) {
-				if (x >= 1000000000U) return 9;
-				return 8;
-			}
-			return 7;
+	const float scale = 1.0f + 2.0f * this->enlargePercent;
+	const float cellW = 4.0f * (this->gi['0'].adv + this->extraGlyphSpacingSize) * scale;
+	const float cellH = static_cast<float>(this->newLineOffset) * scale;
+	const float w = static_cast<float>(this->backend->GetSettings().deviceW);
+	const float h = static_cast<float>(this->backend->GetSettings().deviceH);
+
+	if (this->nmbrsGrid.IsInited(w, h, cellW, cellH))
+	{
+		return;
+	}
+
+	this->nmbrsGrid.Init(w, h, cellW, cellH);
+	for (size_t i = 0; i < this->nmbrsAABB.size(); i++)
+	{
+		this->nmbrsGrid.Add(this->nmbrsAABB[i], static_cast<uint32_t>(i));
+	}
+}
+
+/// <summary>
+/// Convert float number to digits
+/// Number is printed with std::to_chars (exact and correctly rounded,
+/// no allocation) to local buffer and digits are parsed from it
+/// Fixed notation is used, unless exponent notation is enabled
+/// or integer part does not fit to uint64_t
+/// </summary>
+/// <param name="val"></param>
+/// <param name="n">output number</param>
+/// <returns>false for NaN and infinity</returns>
+bool NumberRenderer::FormatFloat(double val, NumberInfo& n) const noexcept
+{
+	if (std::isfinite(val) == false)
+	{
+		return false;
+	}
+
+	n.negative = std::signbit(val);
+	if (n.negative)
+	{
+		val = -val;
+	}
+
+	n.hasExponent = (this->exponentNotation) || (val >= 1e19);
+
+	char buf[FORMAT_BUFFER_SIZE];
+	auto res = std::to_chars(buf, buf + FORMAT_BUFFER_SIZE, val,
+		(n.hasExponent) ? std::chars_format::scientific : std::chars_format::fixed,
+		this->decimalPlaces);
+
+	if (res.ec != std::errc())
+	{
+		return false;
+	}
+
+	const char* c = buf;
+
+	n.intPart = 0;
+	n.intDigits = 0;
+	while ((c < res.ptr) && (*c >= '0') && (*c <= '9'))
+	{
+		n.intPart = n.intPart * 10 + (*c - '0');
+		n.intDigits++;
+		c++;
+	}
+
+	n.fractPart = 0;
+	n.fractDigits = 0;
+	if ((c < res.ptr) && (*c == '.'))
+	{
+		c++;
+		while ((c < res.ptr) && (*c >= '0') && (*c <= '9'))
+		{
+			n.fractPart = n.fractPart * 10 + (*c - '0');
+			n.fractDigits++;
+			c++;
 		}
-		if (x >= 100000U) {
-			if (x >= 1000000U) return 6;
-			return 5;
+	}
+
+	//remove trailing zeroes
+	while ((n.fractDigits > 0) && (n.fractPart % 10 == 0))
+	{
+		n.fractPart /= 10;
+		n.fractDigits--;
+	}
+
+	n.exponent = 0;
+	if ((c < res.ptr) && (*c == 'e'))
+	{
+		c++;
+		const bool expNegative = ((c < res.ptr) && (*c == '-'));
+		c++;
+
+		int exponent = 0;
+		while ((c < res.ptr) && (*c >= '0') && (*c <= '9'))
+		{
+			exponent = exponent * 10 + (*c - '0');
+			c++;
 		}
-		return 4;
+		n.exponent = static_cast<int16_t>(expNegative ? -exponent : exponent);
+	}
+
+	//remove negative zero
+	if ((n.intPart == 0) && (n.fractPart == 0))
+	{
+		n.negative = false;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Convert integer number to digits
+/// </summary>
+/// <param name="negative"></param>
+/// <param name="absVal"></param>
+/// <param name="n">output number</param>
+void NumberRenderer::FormatIntegral(bool negative, uint64_t absVal, NumberInfo& n) const noexcept
+{
+	n.negative = negative && (absVal != 0);
+	n.intPart = absVal;
+	n.intDigits = this->GetDigitsCount(absVal);
+	n.fractPart = 0;
+	n.fractDigits = 0;
+	n.exponent = 0;
+	n.hasExponent = false;
+}
+
+/// <summary>
+/// Get number of digits of integer (without branches)
+/// </summary>
+/// <param name="x"></param>
+/// <returns></returns>
+uint8_t NumberRenderer::GetDigitsCount(uint64_t x) const noexcept
+{
+	static constexpr uint64_t POW10[19] = {
+		10ULL, 100ULL, 1'000ULL, 10'000ULL, 100'000ULL,
+		1'000'000ULL, 10'000'000ULL, 100'000'000ULL, 1'000'000'000ULL,
+		10'000'000'000ULL, 100'000'000'000ULL, 1'000'000'000'000ULL,
+		10'000'000'000'000ULL, 100'000'000'000'000ULL, 1'000'000'000'000'000ULL,
+		10'000'000'000'000'000ULL, 100'000'000'000'000'000ULL,
+		1'000'000'000'000'000'000ULL, 10'000'000'000'000'000'000ULL
+	};
+
+	uint8_t count = 1;
+	for (uint64_t p : POW10)
+	{
+		count += (x >= p) ? 1 : 0;
 	}
-	if (x >= 100U) {
-		if (x >= 1000U) return 3;
-		return 2;
+	return count;
+}
+
+/// <summary>
+/// Split number to groups of 3 digits (first group can be shorter)
+/// Groups are in reading order
+/// </summary>
+/// <param name="v"></param>
+/// <param name="digits">number of digits of v (with leading zeroes)</param>
+/// <param name="groups">output groups, at least MAX_GROUPS</param>
+/// <returns>number of groups</returns>
+int NumberRenderer::SplitToGroups(uint64_t v, int digits, const Precomputed ** groups) const noexcept
+{
+	if (digits <= 0)
+	{
+		return 0;
+	}
+
+	const int count = std::min((digits + 2) / 3, MAX_GROUPS);
+	for (int i = count - 1; i > 0; i--)
+	{
+		groups[i] = &this->precomputed[GROUP_OFFSET[3] + v % 1000];
+		v /= 1000;
 	}
-	if (x >= 10U) return 1;
-	return 0;
+
+	const int firstDigits = std::min(digits - 3 * (count - 1), 3);
+	groups[0] = &this->precomputed[GROUP_OFFSET[firstDigits] + v % 1000];
+
+	return count;
 }
 
 /// <summary>
 /// Calculate AABB of number
 /// </summary>
-/// <param name="val"></param>
+/// <param name="n"></param>
 /// <param name="x"></param>
 /// <param name="y"></param>
-/// <param name="negative"></param>
-/// <param name="intPart"></param>
-/// <param name="fractPartReversed"></param>
 /// <returns></returns>
-AABB NumberRenderer::CalcNumberAABB(double val, int x, int y,
-	bool negative, uint32_t intPart, uint8_t intPartOrderIndex, uint32_t fractPartReversed, float scale)
+AABB NumberRenderer::CalcNumberAABB(const NumberInfo& n, int x, int y)
 {	
+	const float scale = n.renderParams.scale;
+
 	//store offsets
 	int xOffset = x;
 	int yOffset = y;
@@ -589,7 +989,7 @@ AABB NumberRenderer::CalcNumberAABB(double val, int x, int y,
 
 	AABB aabb;
 	
-	if (negative)
+	if (n.negative)
 	{
 		const GlyphInfo & gi = this->gi['-'];
 		
@@ -597,66 +997,54 @@ AABB NumberRenderer::CalcNumberAABB(double val, int x, int y,
 		x += static_cast<int>(gi.adv + this->extraGlyphSpacingSize);
 	}
 
-	if (intPart <= 9)
-	{
-		//one digit number
-		const GlyphInfo & gi = this->gi[intPart + '0'];
+	const Precomputed* groups[MAX_GROUPS];
 
-		aabb.Update(x + gi.bmpX, -gi.bmpY, gi.bmpW, gi.bmpH);
-		x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * scale);
-	}
-	else if (intPart <= 99)
+	int count = this->SplitToGroups(n.intPart, n.intDigits, groups);
+	for (int i = 0; i < count; i++)
 	{
-		//two digit number
-		const Precomputed& t = precomputed[intPart];		
-		
-		aabb.UnionWithOffset(t.aabb, static_cast<float>(x));
-		x += static_cast<int>((t.xOffset + this->extraGlyphSpacingSize) * scale);
-	}
-	else
-	{
-		uint64_t divisor = INT_DIVISORS[intPartOrderIndex];
-		do
-		{
-			divisor /= 100;
-			const auto tmp = intPart / divisor;
-			const Precomputed & t = precomputed[tmp];
-			
-			aabb.UnionWithOffset(t.aabb, static_cast<float>(x));
-			x += static_cast<int>((t.xOffset + this->extraGlyphSpacingSize) * scale);
-			
-			intPart = intPart - tmp * divisor;			
-
-		} while (divisor > 10);
+		const Precomputed& t = *groups[i];
 
-		if (divisor >= 10)
-		{
-			//one digit remaining number
-			const GlyphInfo & gi = this->gi[intPart + '0'];
-			
-			aabb.Update(x + gi.bmpX, -gi.bmpY, gi.bmpW, gi.bmpH);
-			x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * scale);
-			
-		}
+		aabb.UnionWithOffset(t.aabb, static_cast<float>(x));
+		x += static_cast<int>((t.xOffset + t.count * this->extraGlyphSpacingSize) * scale);
 	}
-
 	
-	if (fractPartReversed)
+	if (n.fractDigits)
 	{
 		const GlyphInfo & gi = this->gi['.'];
 		
 		aabb.Update(x + gi.bmpX, -gi.bmpY, gi.bmpW, gi.bmpH);
 		x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * scale);		
 		
-		while (fractPartReversed)
-		{			
-			const int cc = (fractPartReversed % 10);			
-			const GlyphInfo & gi = this->gi[cc + '0'];
-			
+		count = this->SplitToGroups(n.fractPart, n.fractDigits, groups);
+		for (int i = 0; i < count; i++)
+		{
+			const Precomputed& t = *groups[i];
+
+			aabb.UnionWithOffset(t.aabb, static_cast<float>(x));
+			x += static_cast<int>((t.xOffset + t.count * this->extraGlyphSpacingSize) * scale);
+		}
+	}
+
+	if (n.hasExponent)
+	{
+		const char expSymbols[2] = { 'e', (n.exponent < 0) ? '-' : '+' };
+		for (char c : expSymbols)
+		{
+			const GlyphInfo & gi = this->gi[static_cast<uint8_t>(c)];
+
 			aabb.Update(x + gi.bmpX, -gi.bmpY, gi.bmpW, gi.bmpH);
 			x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * scale);
-			
-			fractPartReversed /= 10;
+		}
+
+		//exponent has at least two digits
+		const uint64_t exponent = static_cast<uint64_t>(std::abs(n.exponent));
+		count = this->SplitToGroups(exponent, std::max<int>(this->GetDigitsCount(exponent), 2), groups);
+		for (int i = 0; i < count; i++)
+		{
+			const Precomputed& t = *groups[i];
+
+			aabb.UnionWithOffset(t.aabb, static_cast<float>(x));
+			x += static_cast<int>((t.xOffset + t.count * this->extraGlyphSpacingSize) * scale);
 		}
 	}
 	
@@ -701,121 +1089,262 @@ void NumberRenderer::GetAnchoredPosition(const NumberRenderer::NumberInfo & si,
 
 
 /// <summary>
-/// Generate geometry for all input numbers
+/// Add quads for all glyphs of precomputed group
 /// </summary>
-/// <returns></returns>
-bool NumberRenderer::GenerateGeometry()
+/// <param name="t"></param>
+/// <param name="x">start position, moved after the group</param>
+/// <param name="y"></param>
+/// <param name="rp"></param>
+void NumberRenderer::AddGroupQuads(const Precomputed& t, int& x, int y, const RenderParams& rp)
 {
-	if (this->strChanged == false)
+	for (int i = 0; i < t.count; i++)
 	{
-		return false;
+		const GlyphInfo& gi = *t.gi[i];
+
+		this->AddQuad(gi, x, y, rp);
+		x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * rp.scale);
 	}
-			
-	//Build geometry	
-	AbstractRenderer::Clear();
-	//this->geom.reserve(400);
+}
+
+/// <summary>
+/// Add quads for all glyphs of number
+/// </summary>
+/// <param name="si"></param>
+void NumberRenderer::AddNumberQuads(const NumberInfo& si)
+{
+	int x, y;
+	this->GetAnchoredPosition(si, x, y);
 	
-	for (const NumberRenderer::NumberInfo & si : this->nmbrs)
-	{		
-		int x, y;
-		this->GetAnchoredPosition(si, x, y);
+	if ((si.type == TextType::CAPTION_TEXT) || (si.type == TextType::CAPTION_SYMBOL))
+	{						
+		const int xx = si.x - (this->captionMark.bmpW) / 2;
+		const int yy = si.y + (this->captionMark.bmpH);
 		
-		if ((si.type == TextType::CAPTION_TEXT) || (si.type == TextType::CAPTION_SYMBOL))
-		{						
-			const int xx = si.x - (this->captionMark.bmpW) / 2;
-			const int yy = si.y + (this->captionMark.bmpH);
-			
-			this->AddQuad(this->captionMark, xx, yy, si.renderParams);
-		}
+		this->AddQuad(this->captionMark, xx, yy, si.renderParams);
+	}
+
+	if (si.negative)
+	{
+		const GlyphInfo& gi = this->gi['-'];
 
-		if (si.negative)
+		this->AddQuad(gi, x, y, si.renderParams);
+		x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);			
+	}				
+	
+	//==========================================================
+	//split number to groups of digits
+	//optimized conversion from number to "string (glyphs)"
+	
+	const Precomputed* groups[MAX_GROUPS];
+
+	int count = this->SplitToGroups(si.intPart, si.intDigits, groups);
+	for (int i = 0; i < count; i++)
+	{
+		this->AddGroupQuads(*groups[i], x, y, si.renderParams);
+	}
+	
+	//==========================================================
+
+	if (si.fractDigits)
+	{
+		const GlyphInfo& gi = this->gi['.'];
+
+		this->AddQuad(gi, x, y, si.renderParams);
+		x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
+					
+		count = this->SplitToGroups(si.fractPart, si.fractDigits, groups);
+		for (int i = 0; i < count; i++)
 		{
-			const GlyphInfo& gi = this->gi['-'];
+			this->AddGroupQuads(*groups[i], x, y, si.renderParams);
+		}
+	}
 
-			this->AddQuad(gi, x, y, si.renderParams);
-			x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);			
-		}				
-		
-		//==========================================================
-		//split number to double-digits
-		//optimized conversion from number to "string (glyphs)"
-		
-		uint32_t intPart = si.intPart;	
-		
-		if (intPart <= 9)
+	if (si.hasExponent)
+	{
+		const char expSymbols[2] = { 'e', (si.exponent < 0) ? '-' : '+' };
+		for (char c : expSymbols)
 		{
-			//one digit number
-			const GlyphInfo & gi = this->gi[intPart + '0'];
-			this->AddQuad(gi, x, y, si.renderParams);
+			const GlyphInfo& gi = this->gi[static_cast<uint8_t>(c)];
 
-			x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);			
+			this->AddQuad(gi, x, y, si.renderParams);
+			x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
 		}
-		else if (intPart <= 99)
+
+		//exponent has at least two digits
+		const uint64_t exponent = static_cast<uint64_t>(std::abs(si.exponent));
+		count = this->SplitToGroups(exponent, std::max<int>(this->GetDigitsCount(exponent), 2), groups);
+		for (int i = 0; i < count; i++)
 		{
-			//two digit number
-			const GlyphInfo* const* t = precomputed[intPart].gi;
+			this->AddGroupQuads(*groups[i], x, y, si.renderParams);
+		}
+	}
+}
 
-			this->AddQuad(*t[1], x, y, si.renderParams);
-			x += static_cast<int>((t[1]->adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
+/// <summary>
+/// Add number as instances (see CreateInstanced)
+/// Numbers with more than MAX_GLYPHS glyphs are split to more instances,
+/// pen position of next instance is advanced the same way as in vertex shader
+/// If number needs less than minInstancesCount instances, 
+/// rest is filled with empty instances
+/// </summary>
+/// <param name="si"></param>
+/// <param name="minInstancesCount"></param>
+void NumberRenderer::AddNumberInstance(const NumberInfo& si, int minInstancesCount)
+{
+	int x, y;
+	this->GetAnchoredPosition(si, x, y);
 
-			this->AddQuad(*t[0], x, y, si.renderParams);
-			x += static_cast<int>((t[0]->adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
+	char chars[MAX_NUMBER_GLYPHS];
+	const int count = this->GetGlyphChars(si, chars);
 
-		}
-		else				
-		{	
-			//at least three digits number
-			uint64_t divisor = INT_DIVISORS[si.intPartOrderIndex];
+	const int instancesCount = std::max(InstancedNumberShaderManager::GetInstancesCount(count), minInstancesCount);
 
-			do
-			{
-				divisor /= 100;
-
-				const int tmp = static_cast<int>(intPart / divisor);
-				const GlyphInfo * const * t = precomputed[tmp].gi;
-
-				this->AddQuad(*t[1], x, y, si.renderParams);
-				x += static_cast<int>((t[1]->adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
-				
-				this->AddQuad(*t[0], x, y, si.renderParams);
-				x += static_cast<int>((t[0]->adv + this->extraGlyphSpacingSize) * si.renderParams.scale);				
-				
-				intPart = intPart - tmp * divisor;				
-				
-			} while (divisor > 10);
-
-			if (divisor >= 10)
-			{
-				//one digit remaining number
-				const GlyphInfo & gi = this->gi[intPart + '0'];
-				this->AddQuad(gi, x, y, si.renderParams);
-				x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
-			}
-		}
-		
-		//==========================================================
+	for (int i = 0; i < instancesCount; i++)
+	{
+		const int start = std::min(i * InstancedNumberShaderManager::MAX_GLYPHS, count);
+		const int end = std::min(start + InstancedNumberShaderManager::MAX_GLYPHS, count);
 
-		uint32_t fractPartReverse = si.fractPartReverse;
-		if (fractPartReverse)
-		{
-			const GlyphInfo& gi = this->gi['.'];
+		uint32_t lo, hi;
+		InstancedNumberShaderManager::PackCodes(chars + start, end - start, lo, hi);
 
-			this->AddQuad(gi, x, y, si.renderParams);
+		this->instanceData.clear();
+		InstancedNumberShaderManager::FillInstanceData(static_cast<float>(x), static_cast<float>(y),
+			si.renderParams.scale, si.renderParams.color, lo, hi, this->instanceData);
+
+		this->backend->AddInstance(this->instanceData.data(), this->instanceData.size());
+
+		for (int j = start; j < end; j++)
+		{
+			const GlyphInfo& gi = this->gi[static_cast<uint8_t>(chars[j])];
 			x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
-						
-			while (fractPartReverse)
-			{
-				const int cc = (fractPartReverse % 10);				
-				const GlyphInfo & gi = this->gi[cc + '0'];
+		}
+	}
+}
+
+/// <summary>
+/// Write glyphs of number (without caption mark) as characters
+/// </summary>
+/// <param name="n"></param>
+/// <param name="out">output, at least MAX_NUMBER_GLYPHS</param>
+/// <returns>number of glyphs</returns>
+int NumberRenderer::GetGlyphChars(const NumberInfo& n, char* out) const noexcept
+{
+	char* c = out;
 
-				this->AddQuad(gi, x, y, si.renderParams);
-				x += static_cast<int>((gi.adv + this->extraGlyphSpacingSize) * si.renderParams.scale);
+	if (n.negative)
+	{
+		*c++ = '-';
+	}
 
-				fractPartReverse /= 10;
-			}
+	c = this->WriteDigits(n.intPart, n.intDigits, c);
+
+	if (n.fractDigits)
+	{
+		*c++ = '.';
+		c = this->WriteDigits(n.fractPart, n.fractDigits, c);
+	}
+
+	if (n.hasExponent)
+	{
+		*c++ = 'e';
+		*c++ = (n.exponent < 0) ? '-' : '+';
+
+		//exponent has at least two digits
+		const uint64_t exponent = static_cast<uint64_t>(std::abs(n.exponent));
+		c = this->WriteDigits(exponent, std::max<int>(this->GetDigitsCount(exponent), 2), c);
+	}
+
+	return static_cast<int>(c - out);
+}
+
+/// <summary>
+/// Write digits of v (with leading zeroes)
+/// </summary>
+/// <param name="v"></param>
+/// <param name="digits"></param>
+/// <param name="out"></param>
+/// <returns>position after last digit</returns>
+char* NumberRenderer::WriteDigits(uint64_t v, int digits, char* out) const noexcept
+{
+	for (int i = digits - 1; i >= 0; i--)
+	{
+		out[i] = static_cast<char>('0' + v % 10);
+		v /= 10;
+	}
+	return out + digits;
+}
+
+/// <summary>
+/// Get number of glyphs of number (without caption mark)
+/// </summary>
+/// <param name="n"></param>
+/// <returns></returns>
+int NumberRenderer::GetGlyphsCount(const NumberInfo& n) const noexcept
+{
+	int count = n.intDigits;
+	if (n.negative)
+	{
+		count++;
+	}
+	if (n.fractDigits)
+	{
+		count += 1 + n.fractDigits;
+	}
+	if (n.hasExponent)
+	{
+		const uint64_t exponent = static_cast<uint64_t>(std::abs(n.exponent));
+		count += 2 + std::max<int>(this->GetDigitsCount(exponent), 2);
+	}
+	return count;
+}
+
+/// <summary>
+/// Generate geometry for all input numbers
+/// Slots are added after numbers and their geometry ranges are stored,
+/// so they can be rewritten later
+/// </summary>
+/// <returns></returns>
+bool NumberRenderer::GenerateGeometry()
+{
+	if (this->strChanged == false)
+	{
+		return false;
+	}
+			
+	//Build geometry	
+	AbstractRenderer::Clear();
+	//this->geom.reserve(400);
+	
+	if (this->instancedSm)
+	{
+		this->instancedSm->SetSpacing(this->extraGlyphSpacingSize);
+
+		for (const NumberRenderer::NumberInfo & si : this->nmbrs)
+		{
+			this->AddNumberInstance(si, 1);
+		}
+	}
+	else
+	{
+		for (const NumberRenderer::NumberInfo & si : this->nmbrs)
+		{		
+			this->AddNumberQuads(si);
+
+			this->OnFinishQuadGroup(si.renderParams);
+		}
+	}
+
+	for (NumberSlot& slot : this->slots)
+	{
+		slot.geomStart = this->backend->GetGeometrySize();
+		
+		this->AddSlotQuads(slot);
+		if (this->instancedSm == nullptr)
+		{
+			this->OnFinishQuadGroup(slot.info.renderParams);
 		}
 
-		this->OnFinishQuadGroup(si.renderParams);
+		slot.geomEnd = this->backend->GetGeometrySize();
 	}
 
 	this->strChanged = false;
@@ -3,9 +3,13 @@
 
 class IFontBuilder;
 class BackendBase;
+class InstancedNumberShaderManager;
 
 #include <type_traits>
 #include <array>
+#include <bit>
+#include <span>
+#include <algorithm>
 
 #include "./AbstractRenderer.h"
 
@@ -13,6 +17,8 @@ class BackendBase;
 
 #include "../FontStructures.h"
 
+#include "../Utils/AabbGrid.h"
+
 #define IS_FLOAT typename std::enable_if<std::is_floating_point<T>::value, bool>::type
 #define IS_INTEGRAL typename std::enable_if<std::is_integral<T>::value, bool>::type
 
@@ -24,6 +30,7 @@ public:
 
 	static NumberRenderer * CreateSingleColor(Color color, const FontBuilderSettings& fs, const RenderSettings& r);
 	static NumberRenderer* CreateDefault(const FontBuilderSettings& fs, const RenderSettings& r);
+	static NumberRenderer* CreateInstanced(const FontBuilderSettings& fs, const RenderSettings& r);
 
 	NumberRenderer(const FontBuilderSettings& fs, std::unique_ptr<BackendBase>&& backend);
 	NumberRenderer(std::shared_ptr<IFontBuilder> fb, std::unique_ptr<BackendBase>&& backend);
@@ -35,6 +42,7 @@ public:
 	void SetExistenceCheck(bool val) noexcept;	
 	void SetOverlapCheck(bool val, float enlargePercent = 0.0f) noexcept;
 	void SetDecimalPrecission(int digits) noexcept;
+	void SetExponentNotation(bool val) noexcept;
 
 	int GetDecimalPrecission() const noexcept;
 
@@ -78,22 +86,46 @@ public:
 		int x, int y, const RenderParams & rp = DEFAULT_PARAMS,
 		TextAnchor anchor = TextAnchor::LEFT_TOP);
 
+	size_t AddNumberSlot(int x, int y, int maxLength,
+		const RenderParams & rp = DEFAULT_PARAMS,
+		TextAnchor anchor = TextAnchor::LEFT_TOP);
+
+	template <typename T>
+	IS_FLOAT UpdateValue(size_t slot, T val);
+
+	template <typename T>
+	IS_INTEGRAL UpdateValue(size_t slot, T val);
+
+	void RemoveNumberSlots();
+	size_t GetNumberSlotsCount() const noexcept;
+
+	template <typename T>
+	size_t AddNumbers(std::span<T> vals,
+		std::span<const int> x, std::span<const int> y, const RenderParams & rp = DEFAULT_PARAMS,
+		TextAnchor anchor = TextAnchor::LEFT_TOP);
+
 			
 protected:
 
 	
+	/// <summary>
+	/// Number split to integer part, fraction part and exponent
+	/// Fraction part is without trailing zeroes, but with leading zeroes
+	/// (eg. 1.05 => intPart = 1, fractPart = 5, fractDigits = 2)
+	/// </summary>
 	struct NumberInfo
 	{
-		double val;				
-		uint32_t intPart;		
-		uint32_t fractPartReverse;
+		uint64_t intPart;		
+		uint64_t fractPart;
+		int16_t exponent;
+		uint8_t intDigits;
+		uint8_t fractDigits;
 		bool negative;
+		bool hasExponent;
 		
 		TextAnchor anchor;
 		TextType type;
 
-		uint8_t intPartOrderIndex;
-
 		int16_t x;
 		int16_t y;
 		int16_t w;
@@ -103,22 +135,19 @@ protected:
 		
 
 		NumberInfo() noexcept :
-			NumberInfo(0.0)
-		{
-		}
-
-		NumberInfo(double value) noexcept :
-			NumberInfo(value, {}, TextAnchor::CENTER, TextType::TEXT)
+			NumberInfo({}, TextAnchor::CENTER, TextType::TEXT)
 		{
 		}
 
-		NumberInfo(double value, const RenderParams& renderParams, 
+		NumberInfo(const RenderParams& renderParams,
 			TextAnchor anchor, TextType type) noexcept :
-			val((value < 0) ? -value : value),			
-			intPart(static_cast<uint32_t>(val)),
-			intPartOrderIndex(0),
-			fractPartReverse(0),
-			negative(value < 0),			
+			intPart(0),
+			fractPart(0),
+			exponent(0),
+			intDigits(1),
+			fractDigits(0),
+			negative(false),
+			hasExponent(false),
 			anchor(anchor),
 			type(type),
 			x(0),
@@ -130,14 +159,130 @@ protected:
 
 	};
 
+	/// <summary>
+	/// Persistent number with fixed position, anchor and max length
+	/// Slot always has maxLength quads (unused are empty), so its value
+	/// can be changed by rewriting [geomStart, geomEnd) range of geometry
+	/// </summary>
+	struct NumberSlot
+	{
+		NumberInfo info;
+		int maxLength;
+		size_t geomStart;
+		size_t geomEnd;
+	};
+
+	/// <summary>
+	/// Key for existence check
+	/// Number is same if it has same position, anchor, type and value
+	/// Value is stored as bits of signed double (-0 is same as 0)
+	/// Integers that can not be stored exactly in double are stored directly
+	/// with kind 1 (positive) or 2 (negative)
+	/// </summary>
+	struct NumberKey
+	{
+		static const uint64_t MAX_EXACT_INTEGER = 1ULL << 53;
+
+		uint64_t valBits;
+		uint8_t kind;
+		int x;
+		int y;
+		TextAnchor anchor;
+		TextType type;
+
+		NumberKey() noexcept :
+			NumberKey(0.0, 0, 0, TextAnchor::LEFT_TOP, TextType::TEXT)
+		{}
+
+		NumberKey(double val, int x, int y, TextAnchor anchor, TextType type) noexcept :
+			valBits(std::bit_cast<uint64_t>((val == 0.0) ? 0.0 : val)),
+			kind(0),
+			x(x),
+			y(y),
+			anchor(anchor),
+			type(type)
+		{}
+
+		NumberKey(bool negative, uint64_t absVal, int x, int y, TextAnchor anchor, TextType type) noexcept :
+			NumberKey(negative ? -static_cast<double>(absVal) : static_cast<double>(absVal),
+				x, y, anchor, type)
+		{
+			if (absVal > MAX_EXACT_INTEGER)
+			{
+				this->valBits = absVal;
+				this->kind = negative ? 2 : 1;
+			}
+		}
+
+		bool operator==(const NumberKey& k) const noexcept
+		{
+			return (this->valBits == k.valBits) && (this->kind == k.kind) &&
+				(this->x == k.x) && (this->y == k.y) &&
+				(this->anchor == k.anchor) && (this->type == k.type);
+		}
+	};
+
+	struct NumberKeyHash
+	{
+		using is_avalanching = void;
+
+		uint64_t operator()(const NumberKey& k) const noexcept
+		{
+			uint64_t pos = (static_cast<uint64_t>(static_cast<uint32_t>(k.x)) << 32) |
+				static_cast<uint32_t>(k.y);
+			uint64_t flags = (static_cast<uint64_t>(k.kind) << 16) |
+				(static_cast<uint64_t>(k.anchor) << 8) | static_cast<uint64_t>(k.type);
+
+			return ankerl::unordered_dense::detail::wyhash::mix(
+				k.valBits ^ flags,
+				ankerl::unordered_dense::detail::wyhash::hash(pos));
+		}
+	};
+
+	/// <summary>
+	/// Precomputed group of 1 - 3 digits (with leading zeroes)
+	/// glyphs are in reading order
+	/// </summary>
 	struct Precomputed 
 	{
-		GlyphInfo * gi[2];
+		const GlyphInfo * gi[3];
+		uint8_t count;
 		AABB aabb;
 		int xOffset;
 	};
 
-	static const std::array<uint64_t, 10> INT_DIVISORS;
+	/// <summary>
+	/// All groups: 10 x 1 digit, 100 x 2 digits, 1000 x 3 digits
+	/// </summary>
+	static const size_t GROUPS_COUNT = 1110;
+
+	/// <summary>
+	/// Max number of groups for uint64_t
+	/// </summary>
+	static constexpr int MAX_GROUPS = 7;
+
+	/// <summary>
+	/// Max fraction digits, so fraction part fits to uint64_t
+	/// and formatted number fits to FORMAT_BUFFER_SIZE
+	/// </summary>
+	static constexpr int MAX_DECIMAL_PLACES = 17;
+	static const size_t FORMAT_BUFFER_SIZE = 64;
+
+	/// <summary>
+	/// Glyphs are indexed directly by character
+	/// </summary>
+	static const size_t GLYPHS_COUNT = 'e' + 1;
+
+	/// <summary>
+	/// Max number of glyphs of one number (sign, 20 digits, decimal point,
+	/// fraction digits, exponent symbols and digits)
+	/// </summary>
+	static const int MAX_NUMBER_GLYPHS = 1 + 20 + 1 + MAX_DECIMAL_PLACES + 2 + 3;
+
+	/// <summary>
+	/// Number of values processed at once by AddNumbers
+	/// </summary>
+	static constexpr size_t BULK_LANES = 64;
 
 	bool checkIfExist;
 	bool overlapCheck;
@@ -145,13 +290,23 @@ protected:
 	int newLineOffset;
 
 	int decimalPlaces;
-	double decimalMult;
+	bool exponentNotation;
 	std::vector<NumberInfo> nmbrs;
 	std::vector<AABB> nmbrsAABB;
 
-	GlyphInfo gi[65];
+	ankerl::unordered_dense::set<NumberKey, NumberKeyHash> nmbrsKeys;
+	AabbGrid nmbrsGrid;
+
+	std::vector<NumberSlot> slots;
+
+	//set if backend uses instanced rendering (one instance per number)
+	std::shared_ptr<InstancedNumberShaderManager> instancedSm;
+	//data of one instance (see AddNumberInstance)
+	std::vector<float> instanceData;
+
+	GlyphInfo gi[GLYPHS_COUNT];
 	GlyphInfo captionMark;
-	Precomputed precomputed[100];
+	Precomputed precomputed[GROUPS_COUNT];
 	
 
 	void Init();	
@@ -162,26 +317,46 @@ protected:
 		TextAnchor anchor = TextAnchor::LEFT_TOP,		
 		TextType type = TextType::TEXT);
 
-	bool AddIntegralNumberInternal(long value,
+	bool AddIntegralNumberInternal(bool negative, uint64_t absValue,
 		int x, int y, const RenderParams & rp,
 		TextAnchor anchor = TextAnchor::LEFT_TOP,
 		TextType type = TextType::TEXT);
 
-	bool AddNumber(NumberInfo & n, int x, int y);
+	size_t AddNumbersInternal(NumberInfo * infos, NumberKey * keys,
+		const int * xs, const int * ys, size_t count,
+		const RenderParams & rp, TextAnchor anchor);
+
+	bool AddNumber(NumberInfo & n, const NumberKey & key, int x, int y);
+	void StoreNumber(const NumberInfo & n, const NumberKey & key, const AABB & aabb);
+
+	bool IsOverlapping(const AABB& aabb);
+	void UpdateOverlapGrid();
+
+	bool UpdateSlot(size_t slot, const NumberInfo & n);
+	void AddSlotQuads(const NumberSlot & slot);
 
 	bool GenerateGeometry() override;
+	void AddNumberQuads(const NumberInfo & si);
+	void AddNumberInstance(const NumberInfo & si, int minInstancesCount);
+	int GetGlyphChars(const NumberInfo & n, char * out) const noexcept;
+	char * WriteDigits(uint64_t v, int digits, char * out) const noexcept;
+	int GetGlyphsCount(const NumberInfo & n) const noexcept;
+
+	AABB CalcNumberAABB(const NumberInfo & n, int x, int y);
 
-	AABB CalcNumberAABB(double val, int x, int y,
-		bool negative, uint32_t intPart, uint8_t intPartOrderIndex, uint32_t fractPartReversed,
-		float scale);
+	int SplitToGroups(uint64_t v, int digits, const Precomputed ** groups) const noexcept;
+	void AddGroupQuads(const Precomputed & t, int & x, int y, const RenderParams & rp);
 
 	
 	void GetAnchoredPosition(const NumberRenderer::NumberInfo & si, int & x, int & y);
 	
 
-	uint32_t GetFractPartReversed(double val, uint32_t intPart) const noexcept;
-	uint32_t ReversDigits(uint32_t num) const noexcept;
-	uint8_t GetIntDivisorIndex(const uint32_t x) const noexcept;
+	bool FormatFloat(double val, NumberInfo & n) const noexcept;
+	void FormatIntegral(bool negative, uint64_t absVal, NumberInfo & n) const noexcept;
+	uint8_t GetDigitsCount(uint64_t x) const noexcept;
+
+	template <typename T>
+	static uint64_t GetAbsIntegral(T val, bool & negative) noexcept;
 };
 
 //====================================================================================
@@ -270,7 +445,10 @@ template <typename T>
 IS_INTEGRAL NumberRenderer::AddNumberCaption(T val,
 	int x, int y, const RenderParams & rp)
 {	
-	return this->AddIntegralNumberInternal(static_cast<long>(val), x, y, rp, TextAnchor::CENTER, TextType::CAPTION_TEXT);
+	bool negative;
+	uint64_t absVal = GetAbsIntegral(val, negative);
+
+	return this->AddIntegralNumberInternal(negative, absVal, x, y, rp, TextAnchor::CENTER, TextType::CAPTION_TEXT);
 }
 
 /// <summary>
@@ -287,7 +465,10 @@ IS_INTEGRAL NumberRenderer::AddNumberCaption(T val,
 	int xx = static_cast<int>(x * this->GetRenderSettings().deviceW);
 	int yy = static_cast<int>(y * this->GetRenderSettings().deviceH);
 	
-	return this->AddIntegralNumberInternal(static_cast<long>(val), xx, yy, rp, TextAnchor::CENTER, TextType::CAPTION_TEXT);
+	bool negative;
+	uint64_t absVal = GetAbsIntegral(val, negative);
+
+	return this->AddIntegralNumberInternal(negative, absVal, xx, yy, rp, TextAnchor::CENTER, TextType::CAPTION_TEXT);
 }
 
 /// <summary>
@@ -308,7 +489,10 @@ IS_INTEGRAL NumberRenderer::AddNumber(T val,
 	int xx = static_cast<int>(x * this->GetRenderSettings().deviceW);
 	int yy = static_cast<int>(y * this->GetRenderSettings().deviceH);
 
-	return this->AddIntegralNumberInternal(static_cast<long>(val), xx, yy, rp, anchor, TextType::TEXT);
+	bool negative;
+	uint64_t absVal = GetAbsIntegral(val, negative);
+
+	return this->AddIntegralNumberInternal(negative, absVal, xx, yy, rp, anchor, TextType::TEXT);
 }
 
 /// <summary>
@@ -324,8 +508,144 @@ IS_INTEGRAL NumberRenderer::AddNumber(T val,
 	int x, int y, const RenderParams & rp,
 	TextAnchor anchor)
 {
-	return this->AddIntegralNumberInternal(static_cast<long>(val), x, y, rp, anchor, TextType::TEXT);
+	bool negative;
+	uint64_t absVal = GetAbsIntegral(val, negative);
+
+	return this->AddIntegralNumberInternal(negative, absVal, x, y, rp, anchor, TextType::TEXT);
 }
 
+//-------
+
+/// <summary>
+/// Set new value of number slot
+/// Only quads of the slot are rewritten
+/// </summary>
+/// <param name="slot"></param>
+/// <param name="val"></param>
+/// <returns>false if slot does not exist or value is longer than slot</returns>
+template <typename T>
+IS_FLOAT NumberRenderer::UpdateValue(size_t slot, T val)
+{
+	NumberInfo n;
+	if (this->FormatFloat(static_cast<double>(val), n) == false)
+	{
+		return false;
+	}
+
+	return this->UpdateSlot(slot, n);
+}
+
+/// <summary>
+/// Set new value of number slot
+/// Only quads of the slot are rewritten
+/// </summary>
+/// <param name="slot"></param>
+/// <param name="val"></param>
+/// <returns>false if slot does not exist or value is longer than slot</returns>
+template <typename T>
+IS_INTEGRAL NumberRenderer::UpdateValue(size_t slot, T val)
+{
+	bool negative;
+	uint64_t absVal = GetAbsIntegral(val, negative);
+
+	NumberInfo n;
+	this->FormatIntegral(negative, absVal, n);
+
+	return this->UpdateSlot(slot, n);
+}
+
+//-------
+
+/// <summary>
+/// Add multiple numbers at once (all with the same render params and anchor)
+/// Numbers are processed in blocks of BULK_LANES - values are formatted
+/// one by one (exact std::to_chars, see FormatIntegral / FormatFloat),
+/// AABB and visibility steps are done for the entire block, accepted 
+/// numbers are appended at the end of each block
+/// Count of added numbers is min(vals.size(), x.size(), y.size())
+/// </summary>
+/// <param name="vals"></param>
+/// <param name="x"></param>
+/// <param name="y"></param>
+/// <param name="rp"></param>
+/// <param name="anchor"></param>
+/// <returns>number of added numbers</returns>
+template <typename T>
+size_t NumberRenderer::AddNumbers(std::span<T> vals,
+	std::span<const int> x, std::span<const int> y, const RenderParams & rp,
+	TextAnchor anchor)
+{
+	using ValueType = std::remove_cv_t<T>;
+	static_assert(std::is_arithmetic<ValueType>::value, "Only numbers can be added");
+
+	const size_t count = std::min({ vals.size(), x.size(), y.size() });
+
+	std::array<NumberInfo, BULK_LANES> infos;
+	std::array<NumberKey, BULK_LANES> keys;
+	std::array<int, BULK_LANES> xs;
+	std::array<int, BULK_LANES> ys;
+
+	size_t lanes = 0;
+	size_t added = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if constexpr (std::is_integral<ValueType>::value)
+		{
+			bool negative;
+			uint64_t absVal = GetAbsIntegral(vals[i], negative);
+
+			this->FormatIntegral(negative, absVal, infos[lanes]);
+			keys[lanes] = NumberKey(negative, absVal, 0, 0, anchor, TextType::TEXT);
+		}
+		else
+		{
+			if (this->FormatFloat(static_cast<double>(vals[i]), infos[lanes]) == false)
+			{
+				continue;
+			}
+			keys[lanes] = NumberKey(static_cast<double>(vals[i]), 0, 0, anchor, TextType::TEXT);
+		}
+
+		xs[lanes] = x[i];
+		ys[lanes] = y[i];
+		lanes++;
+
+		if (lanes == BULK_LANES)
+		{
+			added += this->AddNumbersInternal(infos.data(), keys.data(), xs.data(), ys.data(), lanes, rp, anchor);
+			lanes = 0;
+		}
+	}
+
+	if (lanes > 0)
+	{
+		added += this->AddNumbersInternal(infos.data(), keys.data(), xs.data(), ys.data(), lanes, rp, anchor);
+	}
+
+	return added;
+}
+
+/// <summary>
+/// Get absolute value of integer as uint64_t
+/// Works also for minimal value of signed types
+/// </summary>
+/// <param name="val"></param>
+/// <param name="negative">output sign</param>
+/// <returns></returns>
+template <typename T>
+uint64_t NumberRenderer::GetAbsIntegral(T val, bool & negative) noexcept
+{
+	if constexpr (std::is_signed<T>::value)
+	{
+		negative = (val < 0);
+		return negative ? (0 - static_cast<uint64_t>(val)) : static_cast<uint64_t>(val);
+	}
+	else
+	{
+		negative = false;
+		return static_cast<uint64_t>(val);
+	}
+}
 
 #endif
@@ -6,6 +6,8 @@
 
 #include "../Backends/Shaders/DefaultFontShaderManager.h"
 #include "../Backends/Shaders/SingleColorFontShaderManager.h"
+#include "../Backends/Shaders/InstancedGlyphShaderManager.h"
+#include "../Backends/Shaders/GlyphBackgroundShaderManager.h"
 
 #include "../Backends/BackendBase.h"
 #include "../Backends/BackendOpenGL.h"
@@ -37,34 +39,83 @@ StringRenderer * StringRenderer::CreateSingleColor(Color color,
 StringRenderer* StringRenderer::CreateDefault(const FontBuilderSettings& fs,
 	const RenderSettings& r)
 {
-	auto sm = std::make_shared<DefaultFontShaderManager>(fs.sdf);
+	auto sm = std::make_shared<DefaultFontShaderManager>(fs.sdf, r.useQuantizedVertices);
 	
 	auto backend = std::make_unique<BackendOpenGL>(r, nullptr, nullptr, sm);
 
 	return new StringRenderer(fs, std::move(backend));
 }
 
+/// <summary>
+/// Create String renderer that renders every glyph as one instance
+/// (static unit quad is expanded on GPU)
+/// Needs OpenGL ES 3 / instanced arrays
+/// </summary>
+/// <param name="fs"></param>
+/// <param name="r"></param>
+/// <returns></returns>
+StringRenderer* StringRenderer::CreateInstanced(const FontBuilderSettings& fs,
+	const RenderSettings& r)
+{
+	auto sm = std::make_shared<InstancedGlyphShaderManager>(fs.sdf);
+
+	auto backend = std::make_unique<BackendOpenGL>(r, nullptr, nullptr, sm);
+
+	return new StringRenderer(fs, std::move(backend));
+}
+
+/// <summary>
+/// Create String renderer with glyphs and backgrounds in one buffer
+/// Backgrounds are rendered in the same draw call as glyphs,
+/// string order is kept (later backgrounds cover earlier strings)
+/// SDF fonts and background shadow are not supported
+/// (shadow falls back to separate background pass)
+/// </summary>
+/// <param name="bs"></param>
+/// <param name="fs"></param>
+/// <param name="r"></param>
+/// <returns></returns>
+StringRenderer* StringRenderer::CreateWithBackground(const BackgroundSettings& bs,
+	const FontBuilderSettings& fs, const RenderSettings& r)
+{
+	if (fs.sdf.has_value())
+	{
+		MY_LOG_ERROR("SDF is not supported by merged glyph and background geometry");
+	}
+
+	auto sm = std::make_shared<GlyphBackgroundShaderManager>();
+
+	auto backend = std::make_unique<BackendOpenGL>(r, nullptr, nullptr, sm);
+	backend->SetBackground(bs);
+
+	return new StringRenderer(fs, std::move(backend));
+}
+
 StringRenderer::StringRenderer(const FontBuilderSettings& fs, 
 	std::unique_ptr<BackendBase>&& backend) :
 	AbstractRenderer(fs, std::move(backend)),
+	activeLayer(0),
+	layersInBackend(false),
 	isBidiEnabled(true),
+	spaceSizeExist(false),
 	deadzoneRadius2(0),
 	nlOffsetPx(0),
-	spaceSizeExist(false),
-	spaceHeight(0),
-	spaceSize(10)
+	spaceSize(10),
+	spaceHeight(0)
 {
 }
 
 StringRenderer::StringRenderer(std::shared_ptr<IFontBuilder> fb,
 	std::unique_ptr<BackendBase>&& backend) :
 	AbstractRenderer(fb, std::move(backend)),
+	activeLayer(0),
+	layersInBackend(false),
 	isBidiEnabled(true),
+	spaceSizeExist(false),
 	deadzoneRadius2(0),
 	nlOffsetPx(0),
-	spaceSizeExist(false),
-	spaceHeight(0),
-	spaceSize(10)
+	spaceSize(10),
+	spaceHeight(0)
 {
 }
 
@@ -89,6 +140,93 @@ void StringRenderer::Clear()
 	this->strs.clear();
 }
 
+/// <summary>
+/// Remove strings of single layer
+/// Other layers are not generated again
+/// </summary>
+/// <param name="layer"></param>
+void StringRenderer::ClearLayer(uint8_t layer)
+{
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(m);
+#endif
+
+	auto it = this->layers.find(layer);
+	if (it == this->layers.end())
+	{
+		return;
+	}
+
+	std::erase_if(this->strs, [layer](const StringInfo& si) {
+		return si.layer == layer;
+	});
+
+	it->second.changed = true;
+}
+
+/// <summary>
+/// Set layer of newly added strings
+/// Layers are rendered in order of their ids and every layer 
+/// is generated again only if its strings were changed
+/// Default layer is 0
+/// </summary>
+/// <param name="layer"></param>
+void StringRenderer::SetActiveLayer(uint8_t layer)
+{
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(m);
+#endif
+
+	this->activeLayer = layer;
+}
+
+uint8_t StringRenderer::GetActiveLayer() const noexcept
+{
+	return this->activeLayer;
+}
+
+/// <summary>
+/// Set buffer strategy of layer
+/// Static layers are stored in own static buffer, 
+/// dynamic layer 0 uses streaming buffers of backend
+/// and other dynamic layers own streamed buffer
+/// </summary>
+/// <param name="layer"></param>
+/// <param name="type"></param>
+void StringRenderer::SetLayerType(uint8_t layer, LayerType type)
+{
+#ifdef THREAD_SAFETY
+	std::lock_guard<std::shared_timed_mutex> lk(m);
+#endif
+
+	auto it = this->layers.find(layer);
+	if (it == this->layers.end())
+	{
+		this->layers.try_emplace(layer, LayerInfo{ type, true });
+		return;
+	}
+
+	if (it->second.type == type)
+	{
+		return;
+	}
+
+	//layer can move from / to main geometry
+	it->second.type = type;
+	this->strChanged = true;
+}
+
+/// <summary>
+/// Test if layer is stored in main geometry of backend
+/// </summary>
+/// <param name="layer"></param>
+/// <param name="li"></param>
+/// <returns></returns>
+bool StringRenderer::IsMainLayer(uint8_t layer, const LayerInfo& li) const noexcept
+{
+	return (layer == 0) && (li.type == LayerType::DYNAMIC);
+}
+
 size_t StringRenderer::GetStringsCount() const noexcept
 {
 	return strs.size();
@@ -290,13 +428,10 @@ bool StringRenderer::AddStringInternal(const StringUtf8& str,
 		y = this->backend->GetSettings().deviceH - y;
 	}
 
-#ifdef USE_ICU_LIBRARY
-
-    //check if string contains only ASCII letters
-    //if so - we dont need BIDI changing of the string
-    
-    //383 - end of Latin Extended-A
-    //https://en.wikipedia.org/wiki/List_of_Unicode_characters
+    //check if string contains any RTL letters
+    //if not - we dont need BIDI changing of the string
+    //(converted strings are cached inside BidiHelper,
+    //without ICU, built-in bidi implementation is used)
     
     bool needBidi = false;
     if (this->isBidiEnabled)
@@ -305,16 +440,19 @@ bool StringRenderer::AddStringInternal(const StringUtf8& str,
     }
     
 	StringUtf8 uniStr = (this->isBidiEnabled && needBidi) ? BidiHelper::ConvertOneLine(str) : str;
-#else
-	if (this->isBidiEnabled)
+
+	//decode UTF-8 only once, all layout passes use decoded code points
+	std::u32string codePoints;
+	codePoints.reserve(uniStr.length());
+
+	auto it = CustomIteratorCreator::Create(uniStr);
+	char32_t cp;
+	while ((cp = it.GetCurrentAndAdvance()) != it.DONE)
 	{
-		MY_LOG_ERROR("Bidi enabled, but not complied with ICU support");
+		codePoints.push_back(cp);
 	}
-
-	StringUtf8 uniStr = str;
-#endif
 	
-	if (this->CanAddString(uniStr, x, y, rp, anchor, align, type) == false)
+	if (this->CanAddString(uniStr, codePoints, x, y, rp, anchor, align, type) == false)
 	{
 		return false;
 	}
@@ -327,36 +465,49 @@ bool StringRenderer::AddStringInternal(const StringUtf8& str,
 		
 	//this->fb->AddString(uniStr);
 
-	auto & added = this->strs.emplace_back(std::move(uniStr), x, y, anchor, align, type, rp);	
+	auto & added = this->strs.emplace_back(std::move(uniStr), std::move(codePoints), x, y, anchor, align, type, rp);
+	added.layer = this->activeLayer;
+
+	//eg. start loading of background image
+	this->backend->PrefetchResources(rp);
 	auto & lines = added.lines;
 
-	lines.emplace_back(0);
+	lines.emplace_back(0, 0);
 
-	int len = 0;
-	int start = 0;
+	uint32_t len = 0;
+	uint32_t cpStart = 0;
     
-	auto it = CustomIteratorCreator::Create(added.str);
-    char32_t c;
-	while ((c = it.GetCurrentAndAdvance()) != it.DONE)
+	//'\n' is single byte in UTF-8 and can not be part of multi-byte sequence
+	//-> byte offsets of lines are positions after '\n' bytes
+	size_t byteStart = 0;
+
+	for (char32_t c : added.codePoints)
 	{		
 		this->fb->AddCharacter(c);
 
 		if (c == '\n')
 		{
-			lines.back().len = len;
-			lines.emplace_back(start + 1);
+			size_t nl = added.str.find(u8'\n', byteStart);
+
+			lines.back().cpLen = len;
+			lines.back().len = static_cast<uint32_t>(nl - byteStart);
+
+			byteStart = nl + 1;
+			lines.emplace_back(static_cast<uint32_t>(byteStart), cpStart + 1);
 			len = 0;
 		}
 		else
 		{
 			len++;
 		}
-		start++;
+		cpStart++;
 	}
 
-	lines.back().len = len;
+	lines.back().cpLen = len;
+	lines.back().len = static_cast<uint32_t>(added.str.length() - byteStart);
 	
-	this->strChanged = true;
+	//only layer of the string is generated again
+	this->layers.try_emplace(this->activeLayer, LayerInfo{ LayerType::DYNAMIC, false }).first->second.changed = true;
 	
     return true;
 }
@@ -372,7 +523,7 @@ bool StringRenderer::AddStringInternal(const StringUtf8& str,
 /// <param name="align"></param>
 /// <param name="type"></param>
 /// <returns></returns>
-bool StringRenderer::CanAddString(const StringUtf8& uniStr,
+bool StringRenderer::CanAddString(const StringUtf8& uniStr, const std::u32string& codePoints,
 	int x, int y, const RenderParams & rp,
 	TextAnchor anchor, TextAlign align, TextType type) const
 {
@@ -394,7 +545,7 @@ bool StringRenderer::CanAddString(const StringUtf8& uniStr,
 
 	if (this->checkVisibility)
 	{
-		AABB estimAABB = this->EstimateStringAABB(uniStr,
+		AABB estimAABB = this->EstimateStringAABB(codePoints,
 			static_cast<float>(x), static_cast<float>(y), rp.scale);
 
 		//test if entire string is outside visible area
@@ -493,11 +644,11 @@ bool StringRenderer::DeadzoneCheck(int x, int y) const
 /// Try to get glyph if it already exist
 /// If not - each glyph will have the same size
 /// </summary>
-/// <param name="strUTF8"></param>
+/// <param name="codePoints"></param>
 /// <param name="x"></param>
 /// <param name="y"></param>
 /// <returns></returns>
-AABB StringRenderer::EstimateStringAABB(const StringUtf8& str,
+AABB StringRenderer::EstimateStringAABB(const std::u32string& codePoints,
 	float x, float y, float scale) const
 {
 	AABB aabb;
@@ -513,9 +664,7 @@ AABB StringRenderer::EstimateStringAABB(const StringUtf8& str,
 	float lastNewLineOffset = this->fb->GetMaxNewLineOffset() * scale;
 	float newLineOffset = 0;
     
-	auto it = CustomIteratorCreator::Create(str);
-	uint32_t c;
-	while ((c = it.GetCurrentAndAdvance()) != it.DONE)	
+	for (char32_t c : codePoints)
 	{
 		if (c == '\n')
 		{
@@ -593,9 +742,7 @@ void StringRenderer::CalcStringAABB(StringInfo & si, const UsedGlyphCache * gc)
 	//-> offset is calculated from glyphs
 	float newLineOffset = 0;
 	
-	auto it = CustomIteratorCreator::Create(si.str);
-	uint32_t c;
-	uint32_t lastOffset = 0;
+	const char32_t* cps = si.codePoints.data();
 
 	LineInfo * prevLine = nullptr;
 
@@ -623,12 +770,9 @@ void StringRenderer::CalcStringAABB(StringInfo & si, const UsedGlyphCache * gc)
 
 		newLineOffset = 0;
 
-		it.SetOffsetFromCurrent(li.start - lastOffset);
-		lastOffset = li.start + li.len;
-
-		for (uint32_t l = 0; l < li.len; l++)
+		for (uint32_t l = li.cpStart; l < li.cpStart + li.cpLen; l++)
 		{
-			c = it.GetCurrentAndAdvance();
+			char32_t c = cps[l];
 		
 			if (c <= 32)
 			{
@@ -702,7 +846,7 @@ void StringRenderer::CalcAnchoredPosition(StringInfo& si, float& captionMarkHeig
 		return;
 	}
 
-	StringRenderer::UsedGlyphCache gc = this->ExtractGlyphs(si.str);
+	StringRenderer::UsedGlyphCache gc = this->ExtractGlyphs(si.codePoints);
 
 	this->CalcStringAABB(si, &gc);
 
@@ -764,16 +908,14 @@ void StringRenderer::CalcLineAlign(const StringInfo & si, const LineInfo & li, f
 /// Extract all glyphs in given string
 /// Glyphs are put to vector
 /// </summary>
-/// <param name="strUTF8"></param>
+/// <param name="codePoints"></param>
 /// <returns></returns>
-StringRenderer::UsedGlyphCache StringRenderer::ExtractGlyphs(const StringUtf8& str)
+StringRenderer::UsedGlyphCache StringRenderer::ExtractGlyphs(const std::u32string& codePoints)
 {
 	UsedGlyphCache g;
-	g.reserve(str.length());
+	g.reserve(codePoints.length());
 
-	auto it = CustomIteratorCreator::Create(str);
-	uint32_t c;
-	while ((c = it.GetCurrentAndAdvance()) != it.DONE)	
+	for (char32_t c : codePoints)
 	{
 		if (c <= 32)
 		{			
@@ -827,11 +969,22 @@ void StringRenderer::CalcSpaceSize()
 
 /// <summary>
 /// Generate geometry for all input strings
+/// If backend supports layers, only changed layers are generated
+/// (strChanged means that all layers must be generated)
 /// </summary>
 /// <returns></returns>
 bool StringRenderer::GenerateGeometry()
 {
-	if (this->strChanged == false)
+	const bool layersSupported = this->backend->IsLayerSupported();
+
+	bool layerChanged = false;
+	for (const auto& [id, li] : this->layers)
+	{
+		layerChanged |= li.changed;
+	}
+
+	if ((this->strChanged == false) && (layerChanged == false) &&
+		(this->layersInBackend == layersSupported))
 	{
 		return false;
 	}
@@ -847,6 +1000,21 @@ bool StringRenderer::GenerateGeometry()
 
 		//Fill font texture
 		this->backend->FillFontTexture();
+
+		//glyphs can be moved in atlas - texture coordinates of all layers are invalid
+		this->strChanged = true;
+	}
+
+	if (this->layersInBackend != layersSupported)
+	{
+		//layers moved between main geometry and layer buffers
+		this->strChanged = true;
+
+		if (layersSupported == false)
+		{
+			this->backend->ClearLayers();
+		}
+		this->layersInBackend = layersSupported;
 	}
 
 	if (this->spaceSizeExist == false)
@@ -863,67 +1031,125 @@ bool StringRenderer::GenerateGeometry()
 		
 
 	//Build geometry
+	//without layers support, all layers are in main geometry
 	
-    AbstractRenderer::Clear();
-	
-	//this->geom.reserve(this->strs.size() * 80);
-
-	
-	for (const StringInfo & si : this->strs)
-	{						
-		float y = si.anchorY;
-		
-		auto it = CustomIteratorCreator::Create(si.str);
-		uint32_t c;
-		uint32_t lastOffset = 0;
+	//Clear sets strChanged
+	const bool allChanged = this->strChanged;
 
-		for (const LineInfo & li : si.lines)
+	bool mainChanged = allChanged;
+	for (const auto& [id, li] : this->layers)
+	{
+		if ((layersSupported == false) || (this->IsMainLayer(id, li)))
 		{
-			const auto& activeParams = li.renderParams ? *li.renderParams : si.renderParams;
-			float scale = activeParams.scale;
-
-			float x = si.anchorX;
+			mainChanged |= li.changed;
+		}
+	}
 
-			this->CalcLineAlign(si, li, x, y);
+	if (mainChanged)
+	{
+		AbstractRenderer::Clear();
 
-			it.SetOffsetFromCurrent(li.start - lastOffset);
-			lastOffset = li.start + li.len;
+		//this->geom.reserve(this->strs.size() * 80);
 
-			for (uint32_t l = 0; l < li.len; l++)
+		for (const auto& [id, li] : this->layers)
+		{
+			if ((layersSupported) && (this->IsMainLayer(id, li) == false))
 			{
-				c = it.GetCurrentAndAdvance();				
-
-				if (c <= 32)
-				{
-					this->AddEmptyQuad(x, y,
-						static_cast<float>(spaceSize), static_cast<float>(spaceHeight),
-						activeParams);
+				continue;
+			}
 
-					x += spaceSize * scale;
-					continue;
-				}
-			
-				auto gi = this->fb->GetGlyph(c);
-				if (gi == nullptr)
+			for (const StringInfo& si : this->strs)
+			{
+				if (si.layer == id)
 				{
-					continue;
+					this->AddStringGeometry(si);
 				}
+			}
+		}
+
+		this->backend->FillGeometry();
+	}
+
+	if (layersSupported)
+	{
+		for (const auto& [id, li] : this->layers)
+		{
+			if ((this->IsMainLayer(id, li)) || ((allChanged == false) && (li.changed == false)))
+			{
+				continue;
+			}
 
-												
-				this->AddQuad(*gi, x, y, activeParams);
+			this->backend->BeginLayer(id, li.type == LayerType::STATIC);
 
-				x += (gi->adv + this->extraGlyphSpacingSize) * scale;
+			for (const StringInfo& si : this->strs)
+			{
+				if (si.layer == id)
+				{
+					this->AddStringGeometry(si);
+				}
 			}
-			
-			y += li.maxNewLineOffset;
+
+			this->backend->EndLayer();
 		}
+	}
 
-		this->OnFinishQuadGroup(si.renderParams);
+	for (auto& [id, li] : this->layers)
+	{
+		li.changed = false;
 	}
 
 	this->strChanged = false;
-	
-	this->backend->FillGeometry();
 
 	return true;
 }
+
+/// <summary>
+/// Add quads of single string to geometry
+/// </summary>
+/// <param name="si"></param>
+void StringRenderer::AddStringGeometry(const StringInfo& si)
+{
+	float y = si.anchorY;
+	
+	const char32_t* cps = si.codePoints.data();
+
+	for (const LineInfo & li : si.lines)
+	{
+		const auto& activeParams = li.renderParams ? *li.renderParams : si.renderParams;
+		float scale = activeParams.scale;
+
+		float x = si.anchorX;
+
+		this->CalcLineAlign(si, li, x, y);
+
+		for (uint32_t l = li.cpStart; l < li.cpStart + li.cpLen; l++)
+		{
+			char32_t c = cps[l];
+
+			if (c <= 32)
+			{
+				this->AddEmptyQuad(x, y,
+					static_cast<float>(spaceSize), static_cast<float>(spaceHeight),
+					activeParams);
+
+				x += spaceSize * scale;
+				continue;
+			}
+		
+			auto gi = this->fb->GetGlyph(c);
+			if (gi == nullptr)
+			{
+				continue;
+			}
+
+											
+			this->AddQuad(*gi, x, y, activeParams);
+
+			x += (gi->adv + this->extraGlyphSpacingSize) * scale;
+		}
+		
+		y += li.maxNewLineOffset;
+	}
+
+	this->OnFinishQuadGroup(si.renderParams);
+}
@@ -3,6 +3,8 @@
 
 class BackendBase;
 
+#include <map>
+
 #include "./AbstractRenderer.h"
 
 #include "../Externalncludes.h"
@@ -12,28 +14,36 @@ class StringRenderer : public AbstractRenderer
 public:
 
 	/// <summary>
-	/// Single line info	
+	/// Single line info
+	/// start / len are byte offsets within UTF-8 text,
+	/// cpStart / cpLen are offsets within decoded code points
 	/// </summary>
 	struct LineInfo
 	{
-		uint32_t start; //offset of start char within text
-		uint32_t len;   //line length
+		uint32_t start; //offset of first byte of line within text
+		uint32_t len;   //line length in bytes
+		uint32_t cpStart; //offset of first code point within codePoints
+		uint32_t cpLen;   //line length in code points
 		AABB aabb;		//line AABB		
 		float maxNewLineOffset; //offset to next new line
 		std::optional<RenderParams> renderParams;
 
-		LineInfo(const uint32_t& start) noexcept :
+		LineInfo(const uint32_t& start, const uint32_t& cpStart) noexcept :
 			start(start),
 			len(0),
+			cpStart(cpStart),
+			cpLen(0),
 			aabb(AABB()),						
 			maxNewLineOffset(0.0f),
 			renderParams(std::nullopt)
 		{}
 
-		LineInfo(const uint32_t& start,
+		LineInfo(const uint32_t& start, const uint32_t& cpStart,
 			const RenderParams& rp) noexcept :
 			start(start),
 			len(0),
+			cpStart(cpStart),
+			cpLen(0),
 			aabb(AABB()),			
 			maxNewLineOffset(0.0f),
 			renderParams(rp)
@@ -48,6 +58,7 @@ public:
 	struct StringInfo
 	{
 		StringUtf8 str;
+		std::u32string codePoints; //str decoded once when string is added
 		int x;
 		int y;
 
@@ -63,6 +74,8 @@ public:
 		std::vector<LineInfo> lines;
 		AABB global;
 
+		uint8_t layer; //see SetActiveLayer
+
 		StringInfo(const StringUtf8& str, int x, int y,
 			TextAnchor anchor,
 			TextAlign align, TextType type) noexcept :
@@ -74,14 +87,16 @@ public:
 			type(type),
 			anchorX(static_cast<float>(x)),
 			anchorY(static_cast<float>(y)),
-			renderParams(DEFAULT_PARAMS)
+			renderParams(DEFAULT_PARAMS),
+			layer(0)
 		{}
 
-		StringInfo(StringUtf8&& str, int x, int y,
+		StringInfo(StringUtf8&& str, std::u32string&& codePoints, int x, int y,
 			TextAnchor anchor,
 			TextAlign align, TextType type,
 			const RenderParams& rp) noexcept :
 			str(std::move(str)),
+			codePoints(std::move(codePoints)),
 			x(x),
 			y(y),
 			anchor(anchor),
@@ -89,15 +104,31 @@ public:
 			type(type),
 			anchorX(static_cast<float>(x)),
 			anchorY(static_cast<float>(y)),
-			renderParams(rp)
+			renderParams(rp),
+			layer(0)
 		{}
 
 	};
+
+	/// <summary>
+	/// Buffer strategy of text layer
+	/// DYNAMIC - geometry is streamed (text that changes often)
+	/// STATIC - geometry is uploaded once and kept until layer changes
+	/// </summary>
+	enum class LayerType 
+	{ 
+		DYNAMIC = 0, 
+		STATIC = 1 
+	};
 	
 	static StringRenderer* CreateSingleColor(Color color, const FontBuilderSettings& fs, 
 		const RenderSettings& r);
 	static StringRenderer* CreateDefault(const FontBuilderSettings& fs,
 		const RenderSettings& r);
+	static StringRenderer* CreateInstanced(const FontBuilderSettings& fs,
+		const RenderSettings& r);
+	static StringRenderer* CreateWithBackground(const BackgroundSettings& bs, 
+		const FontBuilderSettings& fs, const RenderSettings& r);
 	
 	StringRenderer(const FontBuilderSettings& fs, std::unique_ptr<BackendBase>&& backend);
 	StringRenderer(std::shared_ptr<IFontBuilder> fb, std::unique_ptr<BackendBase>&& backend);
@@ -105,6 +136,11 @@ public:
 	~StringRenderer();
 		
 	void Clear();
+	void ClearLayer(uint8_t layer);
+
+	void SetActiveLayer(uint8_t layer);
+	uint8_t GetActiveLayer() const noexcept;
+	void SetLayerType(uint8_t layer, LayerType type);
 
 	size_t GetStringsCount() const noexcept;
 	StringInfo* GetStringInfo(size_t index);
@@ -164,9 +200,25 @@ protected:
 
 	typedef std::vector<std::tuple<GlyphInfo*, FontInfo *>> UsedGlyphCache;
 	
-	
+	/// <summary>
+	/// Layer state - changed layers are generated 
+	/// again during next GenerateGeometry
+	/// </summary>
+	struct LayerInfo
+	{
+		LayerType type;
+		bool changed;
+	};
+
 	std::vector<StringInfo> strs;
 
+	//layers sorted by id = render order
+	std::map<uint8_t, LayerInfo> layers;
+	uint8_t activeLayer;
+
+	//layers were generated to backend layer buffers (see BackendBase::IsLayerSupported)
+	bool layersInBackend;
+
 	bool isBidiEnabled;		
 	bool spaceSizeExist;
 	
@@ -178,7 +230,7 @@ protected:
 
 	void CalcSpaceSize();
 
-	bool CanAddString(const StringUtf8& uniStr,
+	bool CanAddString(const StringUtf8& uniStr, const std::u32string& codePoints,
 		int x, int y, const RenderParams & rp,
 		TextAnchor anchor, TextAlign align, TextType type) const;
 
@@ -191,15 +243,18 @@ protected:
 		TextType type = TextType::TEXT);
 
 	bool GenerateGeometry() override;
+	void AddStringGeometry(const StringInfo& si);
+
+	bool IsMainLayer(uint8_t layer, const LayerInfo& li) const noexcept;
 
-	AABB EstimateStringAABB(const StringUtf8& str, float x, float y, float scale) const;
+	AABB EstimateStringAABB(const std::u32string& codePoints, float x, float y, float scale) const;
 	void CalcStringAABB(StringInfo & str, const UsedGlyphCache * gc) const;
 
 	void CalcAnchoredPosition();
 	void CalcAnchoredPosition(StringInfo& si, float& captionMarkHeight);
 	void CalcLineAlign(const StringInfo & si, const LineInfo & li, float & x, float & y) const;
 
-	UsedGlyphCache ExtractGlyphs(const StringUtf8& str);
+	UsedGlyphCache ExtractGlyphs(const std::u32string& codePoints);
 };
 
 #endif
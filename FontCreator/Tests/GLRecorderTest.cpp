@@ -0,0 +1,78 @@
+//=====================================================================================
+// Render frames of string renderer through recording OpenGL implementation
+// and check recorded counters and content of uploaded geometry buffer
+//=====================================================================================
+
+#include "./TestUtils.h"
+
+#include <memory>
+#include <vector>
+
+#include "../Renderers/StringRenderer.h"
+#include "../Backends/Shaders/DefaultFontShaderManager.h"
+
+int main()
+{
+	if (IsTestFontAvailable() == false)
+	{
+		return TEST_SKIPPED;
+	}
+
+	GLRecorder& rec = GLRecorder::GetInstance();
+	rec.Reset();
+
+	FontBuilderSettings fs = CreateTestFontSettings();
+	RenderSettings r = CreateTestRenderSettings();
+
+	auto sm = std::make_shared<DefaultFontShaderManager>(fs.sdf, r.useQuantizedVertices);
+	auto backend = std::make_unique<TestBackendOpenGL>(r, nullptr, nullptr, sm);
+	TestBackendOpenGL* gl = backend.get();
+
+	auto sr = std::make_unique<StringRenderer>(fs, std::move(backend));
+
+	sr->AddString(u8"Hello world", 100, 100);
+
+	//first frame - texture and geometry are uploaded
+	rec.BeginFrame();
+	sr->Render();
+
+	const GLRecorder::Stats first = rec.GetFrameStats();
+	const std::vector<float>& geom = gl->GetGeometry();
+	const size_t geomBytes = geom.size() * sizeof(float);
+
+	TEST_CHECK(geom.empty() == false);
+	TEST_CHECK(first.drawCalls == 1);
+	TEST_CHECK(first.textureBytes > 0);
+	TEST_CHECK(first.bufferBytes >= geomBytes);
+	TEST_CHECK(rec.GetCallsCount("glDrawElements") == 1);
+
+	const std::vector<uint8_t>* data = rec.GetBufferData(gl->GetVbo());
+	TEST_CHECK(data != nullptr);
+	TEST_CHECK(data->size() >= geomBytes);
+	TEST_CHECK(memcmp(data->data(), geom.data(), geomBytes) == 0);
+
+	//nothing changed - only draw
+	rec.BeginFrame();
+	sr->Render();
+
+	const GLRecorder::Stats second = rec.GetFrameStats();
+	TEST_CHECK(second.drawCalls == 1);
+	TEST_CHECK(second.bufferBytes == 0);
+	TEST_CHECK(second.textureBytes == 0);
+
+	//string cleared - nothing is drawn
+	sr->Clear();
+
+	rec.BeginFrame();
+	sr->Render();
+
+	TEST_CHECK(rec.GetFrameStats().drawCalls == 0);
+	TEST_CHECK(rec.GetTotalStats().drawCalls == 2);
+
+	//all buffers (including shared quad index buffer) are released with the last backend
+	sr = nullptr;
+	TEST_CHECK(rec.GetBuffersCount() == 0);
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,103 @@
+//=====================================================================================
+// Check that GLStateCache skips redundant binds
+// Library is built with USE_GL_STATE_CACHE, issued calls are counted by GLRecorder
+//=====================================================================================
+
+#include "./TestUtils.h"
+
+#include <memory>
+
+#include "../Renderers/StringRenderer.h"
+#include "../Backends/GLStateCache.h"
+
+/// <summary>
+/// Number of binds of objects managed by cache in current frame
+/// </summary>
+/// <param name="rec"></param>
+/// <returns></returns>
+static size_t GetCachedBindsCount(const GLRecorder& rec)
+{
+	return rec.GetCallsCount("glUseProgram") +
+		rec.GetCallsCount("glBindVertexArray") +
+		rec.GetCallsCount("glActiveTexture") +
+		rec.GetCallsCount("glBindTexture");
+}
+
+int main()
+{
+	GLRecorder& rec = GLRecorder::GetInstance();
+	rec.Reset();
+
+	GLStateCache cache;
+	GLStateCache::SetCurrent(&cache);
+
+	//direct use - only changes are issued
+	rec.BeginFrame();
+
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+
+	for (int i = 0; i < 10; i++)
+	{
+		cache.UseProgram(3);
+		cache.BindArrayBuffer(buffer);
+	}
+
+	TEST_CHECK(rec.GetCallsCount("glUseProgram") == 1);
+	TEST_CHECK(rec.GetCallsCount("glBindBuffer") == 1);
+	TEST_CHECK(cache.GetStats().issued == 2);
+	TEST_CHECK(cache.GetStats().skipped == 18);
+
+	//deleted buffer is forgotten - bind of reused name must be issued
+	cache.DeleteBuffer(buffer);
+	TEST_CHECK(rec.GetBoundBuffer(GL_ARRAY_BUFFER) == 0);
+
+	cache.BindArrayBuffer(buffer);
+	TEST_CHECK(rec.GetCallsCount("glBindBuffer") == 2);
+
+	cache.UnbindAll();
+	cache.ResetStats();
+
+	if (IsTestFontAvailable() == false)
+	{
+		GLStateCache::SetCurrent(nullptr);
+		return TEST_SKIPPED;
+	}
+
+	//rendering
+	FontBuilderSettings fs = CreateTestFontSettings();
+	RenderSettings r = CreateTestRenderSettings();
+
+	auto sr = std::unique_ptr<StringRenderer>(StringRenderer::CreateDefault(fs, r));
+	sr->AddString(u8"Hello world", 100, 100);
+
+	rec.BeginFrame();
+	sr->Render();
+
+	TEST_CHECK(rec.GetFrameStats().drawCalls == 1);
+
+	//objects stay bound between frames - nothing to bind again
+	cache.SetDeferredUnbind(true);
+
+	rec.BeginFrame();
+	sr->Render();
+
+	const size_t bindsFirst = GetCachedBindsCount(rec);
+
+	rec.BeginFrame();
+	sr->Render();
+
+	TEST_CHECK(rec.GetFrameStats().drawCalls == 1);
+	TEST_CHECK(GetCachedBindsCount(rec) == 0);
+	TEST_CHECK(bindsFirst > 0);
+	TEST_CHECK(cache.GetStats().skipped > 0);
+
+	cache.UnbindAll();
+	TEST_CHECK(rec.GetProgram() == 0);
+
+	sr = nullptr;
+	GLStateCache::SetCurrent(nullptr);
+
+	printf("OK\n");
+	return 0;
+}
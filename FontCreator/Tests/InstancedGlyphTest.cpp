@@ -0,0 +1,124 @@
+//=====================================================================================
+// Render instanced string through recording OpenGL implementation
+// and check that uploaded buffer contains instances from FillInstanceData
+//=====================================================================================
+
+#include "./TestUtils.h"
+
+#include <memory>
+#include <vector>
+
+#include "../Renderers/StringRenderer.h"
+#include "../Backends/Shaders/InstancedGlyphShaderManager.h"
+
+/// <summary>
+/// Instanced shader manager that remembers quads passed from backend
+/// </summary>
+class TestInstancedGlyphShaderManager : public InstancedGlyphShaderManager
+{
+public:
+	struct Quad
+	{
+		AbstractRenderer::Vertex minVertex;
+		AbstractRenderer::Vertex maxVertex;
+		Color color;
+	};
+
+	std::vector<Quad> quads;
+
+	using InstancedGlyphShaderManager::InstancedGlyphShaderManager;
+
+	void FillQuadVertexData(const AbstractRenderer::Vertex& minVertex,
+		const AbstractRenderer::Vertex& maxVertex,
+		const AbstractRenderer::RenderParams& rp,
+		std::vector<float>& vec) override
+	{
+		this->quads.push_back({ minVertex, maxVertex, rp.color });
+		InstancedGlyphShaderManager::FillQuadVertexData(minVertex, maxVertex, rp, vec);
+	}
+};
+
+int main()
+{
+	if (IsTestFontAvailable() == false)
+	{
+		return TEST_SKIPPED;
+	}
+
+	GLRecorder& rec = GLRecorder::GetInstance();
+	rec.Reset();
+
+	FontBuilderSettings fs = CreateTestFontSettings();
+	RenderSettings r = CreateTestRenderSettings();
+
+	auto sm = std::make_shared<TestInstancedGlyphShaderManager>(fs.sdf);
+	auto backend = std::make_unique<TestBackendOpenGL>(r, nullptr, nullptr, sm);
+	TestBackendOpenGL* gl = backend.get();
+
+	auto sr = std::make_unique<StringRenderer>(fs, std::move(backend));
+
+	const Color red = { 1, 0, 0, 1 };
+	const Color blue = { 0, 0, 1, 0.5f };
+
+	sr->AddString(u8"Hello", 100, 100, StringRenderer::RenderParams(red, 1.0f));
+	sr->AddString(u8"World", 100, 200, StringRenderer::RenderParams(blue, 1.0f));
+
+	rec.BeginFrame();
+	sr->Render();
+
+	//one instance per visible glyph
+	const size_t instancesCount = sm->quads.size();
+	TEST_CHECK(instancesCount == 10);
+	TEST_CHECK(rec.GetCallsCount("glDrawArraysInstanced") == 1);
+
+	bool instancedDrawFound = false;
+	for (const GLRecorder::Call& c : rec.GetCalls())
+	{
+		if (strcmp(c.name, "glDrawArraysInstanced") == 0)
+		{
+			//mode, first, count (unit quad vertices), instancecount
+			TEST_CHECK(c.args.size() > 0);
+			TEST_CHECK(c.args.substr(c.args.rfind(", ") + 2) == std::to_string(instancesCount));
+			instancedDrawFound = true;
+		}
+	}
+	TEST_CHECK(instancedDrawFound);
+
+	//expected instances
+	std::vector<float> expected;
+	for (const TestInstancedGlyphShaderManager::Quad& q : sm->quads)
+	{
+		InstancedGlyphShaderManager::FillInstanceData(q.minVertex, q.maxVertex, q.color, expected);
+	}
+
+	TEST_CHECK(expected.size() == instancesCount * InstancedGlyphShaderManager::INSTANCE_SIZE);
+	TEST_CHECK(gl->GetGeometry() == expected);
+
+	for (size_t i = 0; i < instancesCount; i++)
+	{
+		TEST_CHECK(InstancedGlyphShaderManager::IsInstanceValid(expected.data() + i * InstancedGlyphShaderManager::INSTANCE_SIZE));
+	}
+
+	//uploaded bytes
+	const size_t bytes = expected.size() * sizeof(float);
+
+	const std::vector<uint8_t>* data = rec.GetBufferData(gl->GetVbo());
+	TEST_CHECK(data != nullptr);
+	TEST_CHECK(data->size() >= bytes);
+	TEST_CHECK(memcmp(data->data(), expected.data(), bytes) == 0);
+
+	//colors are packed to the last float of instance (RGBA8 bits)
+	uint32_t first = 0;
+	uint32_t last = 0;
+	memcpy(&first, data->data() + (InstancedGlyphShaderManager::INSTANCE_SIZE - 1) * sizeof(float), sizeof(uint32_t));
+	memcpy(&last, data->data() + bytes - sizeof(float), sizeof(uint32_t));
+	TEST_CHECK(first == IShaderManager::PackColor(red));
+	TEST_CHECK(last == IShaderManager::PackColor(blue));
+
+	//all buffers (including shared unit quad) are released with the last backend
+	sr = nullptr;
+	TEST_CHECK(rec.GetBuffersCount() == 0);
+
+	printf("OK\n");
+	return 0;
+}
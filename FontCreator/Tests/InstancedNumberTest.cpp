@@ -0,0 +1,193 @@
+//=====================================================================================
+// Check CPU side of instanced numbers - packing of glyph codes
+// and instances generated by number renderer (including numbers split
+// to more instances)
+//=====================================================================================
+
+#include "./TestUtils.h"
+
+#include <memory>
+#include <string>
+#include <bit>
+
+#include "../Renderers/NumberRenderer.h"
+#include "../Backends/Shaders/InstancedNumberShaderManager.h"
+
+using INSM = InstancedNumberShaderManager;
+
+/// <summary>
+/// Number renderer with access to glyph advances
+/// </summary>
+class TestNumberRenderer : public NumberRenderer
+{
+public:
+	using NumberRenderer::NumberRenderer;
+
+	int GetAdvance(char c) const
+	{
+		return this->gi[static_cast<uint8_t>(c)].adv + this->extraGlyphSpacingSize;
+	}
+};
+
+/// <summary>
+/// Get packed codes of instance
+/// </summary>
+/// <param name="instance"></param>
+/// <param name="lo"></param>
+/// <param name="hi"></param>
+static void GetInstanceCodes(const float* instance, uint32_t& lo, uint32_t& hi)
+{
+	lo = std::bit_cast<uint32_t>(instance[INSM::INSTANCE_SIZE - 2]);
+	hi = std::bit_cast<uint32_t>(instance[INSM::INSTANCE_SIZE - 1]);
+}
+
+/// <summary>
+/// Decode characters of instance
+/// </summary>
+/// <param name="instance"></param>
+/// <returns></returns>
+static std::string DecodeInstance(const float* instance)
+{
+	uint32_t lo, hi;
+	GetInstanceCodes(instance, lo, hi);
+
+	std::string str;
+	for (int i = 0; i < INSM::MAX_GLYPHS; i++)
+	{
+		const uint8_t code = INSM::GetPackedCode(lo, hi, i);
+		if (code == INSM::END)
+		{
+			break;
+		}
+		str += INSM::CODE_CHARS[code];
+	}
+	return str;
+}
+
+static int TestPacking()
+{
+	uint32_t lo, hi;
+
+	const char* str = "-12.5e+07";
+	TEST_CHECK(INSM::PackCodes(str, 9, lo, hi));
+	for (int i = 0; i < 9; i++)
+	{
+		TEST_CHECK(INSM::CODE_CHARS[INSM::GetPackedCode(lo, hi, i)] == str[i]);
+	}
+	for (int i = 9; i < INSM::MAX_GLYPHS; i++)
+	{
+		TEST_CHECK(INSM::GetPackedCode(lo, hi, i) == INSM::END);
+	}
+
+	//full instance
+	TEST_CHECK(INSM::PackCodes("0123456789012345", 16, lo, hi));
+	TEST_CHECK(INSM::GetPackedCode(lo, hi, 15) == 5);
+
+	//too long or unknown character - empty instance
+	TEST_CHECK(INSM::PackCodes("01234567890123456", 17, lo, hi) == false);
+	TEST_CHECK((lo == 0xFFFFFFFF) && (hi == 0xFFFFFFFF));
+	TEST_CHECK(INSM::PackCodes("1x", 2, lo, hi) == false);
+	TEST_CHECK(INSM::GetPackedCode(lo, hi, 0) == INSM::END);
+
+	TEST_CHECK(INSM::GetInstancesCount(0) == 1);
+	TEST_CHECK(INSM::GetInstancesCount(16) == 1);
+	TEST_CHECK(INSM::GetInstancesCount(17) == 2);
+	TEST_CHECK(INSM::GetInstancesCount(33) == 3);
+
+	//codes are stored as raw bits
+	TEST_CHECK(INSM::PackCodes("42", 2, lo, hi));
+
+	std::vector<float> v;
+	INSM::FillInstanceData(10.0f, 20.0f, 1.5f, Color(1, 0, 0, 1), lo, hi, v);
+	TEST_CHECK(v.size() == INSM::INSTANCE_SIZE);
+	TEST_CHECK((v[0] == 10.0f) && (v[1] == 20.0f) && (v[2] == 1.5f));
+	TEST_CHECK(DecodeInstance(v.data()) == "42");
+
+	return 0;
+}
+
+static int TestRenderer()
+{
+	FontBuilderSettings fs = CreateTestFontSettings();
+	RenderSettings r = CreateTestRenderSettings();
+
+	auto sm = std::make_shared<InstancedNumberShaderManager>(fs.sdf);
+	auto backend = std::make_unique<TestBackendOpenGL>(r, nullptr, nullptr, sm);
+	TestBackendOpenGL* gl = backend.get();
+
+	auto nr = std::make_unique<TestNumberRenderer>(fs, std::move(backend));
+
+	nr->AddNumber(42, 10, 100);
+
+	//20 glyphs - split to 2 instances
+	const int64_t longValue = -1234567890123456789LL;
+	const std::string longStr = std::to_string(longValue);
+	nr->AddNumber(longValue, 10, 200);
+
+	const size_t slot = nr->AddNumberSlot(10, 300, 20);
+	nr->UpdateValue(slot, longValue);
+
+	nr->Render();
+
+	const std::vector<float>& geom = gl->GetGeometry();
+	TEST_CHECK(geom.size() == 5 * INSM::INSTANCE_SIZE);
+
+	const float* instance = geom.data();
+	TEST_CHECK(DecodeInstance(instance) == "42");
+
+	//long number
+	instance += INSM::INSTANCE_SIZE;
+	const float* next = instance + INSM::INSTANCE_SIZE;
+
+	TEST_CHECK(DecodeInstance(instance) + DecodeInstance(next) == longStr);
+	TEST_CHECK(DecodeInstance(next) == longStr.substr(INSM::MAX_GLYPHS));
+
+	float x = instance[0];
+	for (int i = 0; i < INSM::MAX_GLYPHS; i++)
+	{
+		x += static_cast<float>(nr->GetAdvance(longStr[i]));
+	}
+	TEST_CHECK(next[0] == x);
+	TEST_CHECK(next[1] == instance[1]);
+
+	//slot has always 2 instances
+	instance = next + INSM::INSTANCE_SIZE;
+	next = instance + INSM::INSTANCE_SIZE;
+
+	TEST_CHECK(DecodeInstance(instance) + DecodeInstance(next) == longStr);
+
+	TEST_CHECK(nr->UpdateValue(slot, 7));
+	nr->Render();
+
+	TEST_CHECK(gl->GetGeometry().size() == 5 * INSM::INSTANCE_SIZE);
+	TEST_CHECK(DecodeInstance(instance) == "7");
+
+	uint32_t lo, hi;
+	GetInstanceCodes(next, lo, hi);
+	TEST_CHECK((lo == 0xFFFFFFFF) && (hi == 0xFFFFFFFF));
+
+	return 0;
+}
+
+int main()
+{
+	if (TestPacking() != 0)
+	{
+		return 1;
+	}
+
+	if (IsTestFontAvailable() == false)
+	{
+		return TEST_SKIPPED;
+	}
+
+	GLRecorder::GetInstance().Reset();
+
+	if (TestRenderer() != 0)
+	{
+		return 1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
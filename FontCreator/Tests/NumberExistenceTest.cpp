@@ -0,0 +1,51 @@
+//=====================================================================================
+// Check existence test of number renderer - same number on the same position
+// is rejected, even if it was added while the test was disabled
+//=====================================================================================
+
+#include "./TestUtils.h"
+
+#include <memory>
+
+#include "../Renderers/NumberRenderer.h"
+
+int main()
+{
+	if (IsTestFontAvailable() == false)
+	{
+		return TEST_SKIPPED;
+	}
+
+	GLRecorder::GetInstance().Reset();
+
+	FontBuilderSettings fs = CreateTestFontSettings();
+	RenderSettings r = CreateTestRenderSettings();
+
+	std::unique_ptr<NumberRenderer> nr(NumberRenderer::CreateDefault(fs, r));
+
+	TEST_CHECK(nr->AddNumber(42, 10, 100));
+	TEST_CHECK(nr->AddNumber(42, 10, 100) == false);
+	TEST_CHECK(nr->GetNumbersCount() == 1);
+
+	//check disabled - duplicates are allowed
+	nr->Clear();
+	nr->SetExistenceCheck(false);
+
+	TEST_CHECK(nr->AddNumber(7, 10, 100));
+	TEST_CHECK(nr->AddNumber(7, 10, 100));
+	TEST_CHECK(nr->GetNumbersCount() == 2);
+
+	//check enabled again - numbers added without check are known
+	nr->SetExistenceCheck(true);
+
+	TEST_CHECK(nr->AddNumber(7, 10, 100) == false);
+	TEST_CHECK(nr->GetNumbersCount() == 2);
+
+	//different value or position is still added
+	TEST_CHECK(nr->AddNumber(8, 10, 100));
+	TEST_CHECK(nr->AddNumber(7, 10, 200));
+	TEST_CHECK(nr->GetNumbersCount() == 4);
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,85 @@
+//=====================================================================================
+// Check CPU pass timings of RenderProfiler on image backend
+// (image backend does not use OpenGL, GPU times are never measured)
+//=====================================================================================
+
+#include "./TestUtils.h"
+
+#include <memory>
+
+#include "../Renderers/StringRenderer.h"
+#include "../Backends/BackendImage.h"
+
+int main()
+{
+	if (IsTestFontAvailable() == false)
+	{
+		return TEST_SKIPPED;
+	}
+
+	FontBuilderSettings fs = CreateTestFontSettings();
+	RenderSettings r = CreateTestRenderSettings();
+
+	auto backend = std::make_unique<BackendImage>(r, BackendImage::Format::RGBA);
+	BackendImage* img = backend.get();
+
+	auto sr = std::make_unique<StringRenderer>(fs, std::move(backend));
+
+	TEST_CHECK(img->GetProfiler() == nullptr);
+
+	img->SetProfilingEnabled(true);
+
+	RenderProfiler* p = img->GetProfiler();
+	TEST_CHECK(p != nullptr);
+	TEST_CHECK(p->GetFramesCount() == 0);
+
+	sr->AddString(u8"Hello world", 100, 100);
+
+	const int FRAMES = 20;
+	for (int i = 0; i < FRAMES; i++)
+	{
+		sr->Render();
+	}
+
+	//ring keeps FRAMES_COUNT - 1 finished frames
+	TEST_CHECK(p->GetFramesCount() == RenderProfiler::FRAMES_COUNT - 1);
+	TEST_CHECK(p->GetFrameStats(0).frame == FRAMES - 1);
+	TEST_CHECK(p->GetFrameStats(1).frame == FRAMES - 2);
+
+	const int glyphs = static_cast<int>(RenderProfiler::Pass::GLYPHS);
+
+	for (size_t age = 0; age < p->GetFramesCount(); age++)
+	{
+		const RenderProfiler::FrameStats& st = p->GetFrameStats(age);
+
+		TEST_CHECK(st.cpuMs[glyphs] > 0.0);
+		TEST_CHECK(st.cpuFrameMs >= st.cpuMs[glyphs]);
+		TEST_CHECK(st.gpuReady == false);
+
+		for (int i = 0; i < RenderProfiler::PASS_COUNT; i++)
+		{
+			TEST_CHECK(st.gpuMs[i] == 0.0);
+			if (i != glyphs)
+			{
+				//not executed by image backend
+				TEST_CHECK(st.cpuMs[i] == 0.0);
+			}
+		}
+	}
+
+	//empty frame is counted, glyphs are not rendered
+	sr->Clear();
+	sr->Render();
+
+	TEST_CHECK(p->GetFrameStats(0).frame == FRAMES);
+	TEST_CHECK(p->GetFrameStats(0).cpuMs[glyphs] == 0.0);
+
+	p->Reset();
+	TEST_CHECK(p->GetFramesCount() == 0);
+
+	img->SetProfilingEnabled(false);
+	TEST_CHECK(img->GetProfiler() == nullptr);
+
+	printf("OK\n");
+	return 0;
+}
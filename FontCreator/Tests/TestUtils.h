@@ -0,0 +1,90 @@
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+//=====================================================================================
+// Minimal helpers shared by headless tests
+// Every test is one executable - 0 = passed, 1 = failed, 77 = skipped
+//=====================================================================================
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#include <vector>
+
+#include "../FontStructures.h"
+#include "../Backends/BackendOpenGL.h"
+
+#define TEST_SKIPPED 77
+
+#define TEST_CHECK(expr) do { \
+		if (!(expr)) { \
+			printf("%s:%i - check failed: %s\n", __FILE__, __LINE__, #expr); \
+			return 1; \
+		} \
+	} while (0)
+
+/// <summary>
+/// Get settings of font builder with test font
+/// Font path is set by CMake (see FONT_CREATOR_TEST_FONT)
+/// </summary>
+/// <returns></returns>
+static inline FontBuilderSettings CreateTestFontSettings()
+{
+	Font f;
+	f.name = TEST_FONT_PATH;
+	f.size = 20_px;
+
+	FontBuilderSettings fs;
+	fs.fonts = { f };
+	fs.textureW = 512;
+	fs.textureH = 512;
+	fs.screenDpi = 0;
+	fs.screenScale = 1.0f;
+
+	return fs;
+}
+
+/// <summary>
+/// Test if test font is available
+/// </summary>
+/// <returns></returns>
+static inline bool IsTestFontAvailable()
+{
+	if (strlen(TEST_FONT_PATH) == 0)
+	{
+		printf("Test font not found - skipped\n");
+		return false;
+	}
+	return true;
+}
+
+static inline RenderSettings CreateTestRenderSettings()
+{
+	RenderSettings r;
+	r.deviceW = 800;
+	r.deviceH = 600;
+
+	return r;
+}
+
+/// <summary>
+/// Backend with access to geometry and currently used buffer
+/// </summary>
+class TestBackendOpenGL : public BackendOpenGL
+{
+public:
+	using BackendOpenGL::BackendOpenGL;
+
+	const std::vector<float>& GetGeometry() const
+	{
+		return this->geom;
+	}
+
+	GLuint GetVbo() const
+	{
+		return this->vbo;
+	}
+};
+
+#endif
@@ -228,6 +228,20 @@ const uint8_t* CustomImageFontBuilder::GetTextureData() const
 	return this->texPacker->GetTextureData();
 }
 
+/// <summary>
+/// Get region of texture changed by last CreateFontAtlas
+/// </summary>
+/// <returns></returns>
+TextureRegion CustomImageFontBuilder::GetTextureDirtyRegion() const
+{
+	return this->texPacker->GetDirtyRegion();
+}
+
+uint64_t CustomImageFontBuilder::GetTextureRevision() const
+{
+	return this->texPacker->GetRevision();
+}
+
 bool CustomImageFontBuilder::CreateFontAtlas()
 {
 	if (this->newCodes.empty())
@@ -60,6 +60,8 @@ public:
 	uint16_t GetTextureWidth() const override;
 	uint16_t GetTextureHeight() const override;
 	const uint8_t* GetTextureData() const override;
+	TextureRegion GetTextureDirtyRegion() const override;
+	uint64_t GetTextureRevision() const override;
 
 	bool CreateFontAtlas() override;
 
@@ -586,6 +586,20 @@ const uint8_t * FontBuilder::GetTextureData() const
 	return this->texPacker->GetTextureData();
 }
 
+/// <summary>
+/// Get region of texture changed by last CreateFontAtlas
+/// </summary>
+/// <returns></returns>
+TextureRegion FontBuilder::GetTextureDirtyRegion() const
+{
+	return this->texPacker->GetDirtyRegion();
+}
+
+uint64_t FontBuilder::GetTextureRevision() const
+{
+	return this->texPacker->GetRevision();
+}
+
 /// <summary>
 /// Save font texture to file
 /// </summary>
@@ -57,6 +57,8 @@ public:
 	uint16_t GetTextureWidth() const override;
 	uint16_t GetTextureHeight() const override;
 	const uint8_t * GetTextureData() const override;
+	TextureRegion GetTextureDirtyRegion() const override;
+	uint64_t GetTextureRevision() const override;
 
 	bool CreateFontAtlas() override;
 		
@@ -66,7 +68,7 @@ public:
 
 protected:
 
-	static const int LETTER_BORDER_SIZE = 0;
+	static constexpr int LETTER_BORDER_SIZE = 0;
 
 	float screenScale;
 	uint16_t screenDpi;
@@ -30,6 +30,13 @@ public:
 	virtual uint16_t GetTextureHeight() const = 0;
 	virtual const uint8_t* GetTextureData() const = 0;
 
+	/// <summary>
+	/// Region of texture changed by last successful CreateFontAtlas
+	/// Revision is incremented by every change (0 - unknown, upload entire texture)
+	/// </summary>
+	virtual TextureRegion GetTextureDirtyRegion() const = 0;
+	virtual uint64_t GetTextureRevision() const = 0;
+
 	virtual bool CreateFontAtlas() = 0;
 
 };
@@ -20,7 +20,8 @@ TextureAtlasPack::TextureAtlasPack(uint16_t w, uint16_t h,
 	method(PACKING_METHOD::TIGHT),
 	freePixels(w * h),
 	averageGlyphSize(2500),
-	gridBinW(0), gridBinH(0)
+	gridBinW(0), gridBinH(0),
+	revision(0)
 {
 		
 	std::random_device rd;
@@ -147,6 +148,24 @@ const uint8_t * TextureAtlasPack::GetTextureData() const
 	return this->rawPackedData;
 }
 
+/// <summary>
+/// Get region of texture changed by last Pack
+/// </summary>
+/// <returns></returns>
+TextureRegion TextureAtlasPack::GetDirtyRegion() const
+{
+	return this->dirty;
+}
+
+/// <summary>
+/// Get number of Pack calls (texture can be changed by each of them)
+/// </summary>
+/// <returns></returns>
+uint64_t TextureAtlasPack::GetRevision() const
+{
+	return this->revision;
+}
+
 //======================== Create atlas ===========================================
 
 void TextureAtlasPack::Clear()
@@ -176,6 +195,9 @@ bool TextureAtlasPack::Pack()
 {	
 	this->RemoveErasedGlyphsFromFontInfo();
 
+	this->dirty = TextureRegion();
+	this->revision++;
+
 	bool res = false;
 	if (this->method == PACKING_METHOD::GRID)
 	{
@@ -432,6 +454,11 @@ void TextureAtlasPack::CopyDataToTexture()
 				}
 			}
 
+			//bin with border and debug border
+			this->dirty.Update(it->second.x, it->second.y,
+				std::min<int>(std::max<int>(it->second.width, g.bmpW + 2 * this->border), this->w - it->second.x),
+				std::min<int>(std::max<int>(it->second.height, g.bmpH + 2 * this->border), this->h - it->second.y));
+
 			//draw "border around letter"
 			//if there was some previous letter - it will remove its remains
 			this->DrawBorder(it->second.x, it->second.y,
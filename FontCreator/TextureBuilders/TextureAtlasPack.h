@@ -47,6 +47,8 @@ public:
 	uint16_t GetTextureWidth() const;
 	uint16_t GetTextureHeight() const;
 	const uint8_t * GetTextureData() const;
+	TextureRegion GetDirtyRegion() const;
+	uint64_t GetRevision() const;
 	
 	bool Pack();
 
@@ -100,6 +102,10 @@ private:
 
 	int freePixels;
 	uint8_t * rawPackedData;	
+
+	//part of rawPackedData changed by last Pack
+	TextureRegion dirty;
+	uint64_t revision;
 	HashMap<CHAR_ID, PackedInfo> packedInfo;
 	
 	void Clear();
@@ -1,19 +1,83 @@
 #include "./BidiHelper.h"
 
 #ifdef USE_ICU_LIBRARY
-
-#include "./ICUUtils.h"
+#	include "./ICUUtils.h"
+#endif
 
 //http://icu-project.org/apiref/icu4c/ubidi_8h.html
 
-bool BidiHelper::RequiresBidi(const icu::UnicodeString& str)
+//Code points with Bidi_Class R or AL (strong RTL, this also covers
+//all Arabic joining letters) + explicit RTL formatting characters
+//Ranges are sorted, so we can use binary search
+//https://www.unicode.org/Public/UCD/latest/ucd/extracted/DerivedBidiClass.txt
+const BidiHelper::CodeRange BidiHelper::RTL_RANGES[] = {
+	{ 0x05BE, 0x05BE }, { 0x05C0, 0x05C0 }, { 0x05C3, 0x05C3 }, { 0x05C6, 0x05C6 },
+	{ 0x05D0, 0x05EA }, { 0x05EF, 0x05F4 }, //Hebrew
+	{ 0x0608, 0x0608 }, { 0x060B, 0x060B }, { 0x060D, 0x060D }, { 0x061B, 0x064A },
+	{ 0x066D, 0x066F }, { 0x0671, 0x06D5 }, { 0x06E5, 0x06E6 }, { 0x06EE, 0x06EF },
+	{ 0x06FA, 0x070D }, { 0x070F, 0x0710 }, { 0x0712, 0x072F }, { 0x074D, 0x07A5 },
+	{ 0x07B1, 0x07B1 }, //Arabic, Syriac, Thaana
+	{ 0x07C0, 0x07EA }, { 0x07F4, 0x07F5 }, { 0x07FA, 0x07FA }, { 0x07FE, 0x0815 },
+	{ 0x081A, 0x081A }, { 0x0824, 0x0824 }, { 0x0828, 0x0828 }, { 0x0830, 0x083E },
+	{ 0x0840, 0x0858 }, { 0x085E, 0x085E }, { 0x0860, 0x086A }, { 0x0870, 0x088E },
+	{ 0x08A0, 0x08C9 }, //NKo, Samaritan, Mandaic, Arabic Extended
+	{ 0x200F, 0x200F }, { 0x202B, 0x202B }, { 0x202E, 0x202E }, { 0x2067, 0x2067 }, //RLM, RLE, RLO, RLI
+	{ 0xFB1D, 0xFB1D }, { 0xFB1F, 0xFB28 }, { 0xFB2A, 0xFD3D }, { 0xFD50, 0xFDC7 },
+	{ 0xFDF0, 0xFDFC }, { 0xFE70, 0xFEFC }, //presentation forms
+	{ 0x10800, 0x10FFF }, { 0x1E800, 0x1EFFF } //historic RTL scripts, Adlam, Arabic math
+};
+
+const size_t BidiHelper::RTL_RANGES_COUNT = sizeof(BidiHelper::RTL_RANGES) / sizeof(BidiHelper::CodeRange);
+
+/// <summary>
+/// Test if code point has strong RTL direction
+/// (Bidi_Class R or AL)
+/// </summary>
+/// <param name="c"></param>
+/// <returns></returns>
+bool BidiHelper::IsStrongRtl(char32_t c) noexcept
 {
-	//383 - end of Latin Extended-A
-	//https://en.wikipedia.org/wiki/List_of_Unicode_characters
+	//fast path - everything before Hebrew block is LTR or neutral
+	if ((c < RTL_RANGES[0].start) || (c > RTL_RANGES[RTL_RANGES_COUNT - 1].end))
+	{
+		return false;
+	}
 
+	size_t l = 0;
+	size_t r = RTL_RANGES_COUNT;
+	while (l < r)
+	{
+		size_t m = (l + r) / 2;
+		if (c < RTL_RANGES[m].start)
+		{
+			r = m;
+		}
+		else if (c > RTL_RANGES[m].end)
+		{
+			l = m + 1;
+		}
+		else
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#ifdef USE_ICU_LIBRARY
+/// <summary>
+/// Test if string contains at least one RTL character
+/// If not, bidi and shaping is not needed and string
+/// can be used as-is
+/// </summary>
+/// <param name="str"></param>
+/// <returns></returns>
+bool BidiHelper::RequiresBidi(const icu::UnicodeString& str)
+{
 	FOREACH_32_CHAR_ITERATION(c, str)
 	{
-		if (c > 383)
+		if (BidiHelper::IsStrongRtl(c))
 		{
 			return true;
 		}
@@ -21,17 +85,15 @@ bool BidiHelper::RequiresBidi(const icu::UnicodeString& str)
 
 	return false;
 }
+#endif
 
 bool BidiHelper::RequiresBidi(const std::u8string& str)
 {
-	//383 - end of Latin Extended-A
-	//https://en.wikipedia.org/wiki/List_of_Unicode_characters
-
 	CustomU8Iterator it(str);
 	char32_t b;
 	while ((b = it.GetCurrentAndAdvance()) != it.DONE)
 	{
-		if (b > 383)
+		if (BidiHelper::IsStrongRtl(b))
 		{
 			return true;
 		}
@@ -40,22 +102,69 @@ bool BidiHelper::RequiresBidi(const std::u8string& str)
 	return false;
 }
 
+LruCache<std::u8string, std::u8string>& BidiHelper::GetCache()
+{
+	static LruCache<std::u8string, std::u8string> cache(DEFAULT_CACHE_SIZE);
+	return cache;
+}
+
+/// <summary>
+/// Set maximal number of cached ConvertOneLine results
+/// 0 - disable cache
+/// </summary>
+/// <param name="maxItems"></param>
+void BidiHelper::SetCacheSize(size_t maxItems)
+{
+	BidiHelper::GetCache().SetCapacity(maxItems);
+}
+
+void BidiHelper::ClearCache()
+{
+	BidiHelper::GetCache().Clear();
+}
+
+#ifdef USE_ICU_LIBRARY
 icu::UnicodeString BidiHelper::ConvertOneLine(const icu::UnicodeString& str)
 {
 	BidiHelper h(str);
 	h.RunOneLine();
 	return h.GetVisualRepresentation();
 }
-
+#endif
+
+/// <summary>
+/// Convert UTF-8 string to visual representation
+/// Without ICU, built-in UAX #9 implementation is used
+/// Results are cached, so repeated labels are not re-shaped
+/// </summary>
+/// <param name="str"></param>
+/// <returns></returns>
 std::u8string BidiHelper::ConvertOneLine(const std::u8string& str)
 {
+	auto& cache = BidiHelper::GetCache();
+
+	if (auto cached = cache.Get(str))
+	{
+		return std::move(*cached);
+	}
+
+#ifdef USE_ICU_LIBRARY
 	auto uniStr = IcuUtils::from_u8string(str);
 	
 	auto uniRes = BidiHelper::ConvertOneLine(uniStr);
 
-	return IcuUtils::to_u8string(uniRes);
+	auto res = IcuUtils::to_u8string(uniRes);
+#else
+	auto res = BuiltinBidi::ConvertOneLine(str);
+#endif
+
+	cache.Put(str, res);
+
+	return res;
 }
 
+#ifdef USE_ICU_LIBRARY
+
 BidiHelper::BidiHelper(const icu::UnicodeString& str) :
 	str(str),
 	pErrorCode(U_ZERO_ERROR),
@@ -107,7 +216,7 @@ bool BidiHelper::Init()
 	ubidi_setPara(para, str.getBuffer(), str.length(), UBIDI_MIXED, nullptr, &this->pErrorCode);
 	//textDirection ? UBIDI_DEFAULT_RTL : UBIDI_DEFAULT_LTR,			
 
-	if (U_SUCCESS(this->pErrorCode) == FALSE)
+	if (U_FAILURE(this->pErrorCode))
 	{
 		return false;
 	}
@@ -127,7 +236,7 @@ void BidiHelper::ProcessLine(UBiDi* lineParam, int32_t textStart, int32_t textLe
 	{
 		// mixed-directional						
 		int32_t count = ubidi_countRuns(para, &pErrorCode);
-		if (U_SUCCESS(pErrorCode) == FALSE)
+		if (U_FAILURE(pErrorCode))
 		{
 			return;
 		}
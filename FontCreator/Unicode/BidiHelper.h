@@ -3,27 +3,45 @@
 
 #include "../Externalncludes.h"
 
-#ifdef USE_ICU_LIBRARY
-
 #include <vector>
 #include <string>
 
-#include <unicode/unistr.h>
-#include <unicode/ustring.h>
-#include <unicode/ubidi.h>
-#include <unicode/ushape.h>
-#include <unicode/schriter.h>
+#ifdef USE_ICU_LIBRARY
+#	include <unicode/unistr.h>
+#	include <unicode/ustring.h>
+#	include <unicode/ubidi.h>
+#	include <unicode/ushape.h>
+#	include <unicode/schriter.h>
+#endif
+
+#include "./BuiltinBidi.h"
+#include "../Utils/LruCache.h"
 
+/// <summary>
+/// Bidi conversion of strings to visual order
+/// With USE_ICU_LIBRARY, ICU is used, otherwise
+/// built-in implementation (BuiltinBidi) is used
+/// </summary>
 class BidiHelper
 {
 public:
 
-	static bool RequiresBidi(const icu::UnicodeString& str);
+	static const size_t DEFAULT_CACHE_SIZE = 512;
+
+	static bool IsStrongRtl(char32_t c) noexcept;
+
 	static bool RequiresBidi(const std::u8string& str);
 
-	static icu::UnicodeString ConvertOneLine(const icu::UnicodeString& str);
 	static std::u8string ConvertOneLine(const std::u8string& str);
 
+	static void SetCacheSize(size_t maxItems);
+	static void ClearCache();
+
+#ifdef USE_ICU_LIBRARY
+	static bool RequiresBidi(const icu::UnicodeString& str);
+
+	static icu::UnicodeString ConvertOneLine(const icu::UnicodeString& str);
+
 	BidiHelper(const icu::UnicodeString& str);
 
 	~BidiHelper();
@@ -33,8 +51,21 @@ public:
 	icu::UnicodeString GetVisualRepresentation() const;
 
 	void RunOneLine();
+#endif
 
 protected:
+	struct CodeRange
+	{
+		char32_t start;
+		char32_t end;
+	};
+
+	static const CodeRange RTL_RANGES[];
+	static const size_t RTL_RANGES_COUNT;
+
+	static LruCache<std::u8string, std::u8string>& GetCache();
+
+#ifdef USE_ICU_LIBRARY
 	const icu::UnicodeString& str;
 	UBiDi* para;
 	UErrorCode pErrorCode;
@@ -48,8 +79,7 @@ protected:
 	void CreateRenderString(int32_t textStart, int32_t textLength, UBiDiDirection dir);
 
 	icu::UnicodeString ShapeArabic(const icu::UnicodeString& s);
+#endif
 };
 
 #endif
-
-#endif
\ No newline at end of file
@@ -0,0 +1,1590 @@
+#include "./BuiltinBidi.h"
+
+#include <algorithm>
+
+#include "../Utils/utf8/utf8.h"
+#include "../Utils/SmallBuffer.h"
+
+//=====================================================================================
+// Tables generated from Unicode 14.0.0 data
+//
+// BIDI_CLASS_RANGES - each item is (BidiClass << 24) | first code point of the range,
+//					   range ends where the next one starts. Unassigned code points
+//					   have default values from DerivedBidiClass.txt
+// ARABIC_FORMS		 - presentation forms from UnicodeData.txt decompositions
+//					   (<isolated>, <final>, <initial>, <medial>)
+// BRACKET_PAIRS	 - subset of BidiBrackets.txt (opening, closing)
+// MIRROR_PAIRS		 - subset of BidiMirroring.txt
+//=====================================================================================
+
+struct ArabicForms
+{
+	char16_t c;
+	char16_t isolated;
+	char16_t final;
+	char16_t initial;
+	char16_t medial;
+};
+
+struct LamAlef
+{
+	char16_t alef;
+	char16_t isolated;
+	char16_t final;
+};
+
+struct CodePair
+{
+	char16_t first;
+	char16_t second;
+};
+
+enum class JoiningType : uint8_t
+{
+	U, //non-joining
+	R, //right-joining
+	D, //dual-joining
+	C, //join-causing
+	T  //transparent
+};
+
+static constexpr uint32_t BIDI_CLASS_RANGES[] = {
+	0x09000000, 0x0B000009, 0x0A00000A, 0x0B00000B, 0x0C00000C, 0x0A00000D, 0x0900000E, 0x0A00001C,
+	0x0B00001F, 0x0C000020, 0x0D000021, 0x05000023, 0x0D000026, 0x0400002B, 0x0700002C, 0x0400002D,
+	0x0700002E, 0x03000030, 0x0700003A, 0x0D00003B, 0x00000041, 0x0D00005B, 0x00000061, 0x0D00007B,
+	0x0900007F, 0x0A000085, 0x09000086, 0x070000A0, 0x0D0000A1, 0x050000A2, 0x0D0000A6, 0x000000AA,
+	0x0D0000AB, 0x090000AD, 0x0D0000AE, 0x050000B0, 0x030000B2, 0x0D0000B4, 0x000000B5, 0x0D0000B6,
+	0x030000B9, 0x000000BA, 0x0D0000BB, 0x000000C0, 0x0D0000D7, 0x000000D8, 0x0D0000F7, 0x000000F8,
+	0x0D0002B9, 0x000002BB, 0x0D0002C2, 0x000002D0, 0x0D0002D2, 0x000002E0, 0x0D0002E5, 0x000002EE,
+	0x0D0002EF, 0x08000300, 0x00000370, 0x0D000374, 0x00000376, 0x0D00037E, 0x0000037F, 0x0D000384,
+	0x00000386, 0x0D000387, 0x00000388, 0x0D0003F6, 0x000003F7, 0x08000483, 0x0000048A, 0x0D00058A,
+	0x0000058B, 0x0D00058D, 0x0500058F, 0x01000590, 0x08000591, 0x010005BE, 0x080005BF, 0x010005C0,
+	0x080005C1, 0x010005C3, 0x080005C4, 0x010005C6, 0x080005C7, 0x010005C8, 0x06000600, 0x0D000606,
+	0x02000608, 0x05000609, 0x0200060B, 0x0700060C, 0x0200060D, 0x0D00060E, 0x08000610, 0x0200061B,
+	0x0800064B, 0x06000660, 0x0500066A, 0x0600066B, 0x0200066D, 0x08000670, 0x02000671, 0x080006D6,
+	0x060006DD, 0x0D0006DE, 0x080006DF, 0x020006E5, 0x080006E7, 0x0D0006E9, 0x080006EA, 0x020006EE,
+	0x030006F0, 0x020006FA, 0x08000711, 0x02000712, 0x08000730, 0x0200074B, 0x080007A6, 0x020007B1,
+	0x010007C0, 0x080007EB, 0x010007F4, 0x0D0007F6, 0x010007FA, 0x080007FD, 0x010007FE, 0x08000816,
+	0x0100081A, 0x0800081B, 0x01000824, 0x08000825, 0x01000828, 0x08000829, 0x0100082E, 0x08000859,
+	0x0100085C, 0x02000860, 0x06000890, 0x02000892, 0x08000898, 0x020008A0, 0x080008CA, 0x060008E2,
+	0x080008E3, 0x00000903, 0x0800093A, 0x0000093B, 0x0800093C, 0x0000093D, 0x08000941, 0x00000949,
+	0x0800094D, 0x0000094E, 0x08000951, 0x00000958, 0x08000962, 0x00000964, 0x08000981, 0x00000982,
+	0x080009BC, 0x000009BD, 0x080009C1, 0x000009C5, 0x080009CD, 0x000009CE, 0x080009E2, 0x000009E4,
+	0x050009F2, 0x000009F4, 0x050009FB, 0x000009FC, 0x080009FE, 0x000009FF, 0x08000A01, 0x00000A03,
+	0x08000A3C, 0x00000A3D, 0x08000A41, 0x00000A43, 0x08000A47, 0x00000A49, 0x08000A4B, 0x00000A4E,
+	0x08000A51, 0x00000A52, 0x08000A70, 0x00000A72, 0x08000A75, 0x00000A76, 0x08000A81, 0x00000A83,
+	0x08000ABC, 0x00000ABD, 0x08000AC1, 0x00000AC6, 0x08000AC7, 0x00000AC9, 0x08000ACD, 0x00000ACE,
+	0x08000AE2, 0x00000AE4, 0x05000AF1, 0x00000AF2, 0x08000AFA, 0x00000B00, 0x08000B01, 0x00000B02,
+	0x08000B3C, 0x00000B3D, 0x08000B3F, 0x00000B40, 0x08000B41, 0x00000B45, 0x08000B4D, 0x00000B4E,
+	0x08000B55, 0x00000B57, 0x08000B62, 0x00000B64, 0x08000B82, 0x00000B83, 0x08000BC0, 0x00000BC1,
+	0x08000BCD, 0x00000BCE, 0x0D000BF3, 0x05000BF9, 0x0D000BFA, 0x00000BFB, 0x08000C00, 0x00000C01,
+	0x08000C04, 0x00000C05, 0x08000C3C, 0x00000C3D, 0x08000C3E, 0x00000C41, 0x08000C46, 0x00000C49,
+	0x08000C4A, 0x00000C4E, 0x08000C55, 0x00000C57, 0x08000C62, 0x00000C64, 0x0D000C78, 0x00000C7F,
+	0x08000C81, 0x00000C82, 0x08000CBC, 0x00000CBD, 0x08000CCC, 0x00000CCE, 0x08000CE2, 0x00000CE4,
+	0x08000D00, 0x00000D02, 0x08000D3B, 0x00000D3D, 0x08000D41, 0x00000D45, 0x08000D4D, 0x00000D4E,
+	0x08000D62, 0x00000D64, 0x08000D81, 0x00000D82, 0x08000DCA, 0x00000DCB, 0x08000DD2, 0x00000DD5,
+	0x08000DD6, 0x00000DD7, 0x08000E31, 0x00000E32, 0x08000E34, 0x00000E3B, 0x05000E3F, 0x00000E40,
+	0x08000E47, 0x00000E4F, 0x08000EB1, 0x00000EB2, 0x08000EB4, 0x00000EBD, 0x08000EC8, 0x00000ECE,
+	0x08000F18, 0x00000F1A, 0x08000F35, 0x00000F36, 0x08000F37, 0x00000F38, 0x08000F39, 0x0D000F3A,
+	0x00000F3E, 0x08000F71, 0x00000F7F, 0x08000F80, 0x00000F85, 0x08000F86, 0x00000F88, 0x08000F8D,
+	0x00000F98, 0x08000F99, 0x00000FBD, 0x08000FC6, 0x00000FC7, 0x0800102D, 0x00001031, 0x08001032,
+	0x00001038, 0x08001039, 0x0000103B, 0x0800103D, 0x0000103F, 0x08001058, 0x0000105A, 0x0800105E,
+	0x00001061, 0x08001071, 0x00001075, 0x08001082, 0x00001083, 0x08001085, 0x00001087, 0x0800108D,
+	0x0000108E, 0x0800109D, 0x0000109E, 0x0800135D, 0x00001360, 0x0D001390, 0x0000139A, 0x0D001400,
+	0x00001401, 0x0C001680, 0x00001681, 0x0D00169B, 0x0000169D, 0x08001712, 0x00001715, 0x08001732,
+	0x00001734, 0x08001752, 0x00001754, 0x08001772, 0x00001774, 0x080017B4, 0x000017B6, 0x080017B7,
+	0x000017BE, 0x080017C6, 0x000017C7, 0x080017C9, 0x000017D4, 0x050017DB, 0x000017DC, 0x080017DD,
+	0x000017DE, 0x0D0017F0, 0x000017FA, 0x0D001800, 0x0800180B, 0x0900180E, 0x0800180F, 0x00001810,
+	0x08001885, 0x00001887, 0x080018A9, 0x000018AA, 0x08001920, 0x00001923, 0x08001927, 0x00001929,
+	0x08001932, 0x00001933, 0x08001939, 0x0000193C, 0x0D001940, 0x00001941, 0x0D001944, 0x00001946,
+	0x0D0019DE, 0x00001A00, 0x08001A17, 0x00001A19, 0x08001A1B, 0x00001A1C, 0x08001A56, 0x00001A57,
+	0x08001A58, 0x00001A5F, 0x08001A60, 0x00001A61, 0x08001A62, 0x00001A63, 0x08001A65, 0x00001A6D,
+	0x08001A73, 0x00001A7D, 0x08001A7F, 0x00001A80, 0x08001AB0, 0x00001ACF, 0x08001B00, 0x00001B04,
+	0x08001B34, 0x00001B35, 0x08001B36, 0x00001B3B, 0x08001B3C, 0x00001B3D, 0x08001B42, 0x00001B43,
+	0x08001B6B, 0x00001B74, 0x08001B80, 0x00001B82, 0x08001BA2, 0x00001BA6, 0x08001BA8, 0x00001BAA,
+	0x08001BAB, 0x00001BAE, 0x08001BE6, 0x00001BE7, 0x08001BE8, 0x00001BEA, 0x08001BED, 0x00001BEE,
+	0x08001BEF, 0x00001BF2, 0x08001C2C, 0x00001C34, 0x08001C36, 0x00001C38, 0x08001CD0, 0x00001CD3,
+	0x08001CD4, 0x00001CE1, 0x08001CE2, 0x00001CE9, 0x08001CED, 0x00001CEE, 0x08001CF4, 0x00001CF5,
+	0x08001CF8, 0x00001CFA, 0x08001DC0, 0x00001E00, 0x0D001FBD, 0x00001FBE, 0x0D001FBF, 0x00001FC2,
+	0x0D001FCD, 0x00001FD0, 0x0D001FDD, 0x00001FE0, 0x0D001FED, 0x00001FF0, 0x0D001FFD, 0x00001FFF,
+	0x0C002000, 0x0900200B, 0x0000200E, 0x0100200F, 0x0D002010, 0x0C002028, 0x0A002029, 0x0E00202A,
+	0x1000202B, 0x1200202C, 0x0F00202D, 0x1100202E, 0x0700202F, 0x05002030, 0x0D002035, 0x07002044,
+	0x0D002045, 0x0C00205F, 0x09002060, 0x00002065, 0x13002066, 0x14002067, 0x15002068, 0x16002069,
+	0x0900206A, 0x03002070, 0x00002071, 0x03002074, 0x0400207A, 0x0D00207C, 0x0000207F, 0x03002080,
+	0x0400208A, 0x0D00208C, 0x0000208F, 0x050020A0, 0x080020D0, 0x000020F1, 0x0D002100, 0x00002102,
+	0x0D002103, 0x00002107, 0x0D002108, 0x0000210A, 0x0D002114, 0x00002115, 0x0D002116, 0x00002119,
+	0x0D00211E, 0x00002124, 0x0D002125, 0x00002126, 0x0D002127, 0x00002128, 0x0D002129, 0x0000212A,
+	0x0500212E, 0x0000212F, 0x0D00213A, 0x0000213C, 0x0D002140, 0x00002145, 0x0D00214A, 0x0000214E,
+	0x0D002150, 0x00002160, 0x0D002189, 0x0000218C, 0x0D002190, 0x04002212, 0x05002213, 0x0D002214,
+	0x00002336, 0x0D00237B, 0x00002395, 0x0D002396, 0x00002427, 0x0D002440, 0x0000244B, 0x0D002460,
+	0x03002488, 0x0000249C, 0x0D0024EA, 0x000026AC, 0x0D0026AD, 0x00002800, 0x0D002900, 0x00002B74,
+	0x0D002B76, 0x00002B96, 0x0D002B97, 0x00002C00, 0x0D002CE5, 0x00002CEB, 0x08002CEF, 0x00002CF2,
+	0x0D002CF9, 0x00002D00, 0x08002D7F, 0x00002D80, 0x08002DE0, 0x0D002E00, 0x00002E5E, 0x0D002E80,
+	0x00002E9A, 0x0D002E9B, 0x00002EF4, 0x0D002F00, 0x00002FD6, 0x0D002FF0, 0x00002FFC, 0x0C003000,
+	0x0D003001, 0x00003005, 0x0D003008, 0x00003021, 0x0800302A, 0x0000302E, 0x0D003030, 0x00003031,
+	0x0D003036, 0x00003038, 0x0D00303D, 0x00003040, 0x08003099, 0x0D00309B, 0x0000309D, 0x0D0030A0,
+	0x000030A1, 0x0D0030FB, 0x000030FC, 0x0D0031C0, 0x000031E4, 0x0D00321D, 0x0000321F, 0x0D003250,
+	0x00003260, 0x0D00327C, 0x0000327F, 0x0D0032B1, 0x000032C0, 0x0D0032CC, 0x000032D0, 0x0D003377,
+	0x0000337B, 0x0D0033DE, 0x000033E0, 0x0D0033FF, 0x00003400, 0x0D004DC0, 0x00004E00, 0x0D00A490,
+	0x0000A4C7, 0x0D00A60D, 0x0000A610, 0x0800A66F, 0x0D00A673, 0x0800A674, 0x0D00A67E, 0x0000A680,
+	0x0800A69E, 0x0000A6A0, 0x0800A6F0, 0x0000A6F2, 0x0D00A700, 0x0000A722, 0x0D00A788, 0x0000A789,
+	0x0800A802, 0x0000A803, 0x0800A806, 0x0000A807, 0x0800A80B, 0x0000A80C, 0x0800A825, 0x0000A827,
+	0x0D00A828, 0x0800A82C, 0x0000A82D, 0x0500A838, 0x0000A83A, 0x0D00A874, 0x0000A878, 0x0800A8C4,
+	0x0000A8C6, 0x0800A8E0, 0x0000A8F2, 0x0800A8FF, 0x0000A900, 0x0800A926, 0x0000A92E, 0x0800A947,
+	0x0000A952, 0x0800A980, 0x0000A983, 0x0800A9B3, 0x0000A9B4, 0x0800A9B6, 0x0000A9BA, 0x0800A9BC,
+	0x0000A9BE, 0x0800A9E5, 0x0000A9E6, 0x0800AA29, 0x0000AA2F, 0x0800AA31, 0x0000AA33, 0x0800AA35,
+	0x0000AA37, 0x0800AA43, 0x0000AA44, 0x0800AA4C, 0x0000AA4D, 0x0800AA7C, 0x0000AA7D, 0x0800AAB0,
+	0x0000AAB1, 0x0800AAB2, 0x0000AAB5, 0x0800AAB7, 0x0000AAB9, 0x0800AABE, 0x0000AAC0, 0x0800AAC1,
+	0x0000AAC2, 0x0800AAEC, 0x0000AAEE, 0x0800AAF6, 0x0000AAF7, 0x0D00AB6A, 0x0000AB6C, 0x0800ABE5,
+	0x0000ABE6, 0x0800ABE8, 0x0000ABE9, 0x0800ABED, 0x0000ABEE, 0x0100FB1D, 0x0800FB1E, 0x0100FB1F,
+	0x0400FB29, 0x0100FB2A, 0x0200FB50, 0x0D00FD3E, 0x0200FD50, 0x0D00FDCF, 0x0900FDD0, 0x0200FDF0,
+	0x0D00FDFD, 0x0800FE00, 0x0D00FE10, 0x0000FE1A, 0x0800FE20, 0x0D00FE30, 0x0700FE50, 0x0D00FE51,
+	0x0700FE52, 0x0000FE53, 0x0D00FE54, 0x0700FE55, 0x0D00FE56, 0x0500FE5F, 0x0D00FE60, 0x0400FE62,
+	0x0D00FE64, 0x0000FE67, 0x0D00FE68, 0x0500FE69, 0x0D00FE6B, 0x0000FE6C, 0x0200FE70, 0x0900FEFF,
+	0x0000FF00, 0x0D00FF01, 0x0500FF03, 0x0D00FF06, 0x0400FF0B, 0x0700FF0C, 0x0400FF0D, 0x0700FF0E,
+	0x0300FF10, 0x0700FF1A, 0x0D00FF1B, 0x0000FF21, 0x0D00FF3B, 0x0000FF41, 0x0D00FF5B, 0x0000FF66,
+	0x0500FFE0, 0x0D00FFE2, 0x0500FFE5, 0x0000FFE7, 0x0D00FFE8, 0x0000FFEF, 0x0D00FFF9, 0x0900FFFE,
+	0x00010000, 0x0D010101, 0x00010102, 0x0D010140, 0x0001018D, 0x0D010190, 0x0001019D, 0x0D0101A0,
+	0x000101A1, 0x080101FD, 0x000101FE, 0x080102E0, 0x030102E1, 0x000102FC, 0x08010376, 0x0001037B,
+	0x01010800, 0x0D01091F, 0x01010920, 0x08010A01, 0x01010A04, 0x08010A05, 0x01010A07, 0x08010A0C,
+	0x01010A10, 0x08010A38, 0x01010A3B, 0x08010A3F, 0x01010A40, 0x08010AE5, 0x01010AE7, 0x0D010B39,
+	0x01010B40, 0x02010D00, 0x08010D24, 0x02010D28, 0x06010D30, 0x02010D3A, 0x01010D40, 0x06010E60,
+	0x01010E7F, 0x08010EAB, 0x01010EAD, 0x02010EC0, 0x01010F00, 0x02010F30, 0x08010F46, 0x02010F51,
+	0x01010F70, 0x08010F82, 0x01010F86, 0x00011000, 0x08011001, 0x00011002, 0x08011038, 0x00011047,
+	0x0D011052, 0x00011066, 0x08011070, 0x00011071, 0x08011073, 0x00011075, 0x0801107F, 0x00011082,
+	0x080110B3, 0x000110B7, 0x080110B9, 0x000110BB, 0x080110C2, 0x000110C3, 0x08011100, 0x00011103,
+	0x08011127, 0x0001112C, 0x0801112D, 0x00011135, 0x08011173, 0x00011174, 0x08011180, 0x00011182,
+	0x080111B6, 0x000111BF, 0x080111C9, 0x000111CD, 0x080111CF, 0x000111D0, 0x0801122F, 0x00011232,
+	0x08011234, 0x00011235, 0x08011236, 0x00011238, 0x0801123E, 0x0001123F, 0x080112DF, 0x000112E0,
+	0x080112E3, 0x000112EB, 0x08011300, 0x00011302, 0x0801133B, 0x0001133D, 0x08011340, 0x00011341,
+	0x08011366, 0x0001136D, 0x08011370, 0x00011375, 0x08011438, 0x00011440, 0x08011442, 0x00011445,
+	0x08011446, 0x00011447, 0x0801145E, 0x0001145F, 0x080114B3, 0x000114B9, 0x080114BA, 0x000114BB,
+	0x080114BF, 0x000114C1, 0x080114C2, 0x000114C4, 0x080115B2, 0x000115B6, 0x080115BC, 0x000115BE,
+	0x080115BF, 0x000115C1, 0x080115DC, 0x000115DE, 0x08011633, 0x0001163B, 0x0801163D, 0x0001163E,
+	0x0801163F, 0x00011641, 0x0D011660, 0x0001166D, 0x080116AB, 0x000116AC, 0x080116AD, 0x000116AE,
+	0x080116B0, 0x000116B6, 0x080116B7, 0x000116B8, 0x0801171D, 0x00011720, 0x08011722, 0x00011726,
+	0x08011727, 0x0001172C, 0x0801182F, 0x00011838, 0x08011839, 0x0001183B, 0x0801193B, 0x0001193D,
+	0x0801193E, 0x0001193F, 0x08011943, 0x00011944, 0x080119D4, 0x000119D8, 0x080119DA, 0x000119DC,
+	0x080119E0, 0x000119E1, 0x08011A01, 0x00011A07, 0x08011A09, 0x00011A0B, 0x08011A33, 0x00011A39,
+	0x08011A3B, 0x00011A3F, 0x08011A47, 0x00011A48, 0x08011A51, 0x00011A57, 0x08011A59, 0x00011A5C,
+	0x08011A8A, 0x00011A97, 0x08011A98, 0x00011A9A, 0x08011C30, 0x00011C37, 0x08011C38, 0x00011C3E,
+	0x08011C92, 0x00011CA8, 0x08011CAA, 0x00011CB1, 0x08011CB2, 0x00011CB4, 0x08011CB5, 0x00011CB7,
+	0x08011D31, 0x00011D37, 0x08011D3A, 0x00011D3B, 0x08011D3C, 0x00011D3E, 0x08011D3F, 0x00011D46,
+	0x08011D47, 0x00011D48, 0x08011D90, 0x00011D92, 0x08011D95, 0x00011D96, 0x08011D97, 0x00011D98,
+	0x08011EF3, 0x00011EF5, 0x0D011FD5, 0x05011FDD, 0x0D011FE1, 0x00011FF2, 0x08016AF0, 0x00016AF5,
+	0x08016B30, 0x00016B37, 0x08016F4F, 0x00016F50, 0x08016F8F, 0x00016F93, 0x0D016FE2, 0x00016FE3,
+	0x08016FE4, 0x00016FE5, 0x0801BC9D, 0x0001BC9F, 0x0901BCA0, 0x0001BCA4, 0x0801CF00, 0x0001CF2E,
+	0x0801CF30, 0x0001CF47, 0x0801D167, 0x0001D16A, 0x0901D173, 0x0801D17B, 0x0001D183, 0x0801D185,
+	0x0001D18C, 0x0801D1AA, 0x0001D1AE, 0x0D01D1E9, 0x0001D1EB, 0x0D01D200, 0x0801D242, 0x0D01D245,
+	0x0001D246, 0x0D01D300, 0x0001D357, 0x0D01D6DB, 0x0001D6DC, 0x0D01D715, 0x0001D716, 0x0D01D74F,
+	0x0001D750, 0x0D01D789, 0x0001D78A, 0x0D01D7C3, 0x0001D7C4, 0x0301D7CE, 0x0001D800, 0x0801DA00,
+	0x0001DA37, 0x0801DA3B, 0x0001DA6D, 0x0801DA75, 0x0001DA76, 0x0801DA84, 0x0001DA85, 0x0801DA9B,
+	0x0001DAA0, 0x0801DAA1, 0x0001DAB0, 0x0801E000, 0x0001E007, 0x0801E008, 0x0001E019, 0x0801E01B,
+	0x0001E022, 0x0801E023, 0x0001E025, 0x0801E026, 0x0001E02B, 0x0801E130, 0x0001E137, 0x0801E2AE,
+	0x0001E2AF, 0x0801E2EC, 0x0001E2F0, 0x0501E2FF, 0x0001E300, 0x0101E800, 0x0801E8D0, 0x0101E8D7,
+	0x0801E944, 0x0101E94B, 0x0201EC70, 0x0101ECC0, 0x0201ED00, 0x0101ED50, 0x0201EE00, 0x0D01EEF0,
+	0x0201EEF2, 0x0101EF00, 0x0D01F000, 0x0001F02C, 0x0D01F030, 0x0001F094, 0x0D01F0A0, 0x0001F0AF,
+	0x0D01F0B1, 0x0001F0C0, 0x0D01F0C1, 0x0001F0D0, 0x0D01F0D1, 0x0001F0F6, 0x0301F100, 0x0D01F10B,
+	0x0001F110, 0x0D01F12F, 0x0001F130, 0x0D01F16A, 0x0001F170, 0x0D01F1AD, 0x0001F1AE, 0x0D01F260,
+	0x0001F266, 0x0D01F300, 0x0001F6D8, 0x0D01F6DD, 0x0001F6ED, 0x0D01F6F0, 0x0001F6FD, 0x0D01F700,
+	0x0001F774, 0x0D01F780, 0x0001F7D9, 0x0D01F7E0, 0x0001F7EC, 0x0D01F7F0, 0x0001F7F1, 0x0D01F800,
+	0x0001F80C, 0x0D01F810, 0x0001F848, 0x0D01F850, 0x0001F85A, 0x0D01F860, 0x0001F888, 0x0D01F890,
+	0x0001F8AE, 0x0D01F8B0, 0x0001F8B2, 0x0D01F900, 0x0001FA54, 0x0D01FA60, 0x0001FA6E, 0x0D01FA70,
+	0x0001FA75, 0x0D01FA78, 0x0001FA7D, 0x0D01FA80, 0x0001FA87, 0x0D01FA90, 0x0001FAAD, 0x0D01FAB0,
+	0x0001FABB, 0x0D01FAC0, 0x0001FAC6, 0x0D01FAD0, 0x0001FADA, 0x0D01FAE0, 0x0001FAE8, 0x0D01FAF0,
+	0x0001FAF7, 0x0D01FB00, 0x0001FB93, 0x0D01FB94, 0x0001FBCB, 0x0301FBF0, 0x0001FBFA, 0x0901FFFE,
+	0x00020000, 0x0902FFFE, 0x00030000, 0x0903FFFE, 0x00040000, 0x0904FFFE, 0x00050000, 0x0905FFFE,
+	0x00060000, 0x0906FFFE, 0x00070000, 0x0907FFFE, 0x00080000, 0x0908FFFE, 0x00090000, 0x0909FFFE,
+	0x000A0000, 0x090AFFFE, 0x000B0000, 0x090BFFFE, 0x000C0000, 0x090CFFFE, 0x000D0000, 0x090DFFFE,
+	0x000E0000, 0x090E0001, 0x000E0002, 0x090E0020, 0x000E0080, 0x080E0100, 0x000E01F0, 0x090EFFFE,
+	0x000F0000, 0x090FFFFE, 0x00100000, 0x0910FFFE
+};
+
+static constexpr uint8_t BIDI_CLASS_LATIN1[256] = {
+	9, 9, 9, 9, 9, 9, 9, 9, 9, 11, 10, 11, 12, 10, 9, 9,
+	9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 10, 11,
+	12, 13, 13, 5, 5, 5, 13, 13, 13, 13, 13, 4, 7, 4, 7, 7,
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 7, 13, 13, 13, 13, 13,
+	13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 13, 13, 13, 13,
+	13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 13, 13, 13, 9,
+	9, 9, 9, 9, 9, 10, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+	9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+	7, 13, 5, 5, 5, 5, 13, 13, 13, 13, 0, 13, 13, 9, 13, 13,
+	5, 5, 3, 3, 13, 0, 13, 13, 13, 3, 0, 13, 13, 13, 13, 13,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static constexpr ArabicForms ARABIC_FORMS[] = {
+	{ 0x0621, 0xFE80, 0, 0, 0 },
+	{ 0x0622, 0xFE81, 0xFE82, 0, 0 },
+	{ 0x0623, 0xFE83, 0xFE84, 0, 0 },
+	{ 0x0624, 0xFE85, 0xFE86, 0, 0 },
+	{ 0x0625, 0xFE87, 0xFE88, 0, 0 },
+	{ 0x0626, 0xFE89, 0xFE8A, 0xFE8B, 0xFE8C },
+	{ 0x0627, 0xFE8D, 0xFE8E, 0, 0 },
+	{ 0x0628, 0xFE8F, 0xFE90, 0xFE91, 0xFE92 },
+	{ 0x0629, 0xFE93, 0xFE94, 0, 0 },
+	{ 0x062A, 0xFE95, 0xFE96, 0xFE97, 0xFE98 },
+	{ 0x062B, 0xFE99, 0xFE9A, 0xFE9B, 0xFE9C },
+	{ 0x062C, 0xFE9D, 0xFE9E, 0xFE9F, 0xFEA0 },
+	{ 0x062D, 0xFEA1, 0xFEA2, 0xFEA3, 0xFEA4 },
+	{ 0x062E, 0xFEA5, 0xFEA6, 0xFEA7, 0xFEA8 },
+	{ 0x062F, 0xFEA9, 0xFEAA, 0, 0 },
+	{ 0x0630, 0xFEAB, 0xFEAC, 0, 0 },
+	{ 0x0631, 0xFEAD, 0xFEAE, 0, 0 },
+	{ 0x0632, 0xFEAF, 0xFEB0, 0, 0 },
+	{ 0x0633, 0xFEB1, 0xFEB2, 0xFEB3, 0xFEB4 },
+	{ 0x0634, 0xFEB5, 0xFEB6, 0xFEB7, 0xFEB8 },
+	{ 0x0635, 0xFEB9, 0xFEBA, 0xFEBB, 0xFEBC },
+	{ 0x0636, 0xFEBD, 0xFEBE, 0xFEBF, 0xFEC0 },
+	{ 0x0637, 0xFEC1, 0xFEC2, 0xFEC3, 0xFEC4 },
+	{ 0x0638, 0xFEC5, 0xFEC6, 0xFEC7, 0xFEC8 },
+	{ 0x0639, 0xFEC9, 0xFECA, 0xFECB, 0xFECC },
+	{ 0x063A, 0xFECD, 0xFECE, 0xFECF, 0xFED0 },
+	{ 0x0641, 0xFED1, 0xFED2, 0xFED3, 0xFED4 },
+	{ 0x0642, 0xFED5, 0xFED6, 0xFED7, 0xFED8 },
+	{ 0x0643, 0xFED9, 0xFEDA, 0xFEDB, 0xFEDC },
+	{ 0x0644, 0xFEDD, 0xFEDE, 0xFEDF, 0xFEE0 },
+	{ 0x0645, 0xFEE1, 0xFEE2, 0xFEE3, 0xFEE4 },
+	{ 0x0646, 0xFEE5, 0xFEE6, 0xFEE7, 0xFEE8 },
+	{ 0x0647, 0xFEE9, 0xFEEA, 0xFEEB, 0xFEEC },
+	{ 0x0648, 0xFEED, 0xFEEE, 0, 0 },
+	{ 0x0649, 0xFEEF, 0xFEF0, 0xFBE8, 0xFBE9 },
+	{ 0x064A, 0xFEF1, 0xFEF2, 0xFEF3, 0xFEF4 },
+	{ 0x0671, 0xFB50, 0xFB51, 0, 0 },
+	{ 0x0677, 0xFBDD, 0, 0, 0 },
+	{ 0x0679, 0xFB66, 0xFB67, 0xFB68, 0xFB69 },
+	{ 0x067A, 0xFB5E, 0xFB5F, 0xFB60, 0xFB61 },
+	{ 0x067B, 0xFB52, 0xFB53, 0xFB54, 0xFB55 },
+	{ 0x067E, 0xFB56, 0xFB57, 0xFB58, 0xFB59 },
+	{ 0x067F, 0xFB62, 0xFB63, 0xFB64, 0xFB65 },
+	{ 0x0680, 0xFB5A, 0xFB5B, 0xFB5C, 0xFB5D },
+	{ 0x0683, 0xFB76, 0xFB77, 0xFB78, 0xFB79 },
+	{ 0x0684, 0xFB72, 0xFB73, 0xFB74, 0xFB75 },
+	{ 0x0686, 0xFB7A, 0xFB7B, 0xFB7C, 0xFB7D },
+	{ 0x0687, 0xFB7E, 0xFB7F, 0xFB80, 0xFB81 },
+	{ 0x0688, 0xFB88, 0xFB89, 0, 0 },
+	{ 0x068C, 0xFB84, 0xFB85, 0, 0 },
+	{ 0x068D, 0xFB82, 0xFB83, 0, 0 },
+	{ 0x068E, 0xFB86, 0xFB87, 0, 0 },
+	{ 0x0691, 0xFB8C, 0xFB8D, 0, 0 },
+	{ 0x0698, 0xFB8A, 0xFB8B, 0, 0 },
+	{ 0x06A4, 0xFB6A, 0xFB6B, 0xFB6C, 0xFB6D },
+	{ 0x06A6, 0xFB6E, 0xFB6F, 0xFB70, 0xFB71 },
+	{ 0x06A9, 0xFB8E, 0xFB8F, 0xFB90, 0xFB91 },
+	{ 0x06AD, 0xFBD3, 0xFBD4, 0xFBD5, 0xFBD6 },
+	{ 0x06AF, 0xFB92, 0xFB93, 0xFB94, 0xFB95 },
+	{ 0x06B1, 0xFB9A, 0xFB9B, 0xFB9C, 0xFB9D },
+	{ 0x06B3, 0xFB96, 0xFB97, 0xFB98, 0xFB99 },
+	{ 0x06BA, 0xFB9E, 0xFB9F, 0, 0 },
+	{ 0x06BB, 0xFBA0, 0xFBA1, 0xFBA2, 0xFBA3 },
+	{ 0x06BE, 0xFBAA, 0xFBAB, 0xFBAC, 0xFBAD },
+	{ 0x06C0, 0xFBA4, 0xFBA5, 0, 0 },
+	{ 0x06C1, 0xFBA6, 0xFBA7, 0xFBA8, 0xFBA9 },
+	{ 0x06C5, 0xFBE0, 0xFBE1, 0, 0 },
+	{ 0x06C6, 0xFBD9, 0xFBDA, 0, 0 },
+	{ 0x06C7, 0xFBD7, 0xFBD8, 0, 0 },
+	{ 0x06C8, 0xFBDB, 0xFBDC, 0, 0 },
+	{ 0x06C9, 0xFBE2, 0xFBE3, 0, 0 },
+	{ 0x06CB, 0xFBDE, 0xFBDF, 0, 0 },
+	{ 0x06CC, 0xFBFC, 0xFBFD, 0xFBFE, 0xFBFF },
+	{ 0x06D0, 0xFBE4, 0xFBE5, 0xFBE6, 0xFBE7 },
+	{ 0x06D2, 0xFBAE, 0xFBAF, 0, 0 },
+	{ 0x06D3, 0xFBB0, 0xFBB1, 0, 0 }
+};
+
+static constexpr LamAlef LAM_ALEF_FORMS[] = {
+	{ 0x0622, 0xFEF5, 0xFEF6 },
+	{ 0x0623, 0xFEF7, 0xFEF8 },
+	{ 0x0625, 0xFEF9, 0xFEFA },
+	{ 0x0627, 0xFEFB, 0xFEFC }
+};
+
+static constexpr CodePair BRACKET_PAIRS[] = {
+	{ 0x0028, 0x0029 }, { 0x005B, 0x005D }, { 0x007B, 0x007D }, { 0x2045, 0x2046 },
+	{ 0x207D, 0x207E }, { 0x208D, 0x208E }, { 0x2308, 0x2309 }, { 0x230A, 0x230B },
+	{ 0x2329, 0x232A }, { 0x2768, 0x2769 }, { 0x276A, 0x276B }, { 0x276C, 0x276D },
+	{ 0x276E, 0x276F }, { 0x2770, 0x2771 }, { 0x2772, 0x2773 }, { 0x2774, 0x2775 },
+	{ 0x27C5, 0x27C6 }, { 0x27E6, 0x27E7 }, { 0x27E8, 0x27E9 }, { 0x27EA, 0x27EB },
+	{ 0x27EC, 0x27ED }, { 0x27EE, 0x27EF }, { 0x2983, 0x2984 }, { 0x2985, 0x2986 },
+	{ 0x2987, 0x2988 }, { 0x2989, 0x298A }, { 0x298B, 0x298C }, { 0x298D, 0x2990 },
+	{ 0x298F, 0x298E }, { 0x2991, 0x2992 }, { 0x2997, 0x2998 }, { 0x29D8, 0x29D9 },
+	{ 0x29DA, 0x29DB }, { 0x29FC, 0x29FD }, { 0x2E22, 0x2E23 }, { 0x2E24, 0x2E25 },
+	{ 0x2E26, 0x2E27 }, { 0x2E28, 0x2E29 }, { 0x2E55, 0x2E56 }, { 0x2E57, 0x2E58 },
+	{ 0x2E59, 0x2E5A }, { 0x2E5B, 0x2E5C }, { 0x3008, 0x3009 }, { 0x300A, 0x300B },
+	{ 0x300C, 0x300D }, { 0x300E, 0x300F }, { 0x3010, 0x3011 }, { 0x3014, 0x3015 },
+	{ 0x3016, 0x3017 }, { 0x3018, 0x3019 }, { 0x301A, 0x301B }, { 0xFE59, 0xFE5A },
+	{ 0xFE5B, 0xFE5C }, { 0xFE5D, 0xFE5E }, { 0xFF08, 0xFF09 }, { 0xFF3B, 0xFF3D },
+	{ 0xFF5B, 0xFF5D }, { 0xFF5F, 0xFF60 }, { 0xFF62, 0xFF63 }
+};
+
+static constexpr CodePair MIRROR_PAIRS[] = {
+	{ 0x0028, 0x0029 }, { 0x0029, 0x0028 }, { 0x003C, 0x003E }, { 0x003E, 0x003C },
+	{ 0x005B, 0x005D }, { 0x005D, 0x005B }, { 0x007B, 0x007D }, { 0x007D, 0x007B },
+	{ 0x00AB, 0x00BB }, { 0x00BB, 0x00AB }, { 0x2039, 0x203A }, { 0x203A, 0x2039 },
+	{ 0x2045, 0x2046 }, { 0x2046, 0x2045 }, { 0x207D, 0x207E }, { 0x207E, 0x207D },
+	{ 0x208D, 0x208E }, { 0x208E, 0x208D }, { 0x2264, 0x2265 }, { 0x2265, 0x2264 },
+	{ 0x2266, 0x2267 }, { 0x2267, 0x2266 }, { 0x2268, 0x2269 }, { 0x2269, 0x2268 },
+	{ 0x226A, 0x226B }, { 0x226B, 0x226A }, { 0x226E, 0x226F }, { 0x226F, 0x226E },
+	{ 0x2270, 0x2271 }, { 0x2271, 0x2270 }, { 0x2272, 0x2273 }, { 0x2273, 0x2272 },
+	{ 0x2274, 0x2275 }, { 0x2275, 0x2274 }, { 0x22A2, 0x22A3 }, { 0x22A3, 0x22A2 },
+	{ 0x22AB, 0x2AE5 }, { 0x22C9, 0x22CA }, { 0x22CA, 0x22C9 }, { 0x22CB, 0x22CC },
+	{ 0x22CC, 0x22CB }, { 0x22D6, 0x22D7 }, { 0x22D7, 0x22D6 }, { 0x22D8, 0x22D9 },
+	{ 0x22D9, 0x22D8 }, { 0x22DC, 0x22DD }, { 0x22DD, 0x22DC }, { 0x22E6, 0x22E7 },
+	{ 0x22E7, 0x22E6 }, { 0x2308, 0x2309 }, { 0x2309, 0x2308 }, { 0x230A, 0x230B },
+	{ 0x230B, 0x230A }, { 0x2329, 0x232A }, { 0x232A, 0x2329 }, { 0x2768, 0x2769 },
+	{ 0x2769, 0x2768 }, { 0x276A, 0x276B }, { 0x276B, 0x276A }, { 0x276C, 0x276D },
+	{ 0x276D, 0x276C }, { 0x276E, 0x276F }, { 0x276F, 0x276E }, { 0x2770, 0x2771 },
+	{ 0x2771, 0x2770 }, { 0x2772, 0x2773 }, { 0x2773, 0x2772 }, { 0x2774, 0x2775 },
+	{ 0x2775, 0x2774 }, { 0x27C5, 0x27C6 }, { 0x27C6, 0x27C5 }, { 0x27D5, 0x27D6 },
+	{ 0x27D6, 0x27D5 }, { 0x27DD, 0x27DE }, { 0x27DE, 0x27DD }, { 0x27E2, 0x27E3 },
+	{ 0x27E3, 0x27E2 }, { 0x27E4, 0x27E5 }, { 0x27E5, 0x27E4 }, { 0x27E6, 0x27E7 },
+	{ 0x27E7, 0x27E6 }, { 0x27E8, 0x27E9 }, { 0x27E9, 0x27E8 }, { 0x27EA, 0x27EB },
+	{ 0x27EB, 0x27EA }, { 0x27EC, 0x27ED }, { 0x27ED, 0x27EC }, { 0x27EE, 0x27EF },
+	{ 0x27EF, 0x27EE }, { 0x2983, 0x2984 }, { 0x2984, 0x2983 }, { 0x2985, 0x2986 },
+	{ 0x2986, 0x2985 }, { 0x2987, 0x2988 }, { 0x2988, 0x2987 }, { 0x2989, 0x298A },
+	{ 0x298A, 0x2989 }, { 0x298B, 0x298C }, { 0x298C, 0x298B }, { 0x298D, 0x2990 },
+	{ 0x298E, 0x298F }, { 0x298F, 0x298E }, { 0x2990, 0x298D }, { 0x2991, 0x2992 },
+	{ 0x2992, 0x2991 }, { 0x2997, 0x2998 }, { 0x2998, 0x2997 }, { 0x29A8, 0x29A9 },
+	{ 0x29A9, 0x29A8 }, { 0x29AA, 0x29AB }, { 0x29AB, 0x29AA }, { 0x29AC, 0x29AD },
+	{ 0x29AD, 0x29AC }, { 0x29AE, 0x29AF }, { 0x29AF, 0x29AE }, { 0x29C0, 0x29C1 },
+	{ 0x29C1, 0x29C0 }, { 0x29D1, 0x29D2 }, { 0x29D2, 0x29D1 }, { 0x29D4, 0x29D5 },
+	{ 0x29D5, 0x29D4 }, { 0x29D8, 0x29D9 }, { 0x29D9, 0x29D8 }, { 0x29DA, 0x29DB },
+	{ 0x29DB, 0x29DA }, { 0x29E8, 0x29E9 }, { 0x29E9, 0x29E8 }, { 0x29FC, 0x29FD },
+	{ 0x29FD, 0x29FC }, { 0x2A2D, 0x2A2E }, { 0x2A2E, 0x2A2D }, { 0x2A34, 0x2A35 },
+	{ 0x2A35, 0x2A34 }, { 0x2A79, 0x2A7A }, { 0x2A7A, 0x2A79 }, { 0x2A7B, 0x2A7C },
+	{ 0x2A7C, 0x2A7B }, { 0x2A7D, 0x2A7E }, { 0x2A7E, 0x2A7D }, { 0x2A7F, 0x2A80 },
+	{ 0x2A80, 0x2A7F }, { 0x2A81, 0x2A82 }, { 0x2A82, 0x2A81 }, { 0x2A85, 0x2A86 },
+	{ 0x2A86, 0x2A85 }, { 0x2A87, 0x2A88 }, { 0x2A88, 0x2A87 }, { 0x2A89, 0x2A8A },
+	{ 0x2A8A, 0x2A89 }, { 0x2A8D, 0x2A8E }, { 0x2A8E, 0x2A8D }, { 0x2A95, 0x2A96 },
+	{ 0x2A96, 0x2A95 }, { 0x2A97, 0x2A98 }, { 0x2A98, 0x2A97 }, { 0x2A99, 0x2A9A },
+	{ 0x2A9A, 0x2A99 }, { 0x2A9B, 0x2A9C }, { 0x2A9C, 0x2A9B }, { 0x2A9D, 0x2A9E },
+	{ 0x2A9E, 0x2A9D }, { 0x2A9F, 0x2AA0 }, { 0x2AA0, 0x2A9F }, { 0x2AA1, 0x2AA2 },
+	{ 0x2AA2, 0x2AA1 }, { 0x2AA6, 0x2AA7 }, { 0x2AA7, 0x2AA6 }, { 0x2AA8, 0x2AA9 },
+	{ 0x2AA9, 0x2AA8 }, { 0x2ACD, 0x2ACE }, { 0x2ACE, 0x2ACD }, { 0x2AE5, 0x22AB },
+	{ 0x2AF7, 0x2AF8 }, { 0x2AF8, 0x2AF7 }, { 0x2AF9, 0x2AFA }, { 0x2AFA, 0x2AF9 },
+	{ 0x2E02, 0x2E03 }, { 0x2E03, 0x2E02 }, { 0x2E04, 0x2E05 }, { 0x2E05, 0x2E04 },
+	{ 0x2E09, 0x2E0A }, { 0x2E0A, 0x2E09 }, { 0x2E0C, 0x2E0D }, { 0x2E0D, 0x2E0C },
+	{ 0x2E1C, 0x2E1D }, { 0x2E1D, 0x2E1C }, { 0x2E20, 0x2E21 }, { 0x2E21, 0x2E20 },
+	{ 0x2E22, 0x2E23 }, { 0x2E23, 0x2E22 }, { 0x2E24, 0x2E25 }, { 0x2E25, 0x2E24 },
+	{ 0x2E26, 0x2E27 }, { 0x2E27, 0x2E26 }, { 0x2E28, 0x2E29 }, { 0x2E29, 0x2E28 },
+	{ 0x2E55, 0x2E56 }, { 0x2E56, 0x2E55 }, { 0x2E57, 0x2E58 }, { 0x2E58, 0x2E57 },
+	{ 0x2E59, 0x2E5A }, { 0x2E5A, 0x2E59 }, { 0x2E5B, 0x2E5C }, { 0x2E5C, 0x2E5B },
+	{ 0x3008, 0x3009 }, { 0x3009, 0x3008 }, { 0x300A, 0x300B }, { 0x300B, 0x300A },
+	{ 0x300C, 0x300D }, { 0x300D, 0x300C }, { 0x300E, 0x300F }, { 0x300F, 0x300E },
+	{ 0x3010, 0x3011 }, { 0x3011, 0x3010 }, { 0x3014, 0x3015 }, { 0x3015, 0x3014 },
+	{ 0x3016, 0x3017 }, { 0x3017, 0x3016 }, { 0x3018, 0x3019 }, { 0x3019, 0x3018 },
+	{ 0x301A, 0x301B }, { 0x301B, 0x301A }, { 0xFE59, 0xFE5A }, { 0xFE5A, 0xFE59 },
+	{ 0xFE5B, 0xFE5C }, { 0xFE5C, 0xFE5B }, { 0xFE5D, 0xFE5E }, { 0xFE5E, 0xFE5D },
+	{ 0xFE64, 0xFE65 }, { 0xFE65, 0xFE64 }, { 0xFF08, 0xFF09 }, { 0xFF09, 0xFF08 },
+	{ 0xFF1C, 0xFF1E }, { 0xFF1E, 0xFF1C }, { 0xFF3B, 0xFF3D }, { 0xFF3D, 0xFF3B },
+	{ 0xFF5B, 0xFF5D }, { 0xFF5D, 0xFF5B }, { 0xFF5F, 0xFF60 }, { 0xFF60, 0xFF5F },
+	{ 0xFF62, 0xFF63 }, { 0xFF63, 0xFF62 }
+};
+
+static constexpr size_t BIDI_CLASS_RANGES_COUNT = sizeof(BIDI_CLASS_RANGES) / sizeof(BIDI_CLASS_RANGES[0]);
+static constexpr size_t ARABIC_FORMS_COUNT = sizeof(ARABIC_FORMS) / sizeof(ARABIC_FORMS[0]);
+static constexpr size_t LAM_ALEF_FORMS_COUNT = sizeof(LAM_ALEF_FORMS) / sizeof(LAM_ALEF_FORMS[0]);
+static constexpr size_t BRACKET_PAIRS_COUNT = sizeof(BRACKET_PAIRS) / sizeof(BRACKET_PAIRS[0]);
+static constexpr size_t MIRROR_PAIRS_COUNT = sizeof(MIRROR_PAIRS) / sizeof(MIRROR_PAIRS[0]);
+
+static constexpr char32_t ARABIC_LAM = 0x0644;
+
+//=====================================================================================
+// Table lookups
+//=====================================================================================
+
+/// <summary>
+/// Binary search in table of pairs sorted by the first item
+/// </summary>
+/// <param name="pairs"></param>
+/// <param name="count"></param>
+/// <param name="c"></param>
+/// <returns></returns>
+static const CodePair* FindPair(const CodePair* pairs, size_t count, char32_t c) noexcept
+{
+	size_t l = 0;
+	size_t r = count;
+	while (l < r)
+	{
+		size_t m = (l + r) / 2;
+		if (c < pairs[m].first)
+		{
+			r = m;
+		}
+		else if (c > pairs[m].first)
+		{
+			l = m + 1;
+		}
+		else
+		{
+			return &pairs[m];
+		}
+	}
+
+	return nullptr;
+}
+
+static const ArabicForms* GetArabicForms(char32_t c) noexcept
+{
+	if ((c < ARABIC_FORMS[0].c) || (c > ARABIC_FORMS[ARABIC_FORMS_COUNT - 1].c))
+	{
+		return nullptr;
+	}
+
+	size_t l = 0;
+	size_t r = ARABIC_FORMS_COUNT;
+	while (l < r)
+	{
+		size_t m = (l + r) / 2;
+		if (c < ARABIC_FORMS[m].c)
+		{
+			r = m;
+		}
+		else if (c > ARABIC_FORMS[m].c)
+		{
+			l = m + 1;
+		}
+		else
+		{
+			return &ARABIC_FORMS[m];
+		}
+	}
+
+	return nullptr;
+}
+
+static const LamAlef* GetLamAlef(char32_t alef) noexcept
+{
+	for (size_t i = 0; i < LAM_ALEF_FORMS_COUNT; i++)
+	{
+		if (LAM_ALEF_FORMS[i].alef == alef)
+		{
+			return &LAM_ALEF_FORMS[i];
+		}
+	}
+
+	return nullptr;
+}
+
+/// <summary>
+/// Get joining type of character
+/// Only letters that have presentation forms are joining,
+/// others can not be shaped and are treated as non-joining
+/// </summary>
+/// <param name="c"></param>
+/// <returns></returns>
+static JoiningType GetJoiningType(char32_t c) noexcept
+{
+	//ZWJ and Tatweel
+	if ((c == 0x200D) || (c == 0x0640))
+	{
+		return JoiningType::C;
+	}
+
+	if (const ArabicForms* f = GetArabicForms(c))
+	{
+		if (f->initial != 0)
+		{
+			return JoiningType::D;
+		}
+		return (f->final != 0) ? JoiningType::R : JoiningType::U;
+	}
+
+	//Mn, Me and Cf characters are transparent (except ZWNJ)
+	using BidiClass = BuiltinBidi::BidiClass;
+	BidiClass cls = BuiltinBidi::GetBidiClass(c);
+	if ((cls == BidiClass::NSM) || ((cls >= BidiClass::BN) && (cls != BidiClass::B) &&
+		(cls != BidiClass::S) && (cls != BidiClass::WS) && (cls != BidiClass::ON) && (c != 0x200C)))
+	{
+		return JoiningType::T;
+	}
+
+	return JoiningType::U;
+}
+
+/// <summary>
+/// Get opening bracket of the bracket pair that c belongs to
+/// Returns 0 if c is not a paired bracket
+/// </summary>
+/// <param name="c"></param>
+/// <param name="isOpening"></param>
+/// <returns></returns>
+static char32_t GetOpeningBracket(char32_t c, bool& isOpening) noexcept
+{
+	//canonical equivalents of angle brackets
+	if (c == 0x2329)
+	{
+		c = 0x3008;
+	}
+	else if (c == 0x232A)
+	{
+		c = 0x3009;
+	}
+
+	if (FindPair(BRACKET_PAIRS, BRACKET_PAIRS_COUNT, c) != nullptr)
+	{
+		isOpening = true;
+		return c;
+	}
+
+	char32_t m = BuiltinBidi::GetMirror(c);
+	if (m == c)
+	{
+		return 0;
+	}
+
+	const CodePair* p = FindPair(BRACKET_PAIRS, BRACKET_PAIRS_COUNT, m);
+	if ((p == nullptr) || (p->second != c))
+	{
+		return 0;
+	}
+
+	isOpening = false;
+	return m;
+}
+
+//=====================================================================================
+// BuiltinBidi
+//=====================================================================================
+
+/// <summary>
+/// Get Bidi_Class of code point
+/// Latin-1 is looked up directly, the rest via binary search
+/// </summary>
+/// <param name="c"></param>
+/// <returns></returns>
+BuiltinBidi::BidiClass BuiltinBidi::GetBidiClass(char32_t c) noexcept
+{
+	if (c < 256)
+	{
+		return static_cast<BidiClass>(BIDI_CLASS_LATIN1[c]);
+	}
+
+	if (c > 0x10FFFF)
+	{
+		return BidiClass::L;
+	}
+
+	//find last range that starts before or at c
+	size_t l = 0;
+	size_t r = BIDI_CLASS_RANGES_COUNT;
+	while (r - l > 1)
+	{
+		size_t m = (l + r) / 2;
+		if ((BIDI_CLASS_RANGES[m] & 0x00FFFFFF) <= c)
+		{
+			l = m;
+		}
+		else
+		{
+			r = m;
+		}
+	}
+
+	return static_cast<BidiClass>(BIDI_CLASS_RANGES[l] >> 24);
+}
+
+/// <summary>
+/// Get mirrored glyph (rule L4)
+/// If there is none, c is returned
+/// </summary>
+/// <param name="c"></param>
+/// <returns></returns>
+char32_t BuiltinBidi::GetMirror(char32_t c) noexcept
+{
+	const CodePair* p = FindPair(MIRROR_PAIRS, MIRROR_PAIRS_COUNT, c);
+	return (p != nullptr) ? p->second : c;
+}
+
+bool BuiltinBidi::IsBidiControl(char32_t c, BidiClass cls) noexcept
+{
+	//LRM, RLM, ALM
+	if ((c == 0x200E) || (c == 0x200F) || (c == 0x061C))
+	{
+		return true;
+	}
+	return (cls >= BidiClass::LRE) && (cls <= BidiClass::PDI);
+}
+
+bool BuiltinBidi::IsRemovedByX9(BidiClass cls) noexcept
+{
+	return (cls == BidiClass::BN) || ((cls >= BidiClass::LRE) && (cls <= BidiClass::PDF));
+}
+
+bool BuiltinBidi::IsIsolateInitiator(BidiClass cls) noexcept
+{
+	return (cls == BidiClass::LRI) || (cls == BidiClass::RLI) || (cls == BidiClass::FSI);
+}
+
+bool BuiltinBidi::IsNeutralOrIsolate(BidiClass cls) noexcept
+{
+	switch (cls)
+	{
+	case BidiClass::B:
+	case BidiClass::S:
+	case BidiClass::WS:
+	case BidiClass::ON:
+	case BidiClass::LRI:
+	case BidiClass::RLI:
+	case BidiClass::FSI:
+	case BidiClass::PDI:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/// <summary>
+/// Map resolved type to strong direction
+/// Numbers are treated as R (rules N0, N1)
+/// Returns ON if type is not strong
+/// </summary>
+/// <param name="cls"></param>
+/// <returns></returns>
+BuiltinBidi::BidiClass BuiltinBidi::AsStrong(BidiClass cls) noexcept
+{
+	switch (cls)
+	{
+	case BidiClass::L:
+		return BidiClass::L;
+	case BidiClass::R:
+	case BidiClass::AL:
+	case BidiClass::EN:
+	case BidiClass::AN:
+		return BidiClass::R;
+	default:
+		return BidiClass::ON;
+	}
+}
+
+/// <summary>
+/// Find first strong character in [from, to) - rules P2, P3
+/// Characters between isolate initiator and its matching PDI are skipped
+/// </summary>
+/// <param name="types"></param>
+/// <param name="matching"></param>
+/// <param name="from"></param>
+/// <param name="to"></param>
+/// <returns>0 - L, 1 - R or AL, -1 - no strong character</returns>
+int BuiltinBidi::FindFirstStrong(const BidiClass* types, const int32_t* matching,
+	size_t from, size_t to) noexcept
+{
+	for (size_t i = from; i < to; i++)
+	{
+		BidiClass t = types[i];
+		if (t == BidiClass::L)
+		{
+			return 0;
+		}
+		if ((t == BidiClass::R) || (t == BidiClass::AL))
+		{
+			return 1;
+		}
+		if (IsIsolateInitiator(t))
+		{
+			if (matching[i] < 0)
+			{
+				return -1;
+			}
+			i = static_cast<size_t>(matching[i]);
+		}
+	}
+
+	return -1;
+}
+
+/// <summary>
+/// Shape Arabic string in logical order
+/// Letters are replaced by their presentation forms,
+/// lam + alef is replaced by ligature
+/// </summary>
+/// <param name="str"></param>
+/// <param name="len"></param>
+/// <returns>new length of the string</returns>
+size_t BuiltinBidi::ShapeArabic(char32_t* str, size_t len)
+{
+	ShapeArabicMarked(str, len);
+	return RemoveMarked(str, len);
+}
+
+/// <summary>
+/// Shape Arabic string in logical order
+/// Alef merged to lam-alef ligature is replaced by REMOVED marker,
+/// so string length does not change
+/// </summary>
+/// <param name="str"></param>
+/// <param name="len"></param>
+void BuiltinBidi::ShapeArabicMarked(char32_t* str, size_t len)
+{
+	SmallBuffer<JoiningType, SMALL_STRING_LENGTH> jt(len);
+	for (size_t i = 0; i < len; i++)
+	{
+		jt[i] = (str[i] == REMOVED) ? JoiningType::T : GetJoiningType(str[i]);
+	}
+
+	//previous non-transparent character joins to the following one
+	bool prevJoins = false;
+
+	for (size_t i = 0; i < len; i++)
+	{
+		if (jt[i] == JoiningType::T)
+		{
+			continue;
+		}
+
+		if ((jt[i] != JoiningType::R) && (jt[i] != JoiningType::D))
+		{
+			prevJoins = (jt[i] == JoiningType::C);
+			continue;
+		}
+
+		size_t next = i + 1;
+		while ((next < len) && (jt[next] == JoiningType::T))
+		{
+			next++;
+		}
+
+		bool nextJoins = (next < len) &&
+			((jt[next] == JoiningType::R) || (jt[next] == JoiningType::D) || (jt[next] == JoiningType::C));
+
+		if ((str[i] == ARABIC_LAM) && (next == i + 1) && (next < len))
+		{
+			if (const LamAlef* la = GetLamAlef(str[next]))
+			{
+				str[i] = (prevJoins) ? la->final : la->isolated;
+				str[next] = REMOVED;
+
+				//ligature is right-joining
+				prevJoins = false;
+				i = next;
+				continue;
+			}
+		}
+
+		const ArabicForms* f = GetArabicForms(str[i]);
+
+		char16_t form = f->isolated;
+		if (jt[i] == JoiningType::D)
+		{
+			if (prevJoins)
+			{
+				form = (nextJoins) ? f->medial : f->final;
+			}
+			else if (nextJoins)
+			{
+				form = f->initial;
+			}
+		}
+		else if (prevJoins)
+		{
+			form = f->final;
+		}
+
+		if (form != 0)
+		{
+			str[i] = form;
+		}
+
+		prevJoins = (jt[i] == JoiningType::D);
+	}
+}
+
+/// <summary>
+/// Remove all REMOVED markers from string
+/// </summary>
+/// <param name="str"></param>
+/// <param name="len"></param>
+/// <returns>new length of the string</returns>
+size_t BuiltinBidi::RemoveMarked(char32_t* str, size_t len) noexcept
+{
+	size_t count = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		if (str[i] != REMOVED)
+		{
+			str[count++] = str[i];
+		}
+	}
+	return count;
+}
+
+/// <summary>
+/// Convert UTF-32 string from logical to visual order (in-place)
+/// Each paragraph is processed separately, paragraph separators
+/// stay at their position
+/// </summary>
+/// <param name="str"></param>
+/// <param name="len"></param>
+/// <param name="dir"></param>
+/// <returns>new length of the string</returns>
+size_t BuiltinBidi::ConvertOneLine(char32_t* str, size_t len, Direction dir)
+{
+	size_t outLen = 0;
+	size_t start = 0;
+
+	for (size_t i = 0; i <= len; i++)
+	{
+		if ((i < len) && (GetBidiClass(str[i]) != BidiClass::B))
+		{
+			continue;
+		}
+
+		size_t count = ConvertParagraph(str + start, i - start, dir);
+		if (outLen != start)
+		{
+			std::copy(str + start, str + start + count, str + outLen);
+		}
+		outLen += count;
+
+		if (i < len)
+		{
+			str[outLen++] = str[i];
+		}
+		start = i + 1;
+	}
+
+	return outLen;
+}
+
+/// <summary>
+/// Convert UTF-8 string from logical to visual order
+/// Output string is cleared first, its capacity is reused
+/// </summary>
+/// <param name="str"></param>
+/// <param name="out"></param>
+/// <param name="dir"></param>
+void BuiltinBidi::ConvertOneLine(const std::u8string_view& str, std::u8string& out, Direction dir)
+{
+	//number of code points is always <= number of bytes
+	SmallBuffer<char32_t, SMALL_STRING_LENGTH> buf(str.size());
+
+	//string view does not have to be null terminated - 
+	//sequences are validated against end, invalid or truncated
+	//sequence is replaced by U+FFFD and skipped byte by byte
+	size_t len = 0;
+	const char8_t* it = str.data();
+	const char8_t* itEnd = str.data() + str.size();
+	while (it < itEnd)
+	{
+		utf8::utfchar32_t cp = 0;
+		if (utf8::internal::validate_next(it, itEnd, cp) != utf8::internal::UTF8_OK)
+		{
+			cp = 0xFFFD;
+			it++;
+		}
+		buf[len++] = static_cast<char32_t>(cp);
+	}
+
+	len = ConvertOneLine(buf.data(), len, dir);
+
+	size_t bytes = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		char32_t c = buf[i];
+		bytes += (c < 0x80) ? 1 : (c < 0x800) ? 2 : (c < 0x10000) ? 3 : 4;
+	}
+
+	out.resize(bytes);
+
+	char8_t* outIt = out.data();
+	for (size_t i = 0; i < len; i++)
+	{
+		outIt = utf8::unchecked::append(buf[i], outIt);
+	}
+}
+
+std::u8string BuiltinBidi::ConvertOneLine(const std::u8string& str, Direction dir)
+{
+	std::u8string res;
+	BuiltinBidi::ConvertOneLine(std::u8string_view(str), res, dir);
+	return res;
+}
+
+/// <summary>
+/// Run bidi algorithm for single paragraph
+/// </summary>
+/// <param name="str"></param>
+/// <param name="len"></param>
+/// <param name="dir"></param>
+/// <returns>new length of the paragraph</returns>
+size_t BuiltinBidi::ConvertParagraph(char32_t* str, size_t len, Direction dir)
+{
+	if (len == 0)
+	{
+		return 0;
+	}
+
+	SmallBuffer<BidiClass, SMALL_STRING_LENGTH> origTypes(len);
+	SmallBuffer<BidiClass, SMALL_STRING_LENGTH> types(len);
+
+	bool needsReorder = (dir == Direction::RTL);
+	bool hasControls = false;
+	for (size_t i = 0; i < len; i++)
+	{
+		BidiClass t = GetBidiClass(str[i]);
+		origTypes[i] = t;
+		types[i] = t;
+
+		needsReorder |= (t == BidiClass::R) || (t == BidiClass::AL) || (t == BidiClass::AN) ||
+			(t == BidiClass::RLE) || (t == BidiClass::RLO) || (t == BidiClass::RLI) || (t == BidiClass::FSI);
+		hasControls |= IsBidiControl(str[i], t);
+	}
+
+	if (needsReorder == false)
+	{
+		//only LTR text in LTR paragraph - visual order is the same as logical
+		if (hasControls == false)
+		{
+			return len;
+		}
+
+		for (size_t i = 0; i < len; i++)
+		{
+			if (IsBidiControl(str[i], origTypes[i]))
+			{
+				str[i] = REMOVED;
+			}
+		}
+		return RemoveMarked(str, len);
+	}
+
+	//BD9 - matching isolate initiators and PDIs
+	//for initiator - index of PDI, for PDI - index of initiator, otherwise -1
+	SmallBuffer<int32_t, SMALL_STRING_LENGTH> matching(len);
+	SmallBuffer<int32_t, SMALL_STRING_LENGTH> tmp(len);
+	size_t sp = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		matching[i] = -1;
+		if (IsIsolateInitiator(types[i]))
+		{
+			tmp[sp++] = static_cast<int32_t>(i);
+		}
+		else if ((types[i] == BidiClass::PDI) && (sp > 0))
+		{
+			int32_t o = tmp[--sp];
+			matching[o] = static_cast<int32_t>(i);
+			matching[i] = o;
+		}
+	}
+
+	//P2, P3
+	uint8_t paraLevel = (dir == Direction::RTL) ? 1 : 0;
+	if (dir == Direction::AUTO)
+	{
+		paraLevel = (FindFirstStrong(types.data(), matching.data(), 0, len) == 1) ? 1 : 0;
+	}
+
+	//X1 - X8 - explicit levels and directions
+	struct DirectionalStatus
+	{
+		uint8_t level;
+		BidiClass override; //ON - neutral
+		bool isolate;
+	};
+
+	SmallBuffer<uint8_t, SMALL_STRING_LENGTH> levels(len);
+
+	DirectionalStatus stack[MAX_DEPTH + 2];
+	size_t depth = 0;
+	stack[0] = { paraLevel, BidiClass::ON, false };
+
+	int overflowIsolate = 0;
+	int overflowEmbedding = 0;
+	int validIsolate = 0;
+
+	for (size_t i = 0; i < len; i++)
+	{
+		BidiClass t = types[i];
+		uint8_t curLevel = stack[depth].level;
+		BidiClass curOverride = stack[depth].override;
+
+		levels[i] = curLevel;
+
+		switch (t)
+		{
+		case BidiClass::RLE:
+		case BidiClass::LRE:
+		case BidiClass::RLO:
+		case BidiClass::LRO:
+		{
+			bool rtl = (t == BidiClass::RLE) || (t == BidiClass::RLO);
+			uint8_t newLevel = (rtl) ? ((curLevel + 1) | 1) : ((curLevel + 2) & ~1);
+
+			if ((newLevel <= MAX_DEPTH) && (overflowIsolate == 0) && (overflowEmbedding == 0))
+			{
+				BidiClass o = BidiClass::ON;
+				if (t == BidiClass::RLO) o = BidiClass::R;
+				else if (t == BidiClass::LRO) o = BidiClass::L;
+
+				stack[++depth] = { newLevel, o, false };
+			}
+			else if (overflowIsolate == 0)
+			{
+				overflowEmbedding++;
+			}
+			break;
+		}
+		case BidiClass::RLI:
+		case BidiClass::LRI:
+		case BidiClass::FSI:
+		{
+			if (curOverride != BidiClass::ON)
+			{
+				types[i] = curOverride;
+			}
+
+			bool rtl = (t == BidiClass::RLI);
+			if (t == BidiClass::FSI)
+			{
+				size_t end = (matching[i] >= 0) ? static_cast<size_t>(matching[i]) : len;
+				rtl = (FindFirstStrong(types.data(), matching.data(), i + 1, end) == 1);
+			}
+
+			uint8_t newLevel = (rtl) ? ((curLevel + 1) | 1) : ((curLevel + 2) & ~1);
+
+			if ((newLevel <= MAX_DEPTH) && (overflowIsolate == 0) && (overflowEmbedding == 0))
+			{
+				validIsolate++;
+				stack[++depth] = { newLevel, BidiClass::ON, true };
+			}
+			else
+			{
+				overflowIsolate++;
+			}
+			break;
+		}
+		case BidiClass::PDI:
+		{
+			if (overflowIsolate > 0)
+			{
+				overflowIsolate--;
+			}
+			else if (validIsolate > 0)
+			{
+				overflowEmbedding = 0;
+				while (stack[depth].isolate == false)
+				{
+					depth--;
+				}
+				depth--;
+				validIsolate--;
+			}
+
+			levels[i] = stack[depth].level;
+			if (stack[depth].override != BidiClass::ON)
+			{
+				types[i] = stack[depth].override;
+			}
+			break;
+		}
+		case BidiClass::PDF:
+		{
+			if (overflowIsolate > 0)
+			{
+				//nothing
+			}
+			else if (overflowEmbedding > 0)
+			{
+				overflowEmbedding--;
+			}
+			else if ((stack[depth].isolate == false) && (depth > 0))
+			{
+				depth--;
+			}
+			break;
+		}
+		case BidiClass::BN:
+			break;
+		default:
+			if (curOverride != BidiClass::ON)
+			{
+				types[i] = curOverride;
+			}
+			break;
+		}
+	}
+
+	//X9 - remove embeddings, overrides and BN (they are kept in the string, but ignored)
+	//X10 - level runs
+	SmallBuffer<int32_t, SMALL_STRING_LENGTH> kept(len);
+	size_t keptCount = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		if (IsRemovedByX9(origTypes[i]))
+		{
+			types[i] = BidiClass::BN;
+		}
+		else
+		{
+			kept[keptCount++] = static_cast<int32_t>(i);
+		}
+	}
+
+	struct LevelRun
+	{
+		int32_t first; //index to kept
+		int32_t last;
+	};
+
+	SmallBuffer<LevelRun, SMALL_STRING_LENGTH> runs(keptCount);
+	SmallBuffer<int32_t, SMALL_STRING_LENGTH> runOfChar(len);
+	size_t runsCount = 0;
+
+	for (size_t k = 0; k < keptCount; k++)
+	{
+		int32_t i = kept[k];
+		if ((k == 0) || (levels[i] != levels[kept[k - 1]]))
+		{
+			runs[runsCount++] = { static_cast<int32_t>(k), static_cast<int32_t>(k) };
+		}
+		else
+		{
+			runs[runsCount - 1].last = static_cast<int32_t>(k);
+		}
+		runOfChar[i] = static_cast<int32_t>(runsCount - 1);
+	}
+
+	//isolate initiator with matching PDI that ends level run
+	//continues isolating run sequence with the run starting with that PDI
+	auto continuesSequence = [&](int32_t i) -> bool {
+		return IsIsolateInitiator(origTypes[i]) && (matching[i] >= 0) &&
+			(kept[runs[runOfChar[i]].last] == i);
+	};
+
+	//BD13 - isolating run sequences
+	int32_t* seq = tmp.data();
+
+	for (size_t r = 0; r < runsCount; r++)
+	{
+		int32_t firstChar = kept[runs[r].first];
+		if ((origTypes[firstChar] == BidiClass::PDI) && (matching[firstChar] >= 0) &&
+			continuesSequence(matching[firstChar]))
+		{
+			//already part of sequence started with its isolate initiator
+			continue;
+		}
+
+		size_t seqLen = 0;
+		size_t cr = r;
+		while (true)
+		{
+			for (int32_t k = runs[cr].first; k <= runs[cr].last; k++)
+			{
+				seq[seqLen++] = kept[k];
+			}
+
+			int32_t lastChar = kept[runs[cr].last];
+			if (continuesSequence(lastChar) == false)
+			{
+				break;
+			}
+			cr = static_cast<size_t>(runOfChar[matching[lastChar]]);
+		}
+
+		uint8_t level = levels[seq[0]];
+
+		int32_t firstK = runs[r].first;
+		uint8_t prevLevel = (firstK > 0) ? levels[kept[firstK - 1]] : paraLevel;
+
+		int32_t lastK = runs[cr].last;
+		uint8_t nextLevel = paraLevel;
+		if ((IsIsolateInitiator(origTypes[seq[seqLen - 1]]) == false) &&
+			(static_cast<size_t>(lastK + 1) < keptCount))
+		{
+			nextLevel = levels[kept[lastK + 1]];
+		}
+
+		BidiClass sos = (std::max(prevLevel, level) & 1) ? BidiClass::R : BidiClass::L;
+		BidiClass eos = (std::max(nextLevel, level) & 1) ? BidiClass::R : BidiClass::L;
+
+		ResolveSequence(str, types.data(), origTypes.data(), seq, seqLen, level, sos, eos);
+	}
+
+	//I1, I2 - done after all sequences are resolved,
+	//sos and eos are computed from embedding levels
+	for (size_t k = 0; k < keptCount; k++)
+	{
+		int32_t i = kept[k];
+		BidiClass t = types[i];
+		if ((levels[i] & 1) == 0)
+		{
+			if (t == BidiClass::R)
+			{
+				levels[i] += 1;
+			}
+			else if ((t == BidiClass::AN) || (t == BidiClass::EN))
+			{
+				levels[i] += 2;
+			}
+		}
+		else if ((t == BidiClass::L) || (t == BidiClass::EN) || (t == BidiClass::AN))
+		{
+			levels[i] += 1;
+		}
+	}
+
+	//removed characters get level of the previous one
+	for (size_t i = 0; i < len; i++)
+	{
+		if (types[i] == BidiClass::BN)
+		{
+			levels[i] = (i > 0) ? levels[i - 1] : paraLevel;
+		}
+	}
+
+	//L1 - reset separators and trailing whitespace to paragraph level
+	bool trailing = true;
+	for (size_t i = len; i-- > 0;)
+	{
+		BidiClass t = origTypes[i];
+		if ((t == BidiClass::S) || (t == BidiClass::B))
+		{
+			levels[i] = paraLevel;
+			trailing = true;
+		}
+		else if ((t == BidiClass::WS) || IsIsolateInitiator(t) || (t == BidiClass::PDI) || IsRemovedByX9(t))
+		{
+			if (trailing)
+			{
+				levels[i] = paraLevel;
+			}
+		}
+		else
+		{
+			trailing = false;
+		}
+	}
+
+	//shaping is done in logical order
+	ShapeArabicMarked(str, len);
+
+	//L4 - mirroring + remove bidi controls
+	uint8_t maxLevel = 0;
+	uint8_t minOddLevel = MAX_DEPTH + 2;
+	for (size_t i = 0; i < len; i++)
+	{
+		if (IsBidiControl(str[i], origTypes[i]))
+		{
+			str[i] = REMOVED;
+		}
+		else if (levels[i] & 1)
+		{
+			str[i] = GetMirror(str[i]);
+		}
+
+		maxLevel = std::max(maxLevel, levels[i]);
+		if (levels[i] & 1)
+		{
+			minOddLevel = std::min(minOddLevel, levels[i]);
+		}
+	}
+
+	//L2 - reverse every sequence on the level and higher
+	//from the highest level to the lowest odd level
+	for (int lvl = maxLevel; lvl >= minOddLevel; lvl--)
+	{
+		size_t i = 0;
+		while (i < len)
+		{
+			if (levels[i] < lvl)
+			{
+				i++;
+				continue;
+			}
+
+			size_t end = i;
+			while ((end < len) && (levels[end] >= lvl))
+			{
+				end++;
+			}
+
+			std::reverse(str + i, str + end);
+			std::reverse(levels.data() + i, levels.data() + end);
+			i = end;
+		}
+	}
+
+	return RemoveMarked(str, len);
+}
+
+/// <summary>
+/// Resolve weak types and neutrals
+/// for single isolating run sequence (W1 - W7, N0 - N2)
+/// </summary>
+void BuiltinBidi::ResolveSequence(const char32_t* str, BidiClass* types, const BidiClass* origTypes,
+	const int32_t* seq, size_t seqLen,
+	uint8_t level, BidiClass sos, BidiClass eos)
+{
+	//W1
+	BidiClass prev = sos;
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		BidiClass& t = types[seq[j]];
+		if (t == BidiClass::NSM)
+		{
+			t = (IsIsolateInitiator(prev) || (prev == BidiClass::PDI)) ? BidiClass::ON : prev;
+		}
+		prev = t;
+	}
+
+	//W2, W3
+	BidiClass lastStrong = sos;
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		BidiClass& t = types[seq[j]];
+		if ((t == BidiClass::L) || (t == BidiClass::R) || (t == BidiClass::AL))
+		{
+			lastStrong = t;
+		}
+		else if ((t == BidiClass::EN) && (lastStrong == BidiClass::AL))
+		{
+			t = BidiClass::AN;
+		}
+	}
+
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		if (types[seq[j]] == BidiClass::AL)
+		{
+			types[seq[j]] = BidiClass::R;
+		}
+	}
+
+	//W4
+	for (size_t j = 1; j + 1 < seqLen; j++)
+	{
+		BidiClass& t = types[seq[j]];
+		if ((t != BidiClass::ES) && (t != BidiClass::CS))
+		{
+			continue;
+		}
+
+		BidiClass p = types[seq[j - 1]];
+		BidiClass n = types[seq[j + 1]];
+		if ((p == BidiClass::EN) && (n == BidiClass::EN))
+		{
+			t = BidiClass::EN;
+		}
+		else if ((t == BidiClass::CS) && (p == BidiClass::AN) && (n == BidiClass::AN))
+		{
+			t = BidiClass::AN;
+		}
+	}
+
+	//W5
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		if (types[seq[j]] != BidiClass::ET)
+		{
+			continue;
+		}
+
+		size_t end = j;
+		while ((end < seqLen) && (types[seq[end]] == BidiClass::ET))
+		{
+			end++;
+		}
+
+		bool nearEN = ((j > 0) && (types[seq[j - 1]] == BidiClass::EN)) ||
+			((end < seqLen) && (types[seq[end]] == BidiClass::EN));
+
+		if (nearEN)
+		{
+			for (size_t k = j; k < end; k++)
+			{
+				types[seq[k]] = BidiClass::EN;
+			}
+		}
+		j = end - 1;
+	}
+
+	//W6
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		BidiClass& t = types[seq[j]];
+		if ((t == BidiClass::ES) || (t == BidiClass::ET) || (t == BidiClass::CS))
+		{
+			t = BidiClass::ON;
+		}
+	}
+
+	//W7
+	lastStrong = sos;
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		BidiClass& t = types[seq[j]];
+		if ((t == BidiClass::L) || (t == BidiClass::R))
+		{
+			lastStrong = t;
+		}
+		else if ((t == BidiClass::EN) && (lastStrong == BidiClass::L))
+		{
+			t = BidiClass::L;
+		}
+	}
+
+	BidiClass e = (level & 1) ? BidiClass::R : BidiClass::L;
+
+	//N0
+	ResolveBrackets(str, types, origTypes, seq, seqLen, e, sos);
+
+	//N1, N2
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		if (IsNeutralOrIsolate(types[seq[j]]) == false)
+		{
+			continue;
+		}
+
+		size_t end = j;
+		while ((end < seqLen) && IsNeutralOrIsolate(types[seq[end]]))
+		{
+			end++;
+		}
+
+		BidiClass before = (j == 0) ? sos : AsStrong(types[seq[j - 1]]);
+		BidiClass after = (end == seqLen) ? eos : AsStrong(types[seq[end]]);
+		BidiClass res = (before == after) ? before : e;
+
+		for (size_t k = j; k < end; k++)
+		{
+			types[seq[k]] = res;
+		}
+		j = end - 1;
+	}
+}
+
+/// <summary>
+/// Resolve paired brackets (BD16, N0)
+/// </summary>
+void BuiltinBidi::ResolveBrackets(const char32_t* str, BidiClass* types, const BidiClass* origTypes,
+	const int32_t* seq, size_t seqLen, BidiClass e, BidiClass sos)
+{
+	struct BracketPair
+	{
+		size_t open; //index to seq
+		size_t close;
+	};
+
+	struct StackItem
+	{
+		char32_t bracket;
+		size_t pos;
+	};
+
+	//BD16
+	SmallBuffer<BracketPair, SMALL_STRING_LENGTH / 2> pairs(seqLen / 2 + 1);
+	size_t pairsCount = 0;
+
+	StackItem stack[MAX_BRACKET_PAIRS];
+	size_t sp = 0;
+
+	for (size_t j = 0; j < seqLen; j++)
+	{
+		if (types[seq[j]] != BidiClass::ON)
+		{
+			continue;
+		}
+
+		bool isOpening = false;
+		char32_t opening = GetOpeningBracket(str[seq[j]], isOpening);
+		if (opening == 0)
+		{
+			continue;
+		}
+
+		if (isOpening)
+		{
+			if (sp == MAX_BRACKET_PAIRS)
+			{
+				break;
+			}
+			stack[sp++] = { opening, j };
+			continue;
+		}
+
+		for (size_t s = sp; s > 0; s--)
+		{
+			if (stack[s - 1].bracket == opening)
+			{
+				pairs[pairsCount++] = { stack[s - 1].pos, j };
+				sp = s - 1;
+				break;
+			}
+		}
+	}
+
+	if (pairsCount == 0)
+	{
+		return;
+	}
+
+	std::sort(pairs.data(), pairs.data() + pairsCount, [](const BracketPair& a, const BracketPair& b) {
+		return a.open < b.open;
+	});
+
+	for (size_t p = 0; p < pairsCount; p++)
+	{
+		const BracketPair& bp = pairs[p];
+
+		bool foundEmbedding = false;
+		bool foundOpposite = false;
+		for (size_t k = bp.open + 1; k < bp.close; k++)
+		{
+			BidiClass s = AsStrong(types[seq[k]]);
+			if (s == e)
+			{
+				foundEmbedding = true;
+				break;
+			}
+			if (s != BidiClass::ON)
+			{
+				foundOpposite = true;
+			}
+		}
+
+		BidiClass res = BidiClass::ON;
+		if (foundEmbedding)
+		{
+			res = e;
+		}
+		else if (foundOpposite)
+		{
+			//check context before opening bracket
+			BidiClass ctx = sos;
+			for (size_t k = bp.open; k > 0; k--)
+			{
+				BidiClass s = AsStrong(types[seq[k - 1]]);
+				if (s != BidiClass::ON)
+				{
+					ctx = s;
+					break;
+				}
+			}
+			res = ctx;
+		}
+
+		if (res == BidiClass::ON)
+		{
+			continue;
+		}
+
+		for (size_t b : { bp.open, bp.close })
+		{
+			types[seq[b]] = res;
+
+			//NSM following bracket gets its type
+			for (size_t k = b + 1; (k < seqLen) && (origTypes[seq[k]] == BidiClass::NSM); k++)
+			{
+				types[seq[k]] = res;
+			}
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#ifndef BUILTIN_BIDI_H
+#define BUILTIN_BIDI_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// ICU-free implementation of Unicode Bidirectional Algorithm (UAX #9)
+/// for a single line + Arabic shaping (presentation forms, lam-alef ligatures)
+///
+/// Works directly on UTF-32 (in-place) or UTF-8 data.
+/// Tables are generated from Unicode 14.0.0 data and embedded in the cpp file.
+/// Strings up to SMALL_STRING_LENGTH code points are processed
+/// without any heap allocation.
+///
+/// Explicit bidi controls (LRE, RLE, LRO, RLO, PDF, LRI, RLI, FSI, PDI, LRM, RLM, ALM)
+/// are resolved and removed from the output, since they have no glyphs.
+///
+/// https://www.unicode.org/reports/tr9/
+/// </summary>
+class BuiltinBidi
+{
+public:
+
+	static const size_t SMALL_STRING_LENGTH = 128;
+
+	enum class BidiClass : uint8_t
+	{
+		L, R, AL, EN, ES, ET, AN, CS, NSM, BN, B, S, WS, ON,
+		LRE, LRO, RLE, RLO, PDF, LRI, RLI, FSI, PDI
+	};
+
+	/// <summary>
+	/// Paragraph base direction
+	/// AUTO - first strong character (rules P2, P3), LTR if there is none
+	/// </summary>
+	enum class Direction
+	{
+		LTR,
+		RTL,
+		AUTO
+	};
+
+	static BidiClass GetBidiClass(char32_t c) noexcept;
+	static char32_t GetMirror(char32_t c) noexcept;
+
+	static size_t ShapeArabic(char32_t* str, size_t len);
+
+	static size_t ConvertOneLine(char32_t* str, size_t len, Direction dir = Direction::LTR);
+	static void ConvertOneLine(const std::u8string_view& str, std::u8string& out, Direction dir = Direction::LTR);
+	static std::u8string ConvertOneLine(const std::u8string& str, Direction dir = Direction::LTR);
+
+protected:
+
+	static const uint8_t MAX_DEPTH = 125;
+	static const size_t MAX_BRACKET_PAIRS = 63;
+
+	/// <summary>
+	/// Marker for code points removed from the output
+	/// (bidi controls, alef merged to lam-alef ligature)
+	/// </summary>
+	static const char32_t REMOVED = 0xFFFFFFFF;
+
+	static bool IsBidiControl(char32_t c, BidiClass cls) noexcept;
+	static bool IsRemovedByX9(BidiClass cls) noexcept;
+	static bool IsIsolateInitiator(BidiClass cls) noexcept;
+	static bool IsNeutralOrIsolate(BidiClass cls) noexcept;
+	static BidiClass AsStrong(BidiClass cls) noexcept;
+
+	static int FindFirstStrong(const BidiClass* types, const int32_t* matching,
+		size_t from, size_t to) noexcept;
+
+	static void ShapeArabicMarked(char32_t* str, size_t len);
+	static size_t RemoveMarked(char32_t* str, size_t len) noexcept;
+
+	static size_t ConvertParagraph(char32_t* str, size_t len, Direction dir);
+
+	static void ResolveSequence(const char32_t* str, BidiClass* types, const BidiClass* origTypes,
+		const int32_t* seq, size_t seqLen,
+		uint8_t level, BidiClass sos, BidiClass eos);
+
+	static void ResolveBrackets(const char32_t* str, BidiClass* types, const BidiClass* origTypes,
+		const int32_t* seq, size_t seqLen, BidiClass e, BidiClass sos);
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef AABB_GRID_H
+#define AABB_GRID_H
+
+#include <vector>
+#include <algorithm>
+
+#include "../Externalncludes.h"
+#include "../FontStructures.h"
+
+/// <summary>
+/// Uniform grid for fast AABB overlap queries
+/// Grid covers area [0, 0] - [w, h], AABBs outside this area
+/// are stored in the border cells, so queries are still correct.
+/// Each item is stored (as its id) in all cells it touches
+/// </summary>
+class AabbGrid
+{
+public:
+	AabbGrid() noexcept :
+		w(0),
+		h(0),
+		cellW(1),
+		cellH(1),
+		cols(0),
+		rows(0)
+	{}
+
+	void Init(float w, float h, float cellW, float cellH)
+	{
+		this->w = w;
+		this->h = h;
+		this->cellW = std::max(cellW, 1.0f);
+		this->cellH = std::max(cellH, 1.0f);
+		this->cols = std::max(1, static_cast<int>(w / this->cellW) + 1);
+		this->rows = std::max(1, static_cast<int>(h / this->cellH) + 1);
+
+		this->cells.clear();
+		this->cells.resize(static_cast<size_t>(this->cols) * this->rows);
+	}
+
+	bool IsInited(float w, float h, float cellW, float cellH) const noexcept
+	{
+		return (this->cols > 0) &&
+			(this->w == w) && (this->h == h) &&
+			(this->cellW == std::max(cellW, 1.0f)) && (this->cellH == std::max(cellH, 1.0f));
+	}
+
+	void Clear()
+	{
+		for (auto& c : this->cells)
+		{
+			c.clear();
+		}
+	}
+
+	void Add(const AABB& aabb, uint32_t id)
+	{
+		int x0, y0, x1, y1;
+		this->GetCellRange(aabb.minX, aabb.minY, aabb.maxX, aabb.maxY, x0, y0, x1, y1);
+
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				this->cells[static_cast<size_t>(y) * this->cols + x].push_back(id);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Call f(id) for items from all cells touching area
+	/// Item can be visited multiple times, if it is stored in more cells
+	/// Stops and returns true, if f returns true
+	/// </summary>
+	template <typename Func>
+	bool AnyOf(float minX, float minY, float maxX, float maxY, Func f) const
+	{
+		if (this->cols == 0)
+		{
+			return false;
+		}
+
+		int x0, y0, x1, y1;
+		this->GetCellRange(minX, minY, maxX, maxY, x0, y0, x1, y1);
+
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				for (uint32_t id : this->cells[static_cast<size_t>(y) * this->cols + x])
+				{
+					if (f(id))
+					{
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+protected:
+	float w;
+	float h;
+	float cellW;
+	float cellH;
+	int cols;
+	int rows;
+
+	std::vector<std::vector<uint32_t>> cells;
+
+	void GetCellRange(float minX, float minY, float maxX, float maxY,
+		int& x0, int& y0, int& x1, int& y1) const noexcept
+	{
+		x0 = this->GetCell(minX, this->cellW, this->cols);
+		x1 = this->GetCell(maxX, this->cellW, this->cols);
+		y0 = this->GetCell(minY, this->cellH, this->rows);
+		y1 = this->GetCell(maxY, this->cellH, this->rows);
+	}
+
+	int GetCell(float v, float cellSize, int count) const noexcept
+	{
+		//clamp in float first, so huge values do not overflow int
+		float c = std::clamp(v / cellSize, 0.0f, static_cast<float>(count - 1));
+		return static_cast<int>(c);
+	}
+};
+
+#endif
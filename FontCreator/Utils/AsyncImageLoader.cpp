@@ -0,0 +1,195 @@
+#include "./AsyncImageLoader.h"
+
+#include <algorithm>
+
+#include "../Externalncludes.h"
+
+AsyncImageLoader::AsyncImageLoader(int workersCount) :
+	workersCount(std::max(1, workersCount)),
+	running(true),
+	pending(0)
+{
+}
+
+AsyncImageLoader::~AsyncImageLoader()
+{
+	{
+		std::lock_guard<std::mutex> lk(m);
+		this->running = false;
+		this->queue.clear();
+	}
+	this->cv.notify_all();
+
+	for (auto& t : this->workers)
+	{
+		t.join();
+	}
+}
+
+/// <summary>
+/// Request image to be loaded
+/// Every name is loaded only once
+/// </summary>
+/// <param name="name"></param>
+/// <returns>true if image was not requested before</returns>
+bool AsyncImageLoader::Request(const std::string& name)
+{
+	{
+		std::lock_guard<std::mutex> lk(m);
+		if (this->requested.insert(name).second == false)
+		{
+			return false;
+		}
+
+		this->queue.push_back(name);
+		this->pending++;
+
+		if (this->workers.empty())
+		{
+			this->StartWorkers();
+		}
+	}
+
+	this->cv.notify_one();
+	return true;
+}
+
+/// <summary>
+/// Test if some requested images are not yet taken
+/// </summary>
+/// <returns></returns>
+bool AsyncImageLoader::IsLoading() const
+{
+	std::lock_guard<std::mutex> lk(m);
+	return (this->pending > 0);
+}
+
+/// <summary>
+/// Take all images that were loaded since last call
+/// </summary>
+/// <returns></returns>
+std::vector<AsyncImageLoader::Image> AsyncImageLoader::TakeLoaded()
+{
+	std::lock_guard<std::mutex> lk(m);
+
+	std::vector<Image> tmp;
+	tmp.swap(this->loaded);
+
+	this->pending -= static_cast<int>(tmp.size());
+
+	return tmp;
+}
+
+void AsyncImageLoader::StartWorkers()
+{
+	for (int i = 0; i < this->workersCount; i++)
+	{
+		this->workers.emplace_back(&AsyncImageLoader::Worker, this);
+	}
+}
+
+void AsyncImageLoader::Worker()
+{
+	while (true)
+	{
+		std::string name;
+
+		{
+			std::unique_lock<std::mutex> lk(m);
+			this->cv.wait(lk, [this] { return (this->running == false) || (this->queue.empty() == false); });
+
+			if (this->running == false)
+			{
+				return;
+			}
+
+			name = std::move(this->queue.front());
+			this->queue.pop_front();
+		}
+
+		Image img = Load(name);
+
+		std::lock_guard<std::mutex> lk(m);
+		this->loaded.push_back(std::move(img));
+	}
+}
+
+/// <summary>
+/// Load and decode image from file
+/// </summary>
+/// <param name="name"></param>
+/// <returns></returns>
+AsyncImageLoader::Image AsyncImageLoader::Load(const std::string& name)
+{
+	Image img;
+	img.name = name;
+	img.w = 0;
+	img.h = 0;
+
+	std::vector<uint8_t> buffer;
+	unsigned width, height;
+	lodepng::State state; //optionally customize this one
+	//state.decoder.color_convert = 0; //keep input data channels count
+
+	size_t fileDataSize = 0;
+	uint8_t* fileData = LoadDataFontFromFile(name, &fileDataSize);
+
+	auto error = lodepng::decode(buffer, width, height, state, fileData, fileDataSize);
+
+	SAFE_DELETE_ARRAY(fileData);
+
+	if ((error != 0) || (width == 0) || (height == 0))
+	{
+		return img;
+	}
+
+	int channelsCount = 4;
+	if (width * height * 3 == buffer.size()) channelsCount = 3;
+	else if (width * height == buffer.size()) channelsCount = 1;
+
+	img.data = ConvertToRgba(buffer, width, height, channelsCount);
+	img.w = static_cast<int>(width);
+	img.h = static_cast<int>(height);
+
+	return img;
+}
+
+/// <summary>
+/// Convert image with 1, 3 or 4 channels to RGBA
+/// Single channel is used as gray
+/// </summary>
+/// <param name="data"></param>
+/// <param name="w"></param>
+/// <param name="h"></param>
+/// <param name="channelsCount"></param>
+/// <returns></returns>
+std::vector<uint8_t> AsyncImageLoader::ConvertToRgba(const std::vector<uint8_t>& data,
+	int w, int h, int channelsCount)
+{
+	if (channelsCount == 4)
+	{
+		return data;
+	}
+
+	const size_t count = static_cast<size_t>(w) * h;
+
+	std::vector<uint8_t> rgba(count * 4);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (channelsCount == 3)
+		{
+			rgba[4 * i + 0] = data[3 * i + 0];
+			rgba[4 * i + 1] = data[3 * i + 1];
+			rgba[4 * i + 2] = data[3 * i + 2];
+		}
+		else
+		{
+			rgba[4 * i + 0] = data[i];
+			rgba[4 * i + 1] = data[i];
+			rgba[4 * i + 2] = data[i];
+		}
+		rgba[4 * i + 3] = 255;
+	}
+
+	return rgba;
+}
@@ -0,0 +1,63 @@
+#ifndef ASYNC_IMAGE_LOADER_H
+#define ASYNC_IMAGE_LOADER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_set>
+
+/// <summary>
+/// Load and decode PNG images on worker threads
+/// Loader does not use OpenGL - decoded RGBA images are
+/// taken with TakeLoaded on render thread and uploaded there
+/// 
+/// Workers are started with first request
+/// </summary>
+class AsyncImageLoader
+{
+public:
+
+	/// <summary>
+	/// Decoded image - always RGBA
+	/// If loading failed, data are empty
+	/// </summary>
+	struct Image
+	{
+		std::string name;
+		std::vector<uint8_t> data;
+		int w;
+		int h;
+	};
+
+	AsyncImageLoader(int workersCount = 2);
+	~AsyncImageLoader();
+
+	bool Request(const std::string& name);
+	bool IsLoading() const;
+
+	std::vector<Image> TakeLoaded();
+
+	static Image Load(const std::string& name);
+	static std::vector<uint8_t> ConvertToRgba(const std::vector<uint8_t>& data, int w, int h, int channelsCount);
+
+protected:
+	int workersCount;
+	std::vector<std::thread> workers;
+
+	mutable std::mutex m;
+	std::condition_variable cv;
+	bool running;
+
+	std::unordered_set<std::string> requested;
+	std::deque<std::string> queue;
+	std::vector<Image> loaded;
+	int pending;
+
+	void StartWorkers();
+	void Worker();
+};
+
+#endif
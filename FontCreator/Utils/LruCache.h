@@ -0,0 +1,131 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <list>
+#include <utility>
+#include <optional>
+
+#include "../Externalncludes.h"
+
+#include "./ankerl/unordered_dense.h"
+
+#ifdef THREAD_SAFETY
+#	include <mutex>
+#endif
+
+/// <summary>
+/// Simple bounded LRU cache
+/// Most recently used item is at the front of the list,
+/// if capacity is reached, item from the back is removed
+/// </summary>
+template <typename K, typename V>
+class LruCache
+{
+public:
+	LruCache(size_t capacity) :
+		capacity(capacity)
+	{}
+
+	void SetCapacity(size_t capacity)
+	{
+#ifdef THREAD_SAFETY
+		std::lock_guard<std::mutex> lk(m);
+#endif
+		this->capacity = capacity;
+		this->Trim();
+	}
+
+	size_t GetCapacity() const
+	{
+#ifdef THREAD_SAFETY
+		std::lock_guard<std::mutex> lk(m);
+#endif
+		return this->capacity;
+	}
+
+	size_t GetSize() const
+	{
+#ifdef THREAD_SAFETY
+		std::lock_guard<std::mutex> lk(m);
+#endif
+		return this->items.size();
+	}
+
+	void Clear()
+	{
+#ifdef THREAD_SAFETY
+		std::lock_guard<std::mutex> lk(m);
+#endif
+		this->index.clear();
+		this->items.clear();
+	}
+
+	/// <summary>
+	/// Get cached value and mark it as most recently used
+	/// </summary>
+	/// <param name="key"></param>
+	/// <returns></returns>
+	std::optional<V> Get(const K& key)
+	{
+#ifdef THREAD_SAFETY
+		std::lock_guard<std::mutex> lk(m);
+#endif
+		auto it = this->index.find(key);
+		if (it == this->index.end())
+		{
+			return std::nullopt;
+		}
+
+		this->items.splice(this->items.begin(), this->items, it->second);
+		return it->second->second;
+	}
+
+	void Put(const K& key, const V& val)
+	{
+#ifdef THREAD_SAFETY
+		std::lock_guard<std::mutex> lk(m);
+#endif
+		if (this->capacity == 0)
+		{
+			return;
+		}
+
+		auto it = this->index.find(key);
+		if (it != this->index.end())
+		{
+			it->second->second = val;
+			this->items.splice(this->items.begin(), this->items, it->second);
+			return;
+		}
+
+		this->items.emplace_front(key, val);
+		this->index.emplace(key, this->items.begin());
+
+		this->Trim();
+	}
+
+protected:
+	using ItemList = std::list<std::pair<K, V>>;
+
+	size_t capacity;
+
+	ItemList items;
+	//HashMap alias is not available yet, if this is included
+	//via Externalncludes.h -> BidiHelper.h
+	ankerl::unordered_dense::map<K, typename ItemList::iterator> index;
+
+#ifdef THREAD_SAFETY
+	mutable std::mutex m;
+#endif
+
+	void Trim()
+	{
+		while (this->items.size() > this->capacity)
+		{
+			this->index.erase(this->items.back().first);
+			this->items.pop_back();
+		}
+	}
+};
+
+#endif
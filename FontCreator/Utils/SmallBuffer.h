@@ -0,0 +1,52 @@
+#ifndef SMALL_BUFFER_H
+#define SMALL_BUFFER_H
+
+#include <vector>
+#include <array>
+
+/// <summary>
+/// Fixed size buffer for temporary data
+/// If size is less or equal to N, local storage is used
+/// and there is no heap allocation. Otherwise, data are allocated
+/// Content is not initialized
+/// </summary>
+template <typename T, size_t N>
+class SmallBuffer
+{
+public:
+	SmallBuffer(size_t size) :
+		size(size),
+		ptr(nullptr)
+	{
+		if (size > N)
+		{
+			this->heap.resize(size);
+			this->ptr = this->heap.data();
+		}
+		else
+		{
+			this->ptr = this->local.data();
+		}
+	}
+
+	SmallBuffer(const SmallBuffer&) = delete;
+	SmallBuffer& operator=(const SmallBuffer&) = delete;
+
+	T* data() noexcept { return this->ptr; }
+	const T* data() const noexcept { return this->ptr; }
+
+	size_t GetSize() const noexcept { return this->size; }
+
+	bool IsLocal() const noexcept { return this->size <= N; }
+
+	T& operator[](size_t i) noexcept { return this->ptr[i]; }
+	const T& operator[](size_t i) const noexcept { return this->ptr[i]; }
+
+protected:
+	size_t size;
+	T* ptr;
+	std::array<T, N> local;
+	std::vector<T> heap;
+};
+
+#endif
@@ -398,7 +398,6 @@ void InitTestNumbers()
 	s.blurRadius = 12;	
 	s.dirX = 0.0f;
 	s.dirY = 0.05f;
-	s.shadowPaddingSize = 0.2f;// 0.2f;
 	s.color = Color(0, 0, 0, 0.65f);
 
 	BackgroundSettings bsn;